@@ -0,0 +1,665 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Asynchronous File Writer
+// ============================================================================
+
+/**
+ * @brief How buffers reach the disk
+ */
+enum class WriteBackend : uint8_t {
+    IoUring,     // Registered buffers submitted through io_uring
+    PwritePool,  // pwrite(2) on a couple of helper threads
+    Write        // pwrite(2) on the calling thread (baseline)
+};
+
+constexpr std::string_view write_backend_name(WriteBackend backend) {
+    switch (backend) {
+        case WriteBackend::IoUring:    return "uring";
+        case WriteBackend::PwritePool: return "pool";
+        case WriteBackend::Write:      return "write";
+    }
+    return "unknown";
+}
+
+constexpr bool parse_write_backend(std::string_view name, WriteBackend& out) {
+    for (auto backend : {WriteBackend::IoUring, WriteBackend::PwritePool, WriteBackend::Write}) {
+        if (name == write_backend_name(backend)) {
+            out = backend;
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr size_t WRITE_BUFFER_COUNT = 4;
+constexpr size_t WRITE_BUFFER_ALIGNMENT = 4096;  // O_DIRECT address/size granularity
+constexpr size_t PWRITE_POOL_THREADS = 2;
+
+/**
+ * @brief Create/truncate `path` for writing, with O_DIRECT where the
+ *        filesystem allows it (`direct_io` says which)
+ * @return The descriptor, or -1 with errno set
+ */
+inline int create_output_file(const std::string& path, bool& direct_io) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+    direct_io = fd >= 0;
+    if (fd < 0 && errno == EINVAL) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+    return fd;
+}
+
+// ============================================================================
+// Minimal io_uring (raw syscalls, no liburing)
+// ============================================================================
+
+namespace uring_detail {
+
+inline int setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+inline int enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+inline int register_op(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+template <typename T>
+T load_acquire(T* p) { return std::atomic_ref<T>(*p).load(std::memory_order_acquire); }
+
+template <typename T>
+void store_release(T* p, T value) { std::atomic_ref<T>(*p).store(value, std::memory_order_release); }
+
+} // namespace uring_detail
+
+/**
+ * @brief One submission/completion ring, used from a single thread
+ *
+ * Only what the writer needs: queue one SQE at a time, submit, and reap
+ * completions (optionally waiting for at least one).
+ */
+class IoUring {
+public:
+    IoUring() = default;
+
+    ~IoUring() {
+        if (sqes_) munmap(sqes_, sqes_bytes_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_bytes_);
+        if (sq_ring_) munmap(sq_ring_, sq_ring_bytes_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @return false (with errno set) if the kernel refuses io_uring
+     */
+    bool init(unsigned entries) {
+        io_uring_params params{};
+        fd_ = uring_detail::setup(entries, &params);
+        if (fd_ < 0) return false;
+
+        sq_ring_bytes_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_bytes_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_ring_bytes_ = cq_ring_bytes_ = std::max(sq_ring_bytes_, cq_ring_bytes_);
+        }
+
+        sq_ring_ = map(sq_ring_bytes_, IORING_OFF_SQ_RING);
+        if (!sq_ring_) return false;
+        cq_ring_ = single_mmap ? sq_ring_ : map(cq_ring_bytes_, IORING_OFF_CQ_RING);
+        if (!cq_ring_) return false;
+        sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_bytes_, IORING_OFF_SQES));
+        if (!sqes_) return false;
+
+        auto* sq = static_cast<char*>(sq_ring_);
+        auto* cq = static_cast<char*>(cq_ring_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    bool register_buffers(const iovec* buffers, unsigned count) {
+        return uring_detail::register_op(fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+    }
+
+    /**
+     * @brief Queue and submit one SQE filled in by `fill`
+     *
+     * An SQE the kernel didn't take is withdrawn again: left in the ring,
+     * the next enter would submit it long after its buffer was reused.
+     * @return false if the ring is full or the SQE wasn't submitted; true
+     *         means a completion will follow
+     */
+    template <typename Fill>
+    bool submit(Fill&& fill) {
+        const unsigned tail = *sq_tail_;
+        if (tail - uring_detail::load_acquire(sq_head_) >= sq_entries_) {
+            errno = EBUSY;
+            return false;
+        }
+        const unsigned index = tail & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        fill(*sqe);
+        sq_array_[index] = index;
+        uring_detail::store_release(sq_tail_, tail + 1);
+
+        int n;
+        do {
+            n = uring_detail::enter(fd_, 1, 0, 0);
+        } while (n < 0 && errno == EINTR);
+        // Without SQPOLL the kernel only reads the ring inside enter, and
+        // moves the head past every SQE it took
+        if (uring_detail::load_acquire(sq_head_) != tail) return true;
+
+        const int err = n < 0 ? errno : EAGAIN;
+        uring_detail::store_release(sq_tail_, tail);
+        errno = err;
+        return false;
+    }
+
+    /**
+     * @brief Hand every available completion to on_complete(user_data, res)
+     * @param wait Block until at least one completion is available
+     * @return Number reaped
+     */
+    template <typename OnComplete>
+    size_t reap(bool wait, OnComplete&& on_complete) {
+        unsigned head = *cq_head_;
+        unsigned tail = uring_detail::load_acquire(cq_tail_);
+        while (wait && head == tail) {
+            if (uring_detail::enter(fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                return 0;
+            }
+            tail = uring_detail::load_acquire(cq_tail_);
+        }
+
+        size_t count = 0;
+        for (; head != tail; ++head, ++count) {
+            const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+            on_complete(cqe.user_data, cqe.res);
+        }
+        uring_detail::store_release(cq_head_, head);
+        return count;
+    }
+
+private:
+    void* map(size_t bytes, off_t offset) {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int fd_ = -1;
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_ring_bytes_ = 0;
+    size_t cq_ring_bytes_ = 0;
+    size_t sqes_bytes_ = 0;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+/**
+ * @brief Writer counters, read after close()
+ */
+struct AsyncWriterStats {
+    WriteBackend backend = WriteBackend::Write;  // The one actually in use
+    bool direct_io = false;                      // Writes bypassed the page cache
+    bool registered_buffers = false;             // io_uring fixed-buffer writes
+    uint64_t writes = 0;                         // Buffers submitted
+    uint64_t bytes = 0;                          // Bytes the kernel confirmed
+    std::chrono::nanoseconds wait_total{0};      // Caller blocked waiting for a free buffer
+    std::chrono::nanoseconds wait_max{0};
+    int error = 0;                               // errno of the first failed write, 0 if none
+};
+
+/**
+ * @brief Writes whole buffers at explicit offsets without blocking the caller
+ *
+ * Owns WRITE_BUFFER_COUNT aligned buffers, each either free, being filled by
+ * the caller, or in flight. The caller acquire()s one, fills it and
+ * submit()s it with its file offset, then acquires the next; it only waits
+ * when every buffer is still in flight, i.e. when the disk really can't keep
+ * up.
+ *
+ * With io_uring the buffers are registered once, so each write is a
+ * WRITE_FIXED with no per-call page pinning; completions are reaped
+ * whenever the caller needs a buffer back. If the kernel refuses io_uring
+ * (old kernel, seccomp, io_uring_disabled) the same buffers are handed to a
+ * small pool of threads doing pwrite(). Write is plain synchronous pwrite on
+ * the caller's thread, kept as the baseline.
+ *
+ * Single caller thread. Writes complete in any order, so each must carry its
+ * own offset.
+ */
+class AsyncFileWriter {
+public:
+    AsyncFileWriter() = default;
+
+    ~AsyncFileWriter() {
+        close();
+    }
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * @brief Create/truncate `path` and set up the requested backend
+     *        (falling back from io_uring to the pwrite pool if needed)
+     */
+    bool open(const std::string& path, size_t buffer_bytes, WriteBackend backend, std::string& error) {
+        bool direct_io = false;
+        const int fd = create_output_file(path, direct_io);
+        if (fd < 0) {
+            error = "cannot create " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        return open(fd, direct_io, buffer_bytes, backend, error);
+    }
+
+    /**
+     * @brief Same, writing to a descriptor the caller already opened; the
+     *        writer owns it from here on, even if this fails
+     */
+    bool open(int fd, bool direct_io, size_t buffer_bytes, WriteBackend backend, std::string& error) {
+        fd_ = fd;
+        direct_io_.store(direct_io, std::memory_order_relaxed);
+        buffer_bytes_ = buffer_bytes;
+        for (auto& buffer : buffers_) {
+            void* p = std::aligned_alloc(WRITE_BUFFER_ALIGNMENT, buffer_bytes);
+            if (!p) {
+                error = "out of memory for write buffers";
+                ::close(fd_);
+                fd_ = -1;
+                return false;
+            }
+            buffer.data.reset(static_cast<unsigned char*>(p));
+            buffer.state = BufferState::Free;
+        }
+
+        if (backend == WriteBackend::IoUring && !init_uring()) {
+            backend = WriteBackend::PwritePool;
+        }
+        stats_.backend = backend;
+        if (backend == WriteBackend::PwritePool) {
+            for (size_t i = 0; i < PWRITE_POOL_THREADS; ++i) {
+                pool_threads_.emplace_back([this] { pool_loop(); });
+            }
+        }
+        return true;
+    }
+
+    size_t buffer_bytes() const { return buffer_bytes_; }
+    unsigned char* buffer(size_t index) const { return buffers_[index].data.get(); }
+
+    /**
+     * @brief Take a free buffer to fill, waiting for a write to finish if
+     *        all of them are in flight
+     */
+    size_t acquire() {
+        const auto start = std::chrono::steady_clock::now();
+        bool waited = false;
+        size_t index = WRITE_BUFFER_COUNT;
+
+        if (stats_.backend == WriteBackend::PwritePool) {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            for (;;) {
+                index = find_free();
+                if (index < WRITE_BUFFER_COUNT) break;
+                waited = true;
+                pool_done_.wait(lock);
+            }
+            buffers_[index].state = BufferState::Filling;
+        } else {
+            if (stats_.backend == WriteBackend::IoUring) {
+                reap_uring(false);
+            }
+            while ((index = find_free()) == WRITE_BUFFER_COUNT) {
+                waited = true;
+                reap_uring(true);
+            }
+            buffers_[index].state = BufferState::Filling;
+        }
+
+        if (waited) {
+            record_wait(std::chrono::steady_clock::now() - start);
+        }
+        return index;
+    }
+
+    /**
+     * @brief Write the first `bytes` of an acquired buffer at `offset`
+     *
+     * With direct I/O, `bytes` and `offset` must be multiples of
+     * WRITE_BUFFER_ALIGNMENT.
+     */
+    void submit(size_t index, size_t bytes, uint64_t offset) {
+        Buffer& buffer = buffers_[index];
+        buffer.bytes = bytes;
+        buffer.done = 0;
+        buffer.offset = offset;
+        buffer.retried_buffered = false;
+        stats_.writes++;
+
+        switch (stats_.backend) {
+            case WriteBackend::IoUring:
+                // After a failure later buffers are dropped, not written
+                if (stats_.error != 0) {
+                    buffer.state = BufferState::Free;
+                    break;
+                }
+                buffer.state = BufferState::InFlight;
+                if (!submit_uring(index)) {
+                    fail(index, errno);
+                }
+                break;
+
+            case WriteBackend::PwritePool: {
+                std::lock_guard<std::mutex> lock(pool_mutex_);
+                buffer.state = BufferState::InFlight;
+                pool_queue_[(pool_queue_head_ + pool_queue_count_) % WRITE_BUFFER_COUNT] = index;
+                pool_queue_count_++;
+                pool_work_.notify_one();
+                break;
+            }
+
+            case WriteBackend::Write: {
+                const auto start = std::chrono::steady_clock::now();
+                int err = stats_.error == 0 ? pwrite_all(buffer) : 0;
+                record_wait(std::chrono::steady_clock::now() - start);
+                if (err != 0) record_error(err);
+                buffer.state = BufferState::Free;
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Wait for every submitted write to complete
+     */
+    void flush() {
+        const auto start = std::chrono::steady_clock::now();
+        if (stats_.backend == WriteBackend::PwritePool) {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            pool_done_.wait(lock, [this] { return in_flight() == 0; });
+        } else {
+            while (in_flight() > 0) {
+                reap_uring(true);
+            }
+        }
+        record_wait(std::chrono::steady_clock::now() - start);
+    }
+
+    /**
+     * @brief Wait for the writes in flight, then send every later one to `fd`
+     *
+     * Offsets given to submit() are in the new file from here on.
+     * @return The previous descriptor, which the caller now owns
+     */
+    int swap_file(int fd, bool direct_io) {
+        flush();
+        const int previous = fd_;
+        fd_ = fd;
+        direct_io_.store(direct_io, std::memory_order_relaxed);
+        return previous;
+    }
+
+    /**
+     * @brief Flush, stop the helpers and close the file
+     */
+    void close() {
+        if (fd_ < 0) return;
+        flush();
+        if (!pool_threads_.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(pool_mutex_);
+                pool_shutdown_ = true;
+            }
+            pool_work_.notify_all();
+            for (auto& t : pool_threads_) {
+                t.join();
+            }
+            pool_threads_.clear();
+        }
+        uring_.reset();
+        ::close(fd_);
+        fd_ = -1;
+
+        stats_.direct_io = direct_io_.load(std::memory_order_relaxed);
+        if (stats_.backend != WriteBackend::IoUring) {
+            stats_.bytes = bytes_written_.load(std::memory_order_relaxed);
+        }
+    }
+
+    const AsyncWriterStats& stats() const { return stats_; }
+
+private:
+    enum class BufferState : uint8_t { Free, Filling, InFlight };
+
+    struct FreeDeleter {
+        void operator()(unsigned char* p) const { std::free(p); }
+    };
+
+    struct Buffer {
+        std::unique_ptr<unsigned char, FreeDeleter> data;
+        size_t bytes = 0;        // To write
+        size_t done = 0;         // Written so far (short writes are resumed)
+        uint64_t offset = 0;
+        bool retried_buffered = false;
+        BufferState state = BufferState::Free;
+    };
+
+    size_t find_free() const {
+        for (size_t i = 0; i < WRITE_BUFFER_COUNT; ++i) {
+            if (buffers_[i].state == BufferState::Free) return i;
+        }
+        return WRITE_BUFFER_COUNT;
+    }
+
+    size_t in_flight() const {
+        size_t count = 0;
+        for (const auto& buffer : buffers_) {
+            count += buffer.state == BufferState::InFlight;
+        }
+        return count;
+    }
+
+    void record_wait(std::chrono::nanoseconds waited) {
+        stats_.wait_total += waited;
+        stats_.wait_max = std::max(stats_.wait_max, waited);
+    }
+
+    void record_error(int err) {
+        if (stats_.error == 0) stats_.error = err;
+    }
+
+    void fail(size_t index, int err) {
+        record_error(err);
+        buffers_[index].state = BufferState::Free;
+    }
+
+    // Some filesystems accept O_DIRECT at open and refuse it per write.
+    // True if the write is worth retrying buffered.
+    bool drop_direct_io(int err) {
+        if (err != EINVAL) return false;
+        bool expected = true;
+        if (direct_io_.compare_exchange_strong(expected, false)) {
+            fcntl(fd_, F_SETFL, fcntl(fd_, F_GETFL) & ~O_DIRECT);
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // io_uring backend
+    // ------------------------------------------------------------------------
+
+    bool init_uring() {
+        auto ring = std::make_unique<IoUring>();
+        if (!ring->init(2 * WRITE_BUFFER_COUNT)) {
+            return false;
+        }
+
+        // Registration pins the pages once; without it (e.g. RLIMIT_MEMLOCK)
+        // plain WRITE still works, pinning per call
+        std::array<iovec, WRITE_BUFFER_COUNT> iovecs;
+        for (size_t i = 0; i < WRITE_BUFFER_COUNT; ++i) {
+            iovecs[i] = iovec{buffers_[i].data.get(), buffer_bytes_};
+        }
+        stats_.registered_buffers = ring->register_buffers(iovecs.data(), WRITE_BUFFER_COUNT);
+        uring_ = std::move(ring);
+        return true;
+    }
+
+    bool submit_uring(size_t index) {
+        const Buffer& buffer = buffers_[index];
+        const bool fixed = stats_.registered_buffers;
+        return uring_->submit([&](io_uring_sqe& sqe) {
+            sqe.opcode = fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            sqe.fd = fd_;
+            sqe.addr = reinterpret_cast<uint64_t>(buffer.data.get() + buffer.done);
+            sqe.len = static_cast<uint32_t>(buffer.bytes - buffer.done);
+            sqe.off = buffer.offset + buffer.done;
+            if (fixed) sqe.buf_index = static_cast<uint16_t>(index);
+            sqe.user_data = index;
+        });
+    }
+
+    void reap_uring(bool wait) {
+        if (!uring_) return;
+        uring_->reap(wait, [this](uint64_t user_data, int32_t res) {
+            const size_t index = static_cast<size_t>(user_data);
+            Buffer& buffer = buffers_[index];
+            if (res < 0) {
+                if (!buffer.retried_buffered && drop_direct_io(-res)) {
+                    buffer.retried_buffered = true;
+                    if (submit_uring(index)) return;
+                }
+                fail(index, -res);
+                return;
+            }
+            buffer.done += static_cast<size_t>(res);
+            stats_.bytes += static_cast<uint64_t>(res);
+            if (buffer.done < buffer.bytes && res > 0) {
+                if (!submit_uring(index)) fail(index, errno);
+                return;
+            }
+            if (buffer.done < buffer.bytes) record_error(EIO);
+            buffer.state = BufferState::Free;
+        });
+    }
+
+    // ------------------------------------------------------------------------
+    // pwrite backends
+    // ------------------------------------------------------------------------
+
+    // Returns 0 or an errno. Called from the pool threads too.
+    int pwrite_all(Buffer& buffer) {
+        bool retried_buffered = false;
+        while (buffer.done < buffer.bytes) {
+            ssize_t n = ::pwrite(fd_, buffer.data.get() + buffer.done, buffer.bytes - buffer.done,
+                                 static_cast<off_t>(buffer.offset + buffer.done));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (!retried_buffered && drop_direct_io(errno)) {
+                    retried_buffered = true;
+                    continue;
+                }
+                return errno;
+            }
+            if (n == 0) return EIO;
+            buffer.done += static_cast<size_t>(n);
+            bytes_written_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        }
+        return 0;
+    }
+
+    void pool_loop() {
+        std::unique_lock<std::mutex> lock(pool_mutex_);
+        for (;;) {
+            pool_work_.wait(lock, [this] { return pool_shutdown_ || pool_queue_count_ > 0; });
+            if (pool_queue_count_ == 0) return;  // Shut down and nothing left
+
+            const size_t index = pool_queue_[pool_queue_head_];
+            pool_queue_head_ = (pool_queue_head_ + 1) % WRITE_BUFFER_COUNT;
+            pool_queue_count_--;
+
+            // After a failure later buffers are dropped, not written
+            const bool skip = stats_.error != 0;
+            lock.unlock();
+            int err = skip ? 0 : pwrite_all(buffers_[index]);
+            lock.lock();
+
+            if (err != 0) record_error(err);
+            buffers_[index].state = BufferState::Free;
+            pool_done_.notify_all();
+        }
+    }
+
+    std::array<Buffer, WRITE_BUFFER_COUNT> buffers_;
+    size_t buffer_bytes_ = 0;
+    int fd_ = -1;
+    AsyncWriterStats stats_;
+    std::atomic<bool> direct_io_{false};
+    std::atomic<uint64_t> bytes_written_{0};  // pwrite backends
+
+    std::unique_ptr<IoUring> uring_;
+
+    std::vector<std::thread> pool_threads_;
+    std::mutex pool_mutex_;
+    std::condition_variable pool_work_;
+    std::condition_variable pool_done_;
+    std::array<size_t, WRITE_BUFFER_COUNT> pool_queue_{};
+    size_t pool_queue_head_ = 0;
+    size_t pool_queue_count_ = 0;
+    bool pool_shutdown_ = false;
+};
+
+} // namespace f1sim
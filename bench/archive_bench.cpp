@@ -0,0 +1,270 @@
+// Columnar archive benchmark: races the engine headless into a ring that an
+// ArchiveWriter drains on another thread (as a live consumer would), then
+// compares a two-field analysis scan - top speed and mean tire wear per
+// driver - over the archive against the same scan over raw 64-byte frames,
+// from disk (page cache evicted) and from memory.
+// Finishes by decoding every chunk back into frames and checking them, for
+// this archive and for one whose header claims a tick rate above 1 kHz.
+//
+//   ./bench/archive_bench [--seed N] [--laps N] [--runs N] [--dir PATH]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "telemetry_archive.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+struct DriverSummary {
+    std::array<double, NUM_DRIVERS> top_speed{};
+    std::array<double, NUM_DRIVERS> wear_sum{};
+    std::array<uint64_t, NUM_DRIVERS> frames{};
+
+    bool operator==(const DriverSummary&) const = default;
+};
+
+DriverSummary scan_rows(const TelemetryFrame* frames, size_t count) {
+    DriverSummary summary;
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetryFrame& frame = frames[i];
+        summary.top_speed[frame.driver_id] = std::max<double>(summary.top_speed[frame.driver_id], frame.speed);
+        summary.wear_sum[frame.driver_id] += frame.tire_wear;
+        summary.frames[frame.driver_id]++;
+    }
+    return summary;
+}
+
+// Only the driver, speed and tire wear columns are decoded (or touched)
+DriverSummary scan_columns(const ArchiveReader& reader, bool& ok) {
+    DriverSummary summary;
+    std::vector<double> driver, speed, wear;
+    for (ArchiveColumn column : {ArchiveColumn::Driver, ArchiveColumn::Speed, ArchiveColumn::TireWear}) {
+        reader.prefetch(column);
+    }
+    for (size_t c = 0; c < reader.chunk_count(); ++c) {
+        ok = reader.read_column(c, ArchiveColumn::Driver, driver) &&
+             reader.read_column(c, ArchiveColumn::Speed, speed) &&
+             reader.read_column(c, ArchiveColumn::TireWear, wear) && ok;
+        // Rows are grouped by driver: accumulate each driver's run locally
+        for (size_t i = 0; i < driver.size();) {
+            const auto d = static_cast<size_t>(driver[i]);
+            double top = summary.top_speed[d];
+            double wear_sum = summary.wear_sum[d];
+            const size_t start = i;
+            for (; i < driver.size() && driver[i] == driver[start]; ++i) {
+                top = std::max(top, speed[i]);
+                wear_sum += wear[i];
+            }
+            summary.top_speed[d] = top;
+            summary.wear_sum[d] = wear_sum;
+            summary.frames[d] += i - start;
+        }
+    }
+    return summary;
+}
+
+// Drop a file's pages from the page cache so the next read comes from disk
+void evict(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+bool same_frame(const TelemetryFrame& a, const TelemetryFrame& b) {
+    return a.driver_id == b.driver_id && codec_detail::to_lanes(a) == codec_detail::to_lanes(b);
+}
+
+// Every chunk decoded in full must equal the frames fed in for its time
+// span, in driver-then-time order
+bool verify_round_trip(const ArchiveReader& reader, const std::vector<TelemetryFrame>& frames) {
+    const uint32_t span = reader.header().chunk_span_ms();
+    std::vector<TelemetryFrame> decoded;
+    std::vector<TelemetryFrame> expected;
+    size_t next = 0;
+    for (size_t c = 0; c < reader.chunk_count(); ++c) {
+        if (!reader.read_frames(c, decoded)) return false;
+
+        const size_t begin = next;
+        const uint32_t chunk = frames[begin].timestamp_ms / span;
+        while (next < frames.size() && frames[next].timestamp_ms / span == chunk) next++;
+        expected.clear();
+        for (size_t driver = 0; driver < NUM_DRIVERS; ++driver) {
+            for (size_t i = begin; i < next; ++i) {
+                if (frames[i].driver_id == driver) expected.push_back(frames[i]);
+            }
+        }
+        if (decoded.size() != expected.size() ||
+            !std::equal(decoded.begin(), decoded.end(), expected.begin(), same_frame)) {
+            return false;
+        }
+    }
+    return next == frames.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 10;
+    int runs = 10;
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--runs" && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::string archive_path = dir + "/f1sim_bench_archive.f1col";
+    const std::string rows_path = dir + "/f1sim_bench_rows.bin";
+
+    // Race into the ring; the writer drains it concurrently
+    RingBuffer<TelemetryFrame, 4096> ring;
+    ArchiveWriter writer;
+    ArchiveHeader header;
+    header.seed = seed;
+    header.laps = laps;
+    header.sim_hz = static_cast<uint16_t>(SIMULATION_HZ);
+    std::string error;
+    if (!writer.open(archive_path, header, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::vector<TelemetryFrame> frames;
+    const auto write_start = clock::now();
+    std::thread producer([&] {
+        RingBuffer<TelemetryFrame> unused_ring;
+        std::atomic<bool> stop{false};
+        RaceEngine engine(unused_ring, stop, seed, laps);
+        engine.set_strategy_budget(std::chrono::microseconds(0));
+        bool done = false;
+        while (!done) {
+            done = engine.step();
+            for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+                frames.push_back(engine.frame(i));
+                ring.push(frames.back());
+            }
+        }
+        ring.shutdown();
+    });
+    const bool written = writer.drain(ring);
+    producer.join();
+    const double write_seconds = elapsed_seconds(write_start);
+
+    FILE* rows = std::fopen(rows_path.c_str(), "wb");
+    const bool rows_written = rows && std::fwrite(frames.data(), sizeof(TelemetryFrame), frames.size(), rows) == frames.size();
+    if (rows) std::fclose(rows);
+
+    const ArchiveWriterStats& stats = writer.stats();
+    const double raw_bytes = static_cast<double>(frames.size() * sizeof(TelemetryFrame));
+    std::printf("Archive: %zu frames (seed %u, %u laps) in %" PRIu64 " chunks of %u ticks, race + write %.2f s\n",
+                frames.size(), seed, laps, stats.chunks, header.chunk_ticks, write_seconds);
+    std::printf("  %.2f MB vs %.2f MB raw (%.1fx smaller)\n", static_cast<double>(stats.bytes) / 1e6,
+                raw_bytes / 1e6, raw_bytes / static_cast<double>(stats.bytes));
+
+    if (!written || !rows_written) {
+        std::fprintf(stderr, "write failed\n");
+        return 1;
+    }
+
+    // Cold: both files evicted from the page cache, timed from open, so the
+    // disk reads count - what a first analysis pass over a race costs.
+    // Warm: both cached, which leaves bytes touched and decode cost.
+    Samples cold_rows_ms, cold_columns_ms, warm_rows_ms, warm_columns_ms;
+    bool ok = true;
+    bool same = true;
+    const int cold_runs = std::min(runs, 3);
+    for (int r = 0; r < cold_runs + runs; ++r) {
+        const bool cold = r < cold_runs;
+        if (cold) {
+            evict(rows_path);
+            evict(archive_path);
+        }
+
+        auto start = clock::now();
+        MappedFile rows_file;
+        ok = rows_file.open(rows_path, MADV_SEQUENTIAL) && ok;
+        const DriverSummary by_rows = scan_rows(reinterpret_cast<const TelemetryFrame*>(rows_file.data()),
+                                                rows_file.size() / sizeof(TelemetryFrame));
+        (cold ? cold_rows_ms : warm_rows_ms).add(elapsed_seconds(start) * 1e3);
+
+        start = clock::now();
+        ArchiveReader reader;
+        ok = reader.open(archive_path, error) && ok;
+        const DriverSummary by_columns = scan_columns(reader, ok);
+        (cold ? cold_columns_ms : warm_columns_ms).add(elapsed_seconds(start) * 1e3);
+        same = same && by_rows == by_columns;
+    }
+    for (Samples* samples : {&cold_rows_ms, &cold_columns_ms, &warm_rows_ms, &warm_columns_ms}) {
+        samples->finish();
+    }
+
+    ArchiveReader reader;
+    if (!reader.open(archive_path, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    std::printf("  %-14s %10s  %s\n", "column", "bytes", "encoding (first chunk)");
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+        std::printf("  %-14s %10" PRIu64 "  %s\n", ARCHIVE_COLUMN_INFO[c].name.data(), stats.column_bytes[c],
+                    column_encoding_name(reader.chunk(0).columns[c].encoding).data());
+    }
+
+    uint64_t column_bytes = 0;
+    for (size_t c = 0; c < reader.chunk_count(); ++c) {
+        for (ArchiveColumn column : {ArchiveColumn::Driver, ArchiveColumn::Speed, ArchiveColumn::TireWear}) {
+            column_bytes += reader.chunk(c).columns[static_cast<size_t>(column)].bytes;
+        }
+    }
+
+    std::printf("Scan: top speed + mean tire wear per driver\n");
+    std::printf("  rows:    %8.2f MB touched\n", raw_bytes / 1e6);
+    std::printf("  columns: %8.2f MB touched (driver, speed, tire_wear)\n", static_cast<double>(column_bytes) / 1e6);
+    cold_rows_ms.print_row("  row scan (cold)", "ms");
+    cold_columns_ms.print_row("  column scan (cold)", "ms");
+    warm_rows_ms.print_row("  row scan (warm)", "ms");
+    warm_columns_ms.print_row("  column scan (warm)", "ms");
+    std::printf("  results %s\n", ok && same ? "match" : "DIFFER");
+
+    bool round_trip = verify_round_trip(reader, frames);
+    std::printf("  round trip: %s\n", round_trip ? "bit-exact" : "MISMATCH");
+
+    // Above 1 kHz a tick is under a millisecond: chunks must still span one
+    ArchiveHeader fast_header = header;
+    fast_header.sim_hz = 2000;
+    ArchiveWriter fast_writer;
+    ArchiveReader fast_reader;
+    const std::vector<TelemetryFrame> head(frames.begin(), frames.begin() + std::min<size_t>(frames.size(), 20000));
+    bool fast_ok = fast_writer.open(archive_path, fast_header, error);
+    if (fast_ok) {
+        fast_writer.append(head.data(), head.size());
+        fast_ok = fast_writer.close() && fast_reader.open(archive_path, error) &&
+                  fast_reader.header().chunk_span_ms() > 0 && verify_round_trip(fast_reader, head);
+    }
+    std::printf("  round trip at %u Hz: %s\n", fast_header.sim_hz, fast_ok ? "bit-exact" : "MISMATCH");
+    round_trip = round_trip && fast_ok;
+
+    std::remove(archive_path.c_str());
+    std::remove(rows_path.c_str());
+    return ok && same && round_trip ? 0 : 1;
+}
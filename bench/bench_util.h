@@ -0,0 +1,55 @@
+#pragma once
+
+// Small helpers shared by the benchmark programs in bench/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace f1sim::bench {
+
+using clock = std::chrono::steady_clock;
+
+inline double elapsed_seconds(clock::time_point start) {
+    return std::chrono::duration<double>(clock::now() - start).count();
+}
+
+/**
+ * @brief Sorted sample set with percentile lookup
+ */
+class Samples {
+public:
+    explicit Samples(size_t reserve = 0) { values_.reserve(reserve); }
+
+    void add(double value) { values_.push_back(value); }
+    size_t size() const { return values_.size(); }
+
+    void finish() { std::sort(values_.begin(), values_.end()); }
+
+    // Call finish() first
+    double percentile(double p) const {
+        if (values_.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(p / 100.0 * static_cast<double>(values_.size() - 1));
+        return values_[idx];
+    }
+
+    double min() const { return values_.empty() ? 0.0 : values_.front(); }
+    double max() const { return values_.empty() ? 0.0 : values_.back(); }
+
+    void print_row(const char* label, const char* unit) const {
+        std::printf("%-24s p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f %s\n",
+                    label, percentile(50.0), percentile(99.0), percentile(99.9), max(), unit);
+    }
+
+private:
+    std::vector<double> values_;
+};
+
+// Keep the optimizer from discarding a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace f1sim::bench
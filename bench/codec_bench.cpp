@@ -0,0 +1,118 @@
+// Telemetry codec benchmark: races the engine headless, collects every
+// frame it would publish, then measures the delta encoding's size and its
+// encode/decode speed, and checks the round trip is bit-exact.
+//
+//   ./bench/codec_bench [--seed N] [--laps N] [--runs N]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "telemetry_codec.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+constexpr size_t KEYFRAME_INTERVAL = 1023;  // Frames per recording block (raw)
+
+std::vector<TelemetryFrame> race_frames(uint32_t seed, uint16_t laps) {
+    RingBuffer<TelemetryFrame> unused_ring;
+    std::atomic<bool> stop{false};
+    RaceEngine engine(unused_ring, stop, seed, laps);
+    engine.set_strategy_budget(std::chrono::microseconds(0));
+
+    std::vector<TelemetryFrame> frames;
+    bool done = false;
+    while (!done) {
+        done = engine.step();
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            frames.push_back(engine.frame(i));
+        }
+    }
+    return frames;
+}
+
+// Encodes with a reset every `keyframe_interval` frames, like the recorder
+size_t encode_all(const std::vector<TelemetryFrame>& frames, size_t keyframe_interval, uint8_t* out) {
+    FrameEncoder encoder;
+    size_t bytes = 0;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (i % keyframe_interval == 0) encoder.reset();
+        bytes += encoder.encode(frames[i], out + bytes);
+    }
+    return bytes;
+}
+
+bool decode_all(const uint8_t* data, size_t bytes, size_t count, size_t keyframe_interval,
+                TelemetryFrame* out) {
+    FrameDecoder decoder;
+    const uint8_t* p = data;
+    for (size_t i = 0; i < count; ++i) {
+        if (i % keyframe_interval == 0) decoder.reset();
+        if (!decoder.decode(p, data + bytes, out[i])) return false;
+    }
+    return p == data + bytes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 5;
+    int runs = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--runs" && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::vector<TelemetryFrame> frames = race_frames(seed, laps);
+    const double raw_bytes = static_cast<double>(frames.size() * sizeof(TelemetryFrame));
+    std::vector<uint8_t> encoded(frames.size() * MAX_ENCODED_FRAME_BYTES);
+    std::vector<TelemetryFrame> decoded(frames.size());
+
+    std::printf("Codec: %zu frames (seed %u, %u laps), %.1f MB raw\n",
+                frames.size(), seed, laps, raw_bytes / 1e6);
+
+    Samples encode_ns(static_cast<size_t>(runs));
+    Samples decode_ns(static_cast<size_t>(runs));
+    size_t bytes = 0;
+    bool round_trip = true;
+    for (int r = 0; r < runs; ++r) {
+        auto start = clock::now();
+        bytes = encode_all(frames, KEYFRAME_INTERVAL, encoded.data());
+        encode_ns.add(elapsed_seconds(start) * 1e9 / static_cast<double>(frames.size()));
+
+        start = clock::now();
+        round_trip = decode_all(encoded.data(), bytes, frames.size(), KEYFRAME_INTERVAL, decoded.data()) && round_trip;
+        decode_ns.add(elapsed_seconds(start) * 1e9 / static_cast<double>(frames.size()));
+    }
+    encode_ns.finish();
+    decode_ns.finish();
+    for (size_t i = 0; i < frames.size() && round_trip; ++i) {
+        round_trip = frames[i].driver_id == decoded[i].driver_id &&
+                     codec_detail::to_lanes(frames[i]) == codec_detail::to_lanes(decoded[i]);
+    }
+
+    std::printf("  encoded %.2f MB: %.2f bytes/frame, %.1fx smaller (keyframes every %zu frames)\n",
+                static_cast<double>(bytes) / 1e6, static_cast<double>(bytes) / static_cast<double>(frames.size()),
+                raw_bytes / static_cast<double>(bytes), KEYFRAME_INTERVAL);
+    std::printf("  no keyframes after the first: %.1fx smaller\n",
+                raw_bytes / static_cast<double>(encode_all(frames, frames.size(), encoded.data())));
+    encode_ns.print_row("encode", "ns/frame");
+    decode_ns.print_row("decode", "ns/frame");
+    std::printf("  encode %.1f M frames/s (1,000x live rate needs 1.0), decode %.1f M frames/s\n",
+                1e3 / encode_ns.percentile(50.0), 1e3 / decode_ns.percentile(50.0));
+    std::printf("  round trip: %s\n", round_trip ? "bit-exact" : "MISMATCH");
+    return round_trip ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Compact frame benchmark: races the engine headless, collects every frame
+// it would publish, then reports what quantizing them to
+// CompactTelemetryFrame costs - the largest error per field, how many frames
+// come back bit for bit, to_compact()/from_compact() speed - and what it
+// buys: frames/s and MB/s through a recorder-sized ring of each type, with
+// a consumer thread draining it in batches.
+//
+//   ./bench/compact_frame_bench [--seed N] [--laps N] [--runs N]
+
+#include "bench_util.h"
+#include "compact_frame.h"
+#include "race_engine.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+std::vector<TelemetryFrame> race_frames(uint32_t seed, uint16_t laps) {
+    RingBuffer<TelemetryFrame> unused_ring;
+    std::atomic<bool> stop{false};
+    RaceEngine engine(unused_ring, stop, seed, laps);
+    engine.set_strategy_budget(std::chrono::microseconds(0));
+
+    std::vector<TelemetryFrame> frames;
+    bool done = false;
+    while (!done) {
+        done = engine.step();
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            frames.push_back(engine.frame(i));
+        }
+    }
+    return frames;
+}
+
+struct FieldError {
+    const char* name;
+    float TelemetryFrame::*field;
+    double step;           // Quantization step
+    double max = 0.0;      // Largest |error| seen
+    double largest = 0.0;  // Largest |value| seen
+
+    // Half a step, plus what the float itself can't resolve at `largest`
+    double bound() const {
+        return step / 2.0 + largest * std::numeric_limits<float>::epsilon();
+    }
+};
+
+// Pushes `frames` through a ring `runs` times while a consumer pops them in
+// batches; returns frames/s
+template <typename Frame>
+double ring_throughput(const std::vector<Frame>& frames, int runs) {
+    auto ring = std::make_unique<RingBuffer<Frame, RECORDER_RING_FRAMES>>();
+    const size_t total = frames.size() * static_cast<size_t>(runs);
+    std::thread consumer([&] {
+        std::vector<Frame> batch(RECORDING_PAYLOAD_BYTES / sizeof(Frame));
+        size_t popped = 0;
+        while (size_t n = ring->pop_batch(batch.data(), batch.size())) {
+            popped += n;
+        }
+        do_not_optimize(popped);
+    });
+
+    const auto start = clock::now();
+    for (int r = 0; r < runs; ++r) {
+        for (const Frame& frame : frames) {
+            ring->push(frame);
+        }
+    }
+    ring->shutdown();
+    consumer.join();
+    return static_cast<double>(total) / elapsed_seconds(start);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 5;
+    int runs = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::vector<TelemetryFrame> frames = race_frames(seed, laps);
+    std::vector<CompactTelemetryFrame> compact(frames.size());
+    std::vector<TelemetryFrame> expanded(frames.size());
+    std::printf("Compact frames: %zu frames (seed %u, %u laps), %zu -> %zu bytes/frame\n",
+                frames.size(), seed, laps, sizeof(TelemetryFrame), sizeof(CompactTelemetryFrame));
+
+    Samples compact_ns(static_cast<size_t>(runs));
+    Samples expand_ns(static_cast<size_t>(runs));
+    for (int r = 0; r < runs; ++r) {
+        auto start = clock::now();
+        for (size_t i = 0; i < frames.size(); ++i) compact[i] = to_compact(frames[i]);
+        compact_ns.add(elapsed_seconds(start) * 1e9 / static_cast<double>(frames.size()));
+        do_not_optimize(compact.data());
+
+        start = clock::now();
+        for (size_t i = 0; i < frames.size(); ++i) expanded[i] = from_compact(compact[i]);
+        expand_ns.add(elapsed_seconds(start) * 1e9 / static_cast<double>(frames.size()));
+        do_not_optimize(expanded.data());
+    }
+    compact_ns.finish();
+    expand_ns.finish();
+
+    FieldError errors[] = {
+        {"speed (km/h)", &TelemetryFrame::speed, 1.0 / COMPACT_SPEED_SCALE},
+        {"distance (m)", &TelemetryFrame::distance, 1.0 / COMPACT_DISTANCE_SCALE},
+        {"throttle", &TelemetryFrame::throttle, 1.0 / COMPACT_THROTTLE_SCALE},
+        {"tire_wear (%)", &TelemetryFrame::tire_wear, 1.0 / COMPACT_WEAR_SCALE},
+        {"pit_timer (s)", &TelemetryFrame::pit_timer, COMPACT_PIT_TIMER_STEP},
+        {"gap_to_leader (s)", &TelemetryFrame::gap_to_leader, 1.0 / COMPACT_GAP_SCALE},
+    };
+    size_t lossless = 0;
+    bool integers_exact = true;
+    bool stable = true;  // Compacting an expanded frame gives the same bits back
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const TelemetryFrame& a = frames[i];
+        const TelemetryFrame& b = expanded[i];
+        for (FieldError& e : errors) {
+            e.max = std::max(e.max, std::fabs(static_cast<double>(a.*e.field) - static_cast<double>(b.*e.field)));
+            e.largest = std::max(e.largest, std::fabs(static_cast<double>(a.*e.field)));
+        }
+        integers_exact = integers_exact && a.timestamp_ms == b.timestamp_ms && a.driver_id == b.driver_id &&
+                         a.position == b.position && a.lap == b.lap && a.sector == b.sector &&
+                         a.pit_stops == b.pit_stops && a.flags == b.flags && a.interval_cs == b.interval_cs &&
+                         a.last_lap_time == b.last_lap_time && a.sector_times[0] == b.sector_times[0] &&
+                         a.sector_times[1] == b.sector_times[1] && a.sector_times[2] == b.sector_times[2];
+        stable = stable && to_compact(b) == compact[i];
+        lossless += compact_is_lossless(a) ? 1 : 0;
+    }
+
+    std::printf("  %-20s %12s %12s\n", "field", "max error", "bound");
+    for (const FieldError& e : errors) {
+        std::printf("  %-20s %12.6f %12.6f\n", e.name, e.max, e.bound());
+    }
+    std::printf("  integer fields %s, %.1f%% of frames bit for bit, re-compacting %s\n",
+                integers_exact ? "exact" : "CHANGED",
+                100.0 * static_cast<double>(lossless) / static_cast<double>(frames.size()),
+                stable ? "stable" : "UNSTABLE");
+    compact_ns.print_row("to_compact", "ns/frame");
+    expand_ns.print_row("from_compact", "ns/frame");
+
+    const double full_rate = ring_throughput(frames, runs);
+    const double compact_rate = ring_throughput(compact, runs);
+    std::printf("  ring: full %.1f M frames/s (%.0f MB/s), compact %.1f M frames/s (%.0f MB/s), %.2fx frames/s\n",
+                full_rate / 1e6, full_rate * sizeof(TelemetryFrame) / 1e6, compact_rate / 1e6,
+                compact_rate * sizeof(CompactTelemetryFrame) / 1e6, compact_rate / full_rate);
+
+    bool within_step = true;
+    for (const FieldError& e : errors) {
+        within_step = within_step && e.max <= e.bound();
+    }
+    return integers_exact && stable && within_step ? 0 : 1;
+}
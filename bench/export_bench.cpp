@@ -0,0 +1,164 @@
+// Export benchmark: races the engine headless, then exports every frame as
+// CSV, JSON and NDJSON with TelemetryExporter and as CSV the way the rest
+// of the project formats numbers (std::ostringstream + std::setprecision),
+// and reports MB/s of output on one core. Reads the CSV back and checks
+// every field against the frames.
+//
+//   ./bench/export_bench [--seed N] [--laps N] [--runs N] [--dir PATH]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "telemetry_export.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+std::vector<TelemetryFrame> race_frames(uint32_t seed, uint16_t laps) {
+    RingBuffer<TelemetryFrame> unused_ring;
+    std::atomic<bool> stop{false};
+    RaceEngine engine(unused_ring, stop, seed, laps);
+    engine.set_strategy_budget(std::chrono::microseconds(0));
+
+    std::vector<TelemetryFrame> frames;
+    bool done = false;
+    while (!done) {
+        done = engine.step();
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            frames.push_back(engine.frame(i));
+        }
+    }
+    return frames;
+}
+
+// Returns bytes written, 0 on failure
+uint64_t export_frames(const std::vector<TelemetryFrame>& frames, const std::string& path, ExportFormat format) {
+    TelemetryExporter exporter;
+    ExportOptions options;
+    options.format = format;
+    std::string error;
+    if (!exporter.open(path, options, error)) return 0;
+    exporter.write(frames.data(), frames.size());
+    return exporter.close() ? exporter.stats().bytes : 0;
+}
+
+// The same CSV through iostreams, six digits after the point for floats
+uint64_t export_iostream(const std::vector<TelemetryFrame>& frames, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+        out << (c > 0 ? "," : "") << ARCHIVE_COLUMN_INFO[c].name;
+    }
+    out << "\n";
+    for (const TelemetryFrame& frame : frames) {
+        std::ostringstream row;
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            const ArchiveColumnInfo& info = ARCHIVE_COLUMN_INFO[c];
+            const uint32_t bits = archive_detail::load_field(frame, info);
+            if (c > 0) row << ",";
+            if (info.type == ColumnType::F32) {
+                row << std::fixed << std::setprecision(6) << std::bit_cast<float>(bits);
+            } else {
+                row << bits;
+            }
+        }
+        row << "\n";
+        out << row.str();
+    }
+    out.flush();
+    return out ? static_cast<uint64_t>(out.tellp()) : 0;
+}
+
+// Parses the CSV export back and compares every field, bit for bit
+bool verify_csv(const std::string& path, const std::vector<TelemetryFrame>& frames) {
+    std::ifstream in(path, std::ios::binary);
+    std::string line;
+    if (!std::getline(in, line)) return false;  // Header
+
+    size_t row = 0;
+    while (std::getline(in, line)) {
+        if (row >= frames.size()) return false;
+        const char* p = line.data();
+        const char* end = line.data() + line.size();
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            const ArchiveColumnInfo& info = ARCHIVE_COLUMN_INFO[c];
+            uint32_t bits = 0;
+            std::from_chars_result result;
+            if (info.type == ColumnType::F32) {
+                float value = 0.0f;
+                result = std::from_chars(p, end, value);
+                bits = std::bit_cast<uint32_t>(value);
+            } else {
+                result = std::from_chars(p, end, bits);
+            }
+            if (result.ec != std::errc() || bits != archive_detail::load_field(frames[row], info)) return false;
+            p = result.ptr + 1;  // Past the comma
+        }
+        row++;
+    }
+    return row == frames.size();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 5;
+    int runs = 5;
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--runs" && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::vector<TelemetryFrame> frames = race_frames(seed, laps);
+    const std::string path = dir + "/f1sim_bench_export";
+    std::printf("Export: %zu frames (seed %u, %u laps), all %zu fields\n",
+                frames.size(), seed, laps, ARCHIVE_COLUMNS);
+    std::printf("  %-22s %10s %12s %10s\n", "", "MB", "MB/s (p50)", "ns/frame");
+
+    bool ok = true;
+    auto report = [&](const char* label, auto&& run) {
+        Samples seconds(static_cast<size_t>(runs));
+        uint64_t bytes = 0;
+        for (int r = 0; r < runs; ++r) {
+            const auto start = clock::now();
+            bytes = run();
+            seconds.add(elapsed_seconds(start));
+            ok = ok && bytes > 0;
+        }
+        seconds.finish();
+        const double s = seconds.percentile(50.0);
+        std::printf("  %-22s %10.1f %12.1f %10.1f\n", label, static_cast<double>(bytes) / 1e6,
+                    static_cast<double>(bytes) / 1e6 / s, s * 1e9 / static_cast<double>(frames.size()));
+    };
+
+    report("csv", [&] { return export_frames(frames, path + ".csv", ExportFormat::Csv); });
+    report("json", [&] { return export_frames(frames, path + ".json", ExportFormat::Json); });
+    report("ndjson", [&] { return export_frames(frames, path + ".ndjson", ExportFormat::Ndjson); });
+    report("csv (ostringstream)", [&] { return export_iostream(frames, path + ".iostream.csv"); });
+
+    const bool round_trip = verify_csv(path + ".csv", frames);
+    std::printf("  csv read back: %s\n", round_trip ? "bit-exact" : "MISMATCH");
+
+    for (const char* extension : {".csv", ".json", ".ndjson", ".iostream.csv"}) {
+        std::remove((path + extension).c_str());
+    }
+    return ok && round_trip ? 0 : 1;
+}
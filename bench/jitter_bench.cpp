@@ -0,0 +1,103 @@
+// Tick jitter benchmark: runs the engine's 50 Hz sleep_until loop and
+// measures how far each wake-up lands from its deadline, first with default
+// placement and then with the requested RT options.
+//
+//   ./bench/jitter_bench [--ticks N] [--cpu C] [--rt-policy fifo|rr]
+//                        [--rt-priority P] [--mlock]
+
+#include "bench_util.h"
+#include "realtime.h"
+#include "race_engine.h"
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+struct JitterResult {
+    Samples interval_error_us;  // |actual interval - 20 ms|
+    Samples lateness_us;        // wake-up time past the deadline
+};
+
+JitterResult measure(size_t ticks, const ThreadPlacement& placement, bool lock_memory) {
+    JitterResult result{Samples(ticks), Samples(ticks)};
+    
+    std::thread worker([&]() {
+        if (placement.cpu >= 0 || placement.policy != SchedPolicy::Default) {
+            apply_thread_placement(placement, "bench");
+        }
+        if (lock_memory) {
+            prefault_stack();
+        }
+        
+        const auto tick_duration = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(DT));
+        auto next_tick = clock::now() + tick_duration;
+        auto previous = clock::now();
+        
+        for (size_t i = 0; i < ticks; ++i) {
+            std::this_thread::sleep_until(next_tick);
+            auto now = clock::now();
+            
+            double interval_us = std::chrono::duration<double, std::micro>(now - previous).count();
+            double late_us = std::chrono::duration<double, std::micro>(now - next_tick).count();
+            result.interval_error_us.add(std::abs(interval_us - DT * 1e6));
+            result.lateness_us.add(late_us);
+            
+            previous = now;
+            next_tick += tick_duration;
+        }
+    });
+    worker.join();
+    
+    result.interval_error_us.finish();
+    result.lateness_us.finish();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ticks = 1500;  // 30 seconds at 50 Hz
+    ThreadPlacement placement;
+    placement.priority = 10;
+    bool lock_memory = false;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--cpu" && i + 1 < argc) placement.cpu = std::atoi(argv[++i]);
+        else if (arg == "--rt-policy" && i + 1 < argc) parse_sched_policy(argv[++i], placement.policy);
+        else if (arg == "--rt-priority" && i + 1 < argc) placement.priority = std::atoi(argv[++i]);
+        else if (arg == "--mlock") lock_memory = true;
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    
+    if (placement.cpu < 0 && placement.policy == SchedPolicy::Default && !lock_memory) {
+        placement.cpu = 0;
+        placement.policy = SchedPolicy::Fifo;
+        lock_memory = true;
+    }
+    
+    std::printf("Tick jitter: %zu ticks at %.0f Hz per run\n\n", ticks, SIMULATION_HZ);
+    
+    auto baseline = measure(ticks, ThreadPlacement{}, false);
+    baseline.interval_error_us.print_row("default  interval err", "us");
+    baseline.lateness_us.print_row("default  wake-up late", "us");
+    
+    if (lock_memory) {
+        lock_process_memory();
+    }
+    auto tuned = measure(ticks, placement, lock_memory);
+    tuned.interval_error_us.print_row("tuned    interval err", "us");
+    tuned.lateness_us.print_row("tuned    wake-up late", "us");
+    
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Neighbour query benchmark: per-tick cost of finding the car directly ahead
+// on track (lap-wrapped) and counting cars within 40 m, for every car.
+// Compares the NeighbourIndex against a naive all-pairs scan.
+//
+//   ./bench/neighbour_bench [--ticks N]
+
+#include "bench_util.h"
+#include "neighbour_index.h"
+
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+constexpr size_t MAX_CARS = 16384;
+constexpr float TRACK = 5000.0f;
+constexpr float RADIUS = 40.0f;
+
+struct Field {
+    std::vector<float> total;     // Total distance (for race order)
+    std::vector<float> lap;       // Lap-wrapped distance
+    std::vector<float> speed;     // m/s
+    std::vector<uint16_t> order;  // Race order, leader first
+
+    explicit Field(size_t n) : total(n), lap(n), speed(n), order(n) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> pos(0.0f, 3.0f * TRACK);
+        std::uniform_real_distribution<float> spd(50.0f, 60.0f);
+        for (size_t i = 0; i < n; ++i) {
+            total[i] = pos(rng);
+            speed[i] = spd(rng);
+        }
+        std::iota(order.begin(), order.end(), 0);
+        advance(0.0f);
+    }
+
+    void advance(float dt) {
+        for (size_t i = 0; i < total.size(); ++i) {
+            total[i] += speed[i] * dt;
+            lap[i] = total[i] - TRACK * static_cast<float>(static_cast<int>(total[i] / TRACK));
+        }
+        // Race order is maintained by the engine already; keep it cheap here
+        std::sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) {
+            return total[a] > total[b];
+        });
+    }
+};
+
+// O(n²): for every car, scan every other car
+// Cars at exactly the same distance count as "ahead" in both directions here;
+// the index breaks such ties by its sort order, so ties are reported separately
+float naive_tick(const Field& field, std::vector<uint16_t>& ahead, std::vector<uint16_t>& within,
+                 std::vector<uint16_t>& ties) {
+    const size_t n = field.lap.size();
+    float checksum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float best = TRACK;
+        uint16_t best_car = 0;
+        uint16_t count = 0;
+        uint16_t tied = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (i == j) continue;
+            float gap = field.lap[j] - field.lap[i];
+            if (gap < 0.0f) gap += TRACK;
+            if (gap < best) { best = gap; best_car = static_cast<uint16_t>(j); }
+            if (gap <= RADIUS) count++;
+            if (gap == 0.0f) tied++;
+        }
+        ahead[i] = best_car;
+        within[i] = count;
+        ties[i] = tied;
+        checksum += best;
+    }
+    return checksum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t ticks = 200;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::strtoul(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    
+    auto index = std::make_unique<NeighbourIndex<MAX_CARS>>();
+    std::printf("Neighbour queries: ahead + count within %.0f m, all cars, per tick\n\n", RADIUS);
+    std::printf("%8s %14s %14s %10s\n", "cars", "naive us/tick", "index us/tick", "speedup");
+    
+    for (size_t n : {20, 100, 1000, 10000}) {
+        Field field(n);
+        std::vector<uint16_t> ahead(n), within(n), ties(n);
+        
+        // Naive runs fewer ticks at large n; it is quadratic
+        size_t naive_ticks = std::max<size_t>(1, std::min(ticks, 2000000 / (n * n) + 1));
+        double naive_s = 0.0;
+        for (size_t t = 0; t < naive_ticks; ++t) {
+            field.advance(0.02f);
+            auto start = clock::now();
+            do_not_optimize(naive_tick(field, ahead, within, ties));
+            naive_s += elapsed_seconds(start);
+        }
+        
+        // Cross-check one tick against the naive answer
+        index->build(field.order.data(), n, field.lap.data(), TRACK, RADIUS);
+        for (size_t i = 0; i < n; ++i) {
+            if (index->count_within(i) > within[i] || index->count_within(i) + ties[i] < within[i]) {
+                std::fprintf(stderr, "mismatch at car %zu: %u vs %u\n", i, index->count_within(i), within[i]);
+                return 1;
+            }
+        }
+        
+        double index_s = 0.0;
+        for (size_t t = 0; t < ticks; ++t) {
+            field.advance(0.02f);
+            auto start = clock::now();
+            index->build(field.order.data(), n, field.lap.data(), TRACK, RADIUS);
+            float checksum = 0.0f;
+            for (size_t i = 0; i < n; ++i) {
+                checksum += index->gap_ahead(i) + static_cast<float>(index->count_within(i));
+            }
+            do_not_optimize(checksum);
+            index_s += elapsed_seconds(start);
+        }
+        
+        double naive_us = naive_s * 1e6 / static_cast<double>(naive_ticks);
+        double index_us = index_s * 1e6 / static_cast<double>(ticks);
+        std::printf("%8zu %14.1f %14.1f %9.1fx\n", n, naive_us, index_us, naive_us / index_us);
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+// Parallel export benchmark: records a race with TelemetryRecorder, then
+// (with the file in the page cache) exports it to CSV on 1, 2, 4, ... pool
+// threads, as one ordered file and as part files, and runs a per-driver
+// aggregation over the decoded chunks. Reports throughput and speedup over
+// one thread, and checks the ordered file is byte for byte what the
+// single-threaded TelemetryExporter writes.
+//
+//   ./bench/parallel_export_bench [--seed N] [--laps N] [--threads N] [--dir PATH]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "recording_reader.h"
+#include "telemetry_recorder.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+bool record_race(const std::string& path, uint32_t seed, uint16_t laps, uint64_t& frames) {
+    TelemetryTap tap;
+    TelemetryRecorder recorder(tap);
+    RecordingHeader header;
+    header.seed = seed;
+    header.laps = laps;
+    header.sim_hz = static_cast<uint16_t>(SIMULATION_HZ);
+    header.encoding = RecordingEncoding::Delta;
+    std::string error;
+    if (!recorder.open(path, header, error, WriteBackend::Write)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    recorder.start();
+
+    RingBuffer<TelemetryFrame> unused_ring;
+    std::atomic<bool> stop{false};
+    RaceEngine engine(unused_ring, stop, seed, laps);
+    engine.set_strategy_budget(std::chrono::microseconds(0));
+    bool done = false;
+    while (!done) {
+        done = engine.step();
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            tap.push(engine.frame(i));  // Waits for the recorder rather than dropping
+        }
+    }
+    recorder.finish();
+    frames = recorder.stats().frames;
+    return recorder.stats().io.error == 0;
+}
+
+// The single-threaded path: every block decoded and formatted in turn
+uint64_t export_sequential(const RecordingReader& reader, const std::string& path) {
+    TelemetryExporter exporter;
+    std::string error;
+    if (!exporter.open(path, ExportOptions{}, error)) return 0;
+    std::vector<TelemetryFrame> frames;
+    for (size_t c = 0; c < reader.chunk_count(); ++c) {
+        const bool intact = reader.decode_chunk(c, frames);
+        exporter.write(frames.data(), frames.size());
+        if (!intact) break;
+    }
+    return exporter.close() ? exporter.stats().bytes : 0;
+}
+
+bool same_file(const std::string& a, const std::string& b) {
+    MappedFile fa, fb;
+    return fa.open(a) && fb.open(b) && fa.size() == fb.size() && std::memcmp(fa.data(), fb.data(), fa.size()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 20;
+    size_t max_threads = 16;
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc) max_threads = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::string recording = dir + "/f1sim_bench_parallel.f1rec";
+    const std::string out = dir + "/f1sim_bench_parallel.csv";
+    uint64_t recorded = 0;
+    if (!record_race(recording, seed, laps, recorded)) {
+        std::fprintf(stderr, "recording failed\n");
+        return 1;
+    }
+
+    RecordingReader reader;
+    std::string error;
+    if (!reader.open(recording, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::printf("Parallel export: %" PRIu64 " frames (seed %u, %u laps), %zu delta blocks in %zu chunks, "
+                "%u hardware threads\n", recorded, seed, laps, reader.block_count(), reader.chunk_count(),
+                std::thread::hardware_concurrency());
+
+    auto start = clock::now();
+    const uint64_t sequential_bytes = export_sequential(reader, dir + "/f1sim_bench_sequential.csv");
+    const double sequential_s = elapsed_seconds(start);
+    std::printf("  sequential: %.1f MB CSV in %.2f s (%.0f MB/s)\n", static_cast<double>(sequential_bytes) / 1e6,
+                sequential_s, static_cast<double>(sequential_bytes) / 1e6 / sequential_s);
+
+    std::printf("  %7s %18s %18s %18s\n", "threads", "ordered MB/s (x)", "parts MB/s (x)", "aggregate ms (x)");
+    bool ok = sequential_bytes > 0;
+    bool identical = true;
+    double base[3] = {0.0, 0.0, 0.0};
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        ThreadPool pool(threads - 1);  // The calling thread is the last one
+        ParallelExportStats stats;
+
+        start = clock::now();
+        ok = export_recording(reader, pool, ExportOptions{}, out, ExportLayout::Single, stats, error) && ok;
+        const double ordered = static_cast<double>(stats.bytes) / 1e6 / elapsed_seconds(start);
+        identical = identical && same_file(out, dir + "/f1sim_bench_sequential.csv");
+
+        start = clock::now();
+        ok = export_recording(reader, pool, ExportOptions{}, out, ExportLayout::Parts, stats, error) && ok;
+        const double parts = static_cast<double>(stats.bytes) / 1e6 / elapsed_seconds(start);
+        for (size_t p = 0; p < stats.parts; ++p) {
+            std::remove(export_part_path(out, p).c_str());
+        }
+
+        // Top speed per driver: per-chunk partial results merged at the end
+        std::mutex mutex;
+        std::array<float, NUM_DRIVERS> top{};
+        start = clock::now();
+        reader.for_each_chunk(pool, [&](size_t, const TelemetryFrame* frames, size_t count) {
+            std::array<float, NUM_DRIVERS> local{};
+            for (size_t i = 0; i < count; ++i) {
+                local[frames[i].driver_id] = std::max(local[frames[i].driver_id], frames[i].speed);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t d = 0; d < NUM_DRIVERS; ++d) top[d] = std::max(top[d], local[d]);
+        });
+        const double aggregate_ms = elapsed_seconds(start) * 1e3;
+        do_not_optimize(top);
+
+        if (threads == 1) {
+            base[0] = ordered;
+            base[1] = parts;
+            base[2] = aggregate_ms;
+        }
+        std::printf("  %7zu %11.0f (%4.1f) %11.0f (%4.1f) %11.1f (%4.1f)\n", threads, ordered, ordered / base[0],
+                    parts, parts / base[1], aggregate_ms, base[2] / aggregate_ms);
+    }
+    std::printf("  ordered output %s the sequential export\n", identical ? "matches" : "DIFFERS FROM");
+    if (!ok) std::fprintf(stderr, "export failed: %s\n", error.c_str());
+
+    std::remove(out.c_str());
+    std::remove((dir + "/f1sim_bench_sequential.csv").c_str());
+    std::remove(recording.c_str());
+    std::remove(recording_index_path(recording).c_str());
+    return ok && identical ? 0 : 1;
+}
@@ -0,0 +1,279 @@
+// Recorder throughput benchmark: a producer thread pushes synthetic frames
+// into a TelemetryTap at a multiple of the live rate (50 Hz × 20 cars) while
+// the recorder drains it to disk, then the file is read back and every
+// block checksum verified. Runs once per write backend (io_uring, pwrite
+// pool, plain write) and compares throughput and CPU.
+//
+// --unpaced pushes as fast as the recorder drains (blocking push) to find
+// the sustained ceiling instead of holding a fixed rate. --segment-mb splits
+// the recording into segments of that size (--keep N keeps only the last
+// N closed ones); frames must still be dropped only when the disk can't
+// keep up, never because of a rotation.
+//
+//   ./bench/recorder_bench [--seconds S] [--rate-multiplier M] [--unpaced]
+//                          [--backend uring|pool|write] [--format delta|raw|compact]
+//                          [--segment-mb N] [--keep N] [--dir PATH]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "telemetry_recorder.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <time.h>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+TelemetryFrame synthetic_frame(uint64_t tick, size_t car) {
+    TelemetryFrame frame{};
+    frame.timestamp_ms = static_cast<uint32_t>(tick * 20);
+    frame.driver_id = static_cast<uint8_t>(car);
+    frame.position = static_cast<uint8_t>(car + 1);
+    frame.lap = static_cast<uint16_t>(tick / 4500 + 1);
+    frame.speed = 200.0f + static_cast<float>((tick + car * 7) % 100);
+    frame.distance = static_cast<float>(tick * 11 + car * 50) / 10.0f;  // No a*b+c to contract into an FMA
+    frame.throttle = 1.0f;
+    frame.tire_wear = static_cast<float>(tick % 4500) / 45.0f;
+    return frame;
+}
+
+// What a tap of each frame type holds for a frame
+const TelemetryFrame& tap_frame(const TelemetryFrame& frame, const TelemetryTap&) { return frame; }
+CompactTelemetryFrame tap_frame(const TelemetryFrame& frame, const CompactTelemetryTap&) { return to_compact(frame); }
+
+// Field by field: the padding bytes between fields aren't preserved by copies
+bool same_frame(const TelemetryFrame& a, const TelemetryFrame& b) {
+    return a.driver_id == b.driver_id && codec_detail::to_lanes(a) == codec_detail::to_lanes(b);
+}
+
+double thread_cpu_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// Every thread of the process, including pool helpers and io_uring workers
+double process_cpu_seconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    auto seconds = [](const timeval& tv) { return static_cast<double>(tv.tv_sec) + static_cast<double>(tv.tv_usec) * 1e-6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+struct ProducerResult {
+    uint64_t pushed = 0;
+    uint64_t dropped = 0;
+    double cpu_seconds = 0.0;
+    Samples tick_push_us;
+};
+
+// Pushes whole ticks (one frame per car) on the schedule a sped-up engine
+// would, yielding between them so the recorder gets the CPU when it needs
+// it. Unpaced, every tick is due at once and push() waits for room.
+template <typename Tap>
+ProducerResult produce(Tap& tap, double seconds, double ticks_per_second, bool unpaced) {
+    ProducerResult result{0, 0, 0.0, Samples(static_cast<size_t>(seconds * ticks_per_second))};
+    const double cpu_start = thread_cpu_seconds();
+    const auto start = clock::now();
+    uint64_t tick = 0;
+
+    for (;;) {
+        const double elapsed = elapsed_seconds(start);
+        if (elapsed >= seconds) break;
+
+        const auto due = unpaced ? tick + 64 : static_cast<uint64_t>(elapsed * ticks_per_second);
+        for (; tick < due; ++tick) {
+            const auto push_start = clock::now();
+            for (size_t car = 0; car < NUM_DRIVERS; ++car) {
+                const auto frame = tap_frame(synthetic_frame(tick, car), tap);
+                if (unpaced ? tap.push(frame) : tap.try_push(frame)) {
+                    result.pushed++;
+                } else {
+                    result.dropped++;
+                }
+            }
+            if (!unpaced) {
+                result.tick_push_us.add(std::chrono::duration<double, std::micro>(clock::now() - push_start).count());
+            }
+        }
+        if (!unpaced) std::this_thread::yield();
+    }
+    result.tick_push_us.finish();
+    result.cpu_seconds = thread_cpu_seconds() - cpu_start;
+    return result;
+}
+
+// Read the files back in order: header, every block checksum, every frame
+// decoded and compared with what synthetic_frame() produced. Counting
+// starts at the first frame found, as retention may have deleted earlier
+// segments; expected_frames 0 skips the total check.
+bool verify_files(const std::vector<std::string>& paths, uint64_t expected_frames) {
+    uint64_t frames = 0;
+    uint64_t next = 0;  // synthetic_frame() number expected next
+    uint32_t blocks = 0;
+    bool ok = !paths.empty();
+    bool frames_match = true;
+    std::vector<unsigned char> block(RECORDING_BLOCK_BYTES);
+
+    for (const std::string& path : paths) {
+        FILE* in = std::fopen(path.c_str(), "rb");
+        if (!in) return false;
+
+        RecordingHeader header;
+        ok = ok && std::fread(&header, sizeof(header), 1, in) == 1 &&
+             header.magic == RECORDING_MAGIC &&
+             std::fseek(in, header.header_bytes, SEEK_SET) == 0;
+
+        uint32_t sequence = 0;
+        while (ok && std::fread(block.data(), block.size(), 1, in) == 1) {
+            RecordingBlockHeader block_header;
+            std::memcpy(&block_header, block.data(), sizeof(block_header));
+            ok = verify_recording_block(block.data()) && block_header.sequence == sequence++ &&
+                 decode_recording_block(block.data(), header.encoding, [&](const TelemetryFrame& frame) {
+                     if (frames == 0) next = uint64_t{frame.timestamp_ms} / 20 * NUM_DRIVERS + frame.driver_id;
+                     TelemetryFrame expected = synthetic_frame(next / NUM_DRIVERS, next % NUM_DRIVERS);
+                     if (header.encoding == RecordingEncoding::Compact) expected = from_compact(to_compact(expected));
+                     frames_match = frames_match && same_frame(frame, expected);
+                     frames++;
+                     next++;
+                 });
+        }
+        blocks += sequence;
+        std::fclose(in);
+    }
+
+    std::printf("  read back: %" PRIu64 " frames in %" PRIu32 " blocks, %zu file%s, checksums %s, frames %s\n",
+                frames, blocks, paths.size(), paths.size() == 1 ? "" : "s", ok ? "OK" : "FAILED",
+                frames_match ? "match" : "DIFFER");
+    return ok && frames_match && (expected_frames == 0 || frames == expected_frames);
+}
+
+struct RunResult {
+    bool ok = false;
+    double mb_per_second = 0.0;
+    double recorder_cpu = 0.0;   // Seconds on the recorder thread
+    double other_cpu = 0.0;      // Seconds on helpers / kernel workers
+    uint64_t dropped = 0;
+};
+
+template <typename Tap>
+RunResult run(WriteBackend backend, RecordingEncoding encoding, const SegmentPolicy& segments,
+              const std::string& path, double seconds, double ticks_per_second, bool unpaced) {
+    Tap tap;
+    TelemetryRecorder recorder(tap);
+    RecordingHeader header;
+    header.encoding = encoding;
+    std::string error;
+    if (!recorder.open(path, header, error, backend, segments)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return {};
+    }
+
+    const double cpu_start = process_cpu_seconds();
+    const auto start = clock::now();
+    recorder.start();
+    ProducerResult produced = produce(tap, seconds, ticks_per_second, unpaced);
+    recorder.finish();
+    const double wall = elapsed_seconds(start);
+    const double process_cpu = process_cpu_seconds() - cpu_start;
+
+    const RecorderStats& stats = recorder.stats();
+    RunResult result;
+    result.mb_per_second = static_cast<double>(stats.io.bytes) / 1e6 / wall;
+    result.recorder_cpu = std::chrono::duration<double>(stats.cpu_time).count();
+    result.other_cpu = std::max(0.0, process_cpu - produced.cpu_seconds - result.recorder_cpu);
+    result.dropped = produced.dropped;
+
+    std::printf("[%s, %s%s%s]\n", recording_encoding_name(encoding).data(),
+                write_backend_name(stats.io.backend).data(),
+                stats.io.registered_buffers ? ", registered buffers" : "",
+                stats.io.direct_io ? ", direct I/O" : ", buffered");
+    std::printf("  pushed %" PRIu64 ", dropped %" PRIu64 " (%.3f%%)\n",
+                produced.pushed, produced.dropped,
+                100.0 * static_cast<double>(produced.dropped) /
+                    static_cast<double>(std::max<uint64_t>(produced.pushed + produced.dropped, 1)));
+    std::printf("  recorded %" PRIu64 " frames, %.1f MB in %.2f s: %.0f frames/s, %.1f MB/s\n",
+                stats.frames, static_cast<double>(stats.io.bytes) / 1e6, wall,
+                static_cast<double>(stats.frames) / wall, result.mb_per_second);
+    std::printf("  %" PRIu64 " writes, recorder blocked %.1f ms total (max %.1f us)\n", stats.io.writes,
+                std::chrono::duration<double, std::milli>(stats.io.wait_total).count(),
+                std::chrono::duration<double, std::micro>(stats.io.wait_max).count());
+    std::printf("  cpu: recorder thread %.1f ms (%.1f%%), helpers/kernel workers %.1f ms\n",
+                result.recorder_cpu * 1e3, 100.0 * result.recorder_cpu / wall, result.other_cpu * 1e3);
+    if (!unpaced) {
+        produced.tick_push_us.print_row("  push 20 frames (tick)", "us");
+    }
+    if (segments.enabled()) {
+        std::printf("  %" PRIu32 " segments, %" PRIu32 " deleted by retention, longest rotation %.1f us\n",
+                    stats.segments.segments, stats.segments.deleted,
+                    std::chrono::duration<double, std::micro>(stats.rotate_max).count());
+    }
+
+    const std::vector<std::string> paths = segments.enabled() ? find_recording_segments(path)
+                                                              : std::vector<std::string>{path};
+    const uint64_t expected = stats.segments.deleted > 0 ? 0 : stats.frames;
+    result.ok = stats.io.error == 0 && stats.segments.error == 0 && verify_files(paths, expected) &&
+                stats.frames == produced.pushed;
+    for (const std::string& file : paths) {
+        std::remove(file.c_str());
+        std::remove(recording_index_path(file).c_str());
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double seconds = 3.0;
+    double multiplier = 1000.0;
+    bool unpaced = false;
+    RecordingEncoding encoding = RecordingEncoding::Delta;
+    SegmentPolicy segments;
+    std::vector<WriteBackend> backends = {WriteBackend::IoUring, WriteBackend::PwritePool, WriteBackend::Write};
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        WriteBackend backend;
+        if (arg == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (arg == "--rate-multiplier" && i + 1 < argc) multiplier = std::atof(argv[++i]);
+        else if (arg == "--unpaced") unpaced = true;
+        else if (arg == "--backend" && i + 1 < argc && parse_write_backend(argv[++i], backend)) backends = {backend};
+        else if (arg == "--format" && i + 1 < argc && parse_recording_encoding(argv[++i], encoding)) {}
+        else if (arg == "--segment-mb" && i + 1 < argc) segments.max_bytes = static_cast<uint64_t>(std::atoi(argv[++i])) << 20;
+        else if (arg == "--keep" && i + 1 < argc) segments.keep_segments = static_cast<size_t>(std::atoi(argv[++i]));
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    segments.overwrite = true;  // Segments left at the bench's own scratch path
+    const std::string path = dir + "/f1sim_bench_recording.f1rec";
+    const double ticks_per_second = SIMULATION_HZ * multiplier;
+    const double target_fps = ticks_per_second * NUM_DRIVERS;
+
+    if (unpaced) {
+        std::printf("Recorder: unpaced for %.1f s -> %s\n", seconds, path.c_str());
+    } else {
+        std::printf("Recorder: %.0fx live rate = %.0f frames/s (%.1f MB/s) for %.1f s -> %s\n",
+                    multiplier, target_fps, target_fps * sizeof(TelemetryFrame) / 1e6, seconds, path.c_str());
+    }
+
+    bool ok = true;
+    for (WriteBackend backend : backends) {
+        RunResult result = encoding == RecordingEncoding::Compact
+            ? run<CompactTelemetryTap>(backend, encoding, segments, path, seconds, ticks_per_second, unpaced)
+            : run<TelemetryTap>(backend, encoding, segments, path, seconds, ticks_per_second, unpaced);
+        ok = ok && result.ok;
+    }
+    return ok ? 0 : 1;
+}
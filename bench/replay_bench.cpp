@@ -0,0 +1,281 @@
+// Replay benchmark: writes a multi-GB raw recording of synthetic frames,
+// drops it from the page cache, then measures how long ReplaySource takes
+// to open it and deliver the first frame from the middle of the race, the
+// frame rate it sustains at the maximum speed, and the latency of random
+// seeks (each lands on blocks that have never been read). Then rebuilds the
+// sidecar index from the recording and times seeks by race time and by lap
+// through it, again from a cold cache.
+//
+//   ./bench/replay_bench [--gb N] [--seconds S] [--seeks N] [--dir PATH]
+
+#include "bench_util.h"
+#include "replay_source.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+TelemetryFrame synthetic_frame(uint64_t tick, size_t car) {
+    TelemetryFrame frame{};
+    frame.timestamp_ms = static_cast<uint32_t>(tick * 20);
+    frame.driver_id = static_cast<uint8_t>(car);
+    frame.position = static_cast<uint8_t>(car + 1);
+    frame.lap = static_cast<uint16_t>(tick / 4500 + 1);
+    frame.speed = 200.0f + static_cast<float>((tick + car * 7) % 100);
+    frame.distance = static_cast<float>(tick) * 1.1f;
+    return frame;
+}
+
+// Raw recording of whole ticks, written block by block
+bool write_recording(const std::string& path, double gigabytes, uint64_t& frames) {
+    FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) return false;
+
+    RecordingHeader file_header;
+    file_header.encoding = RecordingEncoding::Raw;
+    file_header.sim_hz = 50;
+    std::vector<unsigned char> padded(RECORDING_ALIGNMENT, 0);
+    std::memcpy(padded.data(), &file_header, sizeof(file_header));
+    bool ok = std::fwrite(padded.data(), padded.size(), 1, out) == 1;
+
+    // A block is as big as 1024 frames; allocating it as frames keeps the
+    // payload 64-byte aligned
+    const auto blocks = static_cast<uint64_t>(gigabytes * 1e9 / RECORDING_BLOCK_BYTES);
+    std::vector<TelemetryFrame> block(RECORDING_BLOCK_BYTES / sizeof(TelemetryFrame));
+    TelemetryFrame* payload = block.data() + 1;
+    frames = 0;
+    for (uint64_t b = 0; ok && b < blocks; ++b) {
+        for (size_t i = 0; i < RECORDING_FRAMES_PER_BLOCK; ++i, ++frames) {
+            payload[i] = synthetic_frame(frames / NUM_DRIVERS, frames % NUM_DRIVERS);
+        }
+
+        RecordingBlockHeader header;
+        header.sequence = static_cast<uint32_t>(b);
+        header.frame_count = RECORDING_FRAMES_PER_BLOCK;
+        header.first_timestamp_ms = payload[0].timestamp_ms;
+        header.last_timestamp_ms = payload[RECORDING_FRAMES_PER_BLOCK - 1].timestamp_ms;
+        header.payload_bytes = RECORDING_PAYLOAD_BYTES;
+        header.checksum = recording_checksum(payload, RECORDING_PAYLOAD_BYTES);
+        std::memcpy(block.data(), &header, sizeof(header));
+        ok = std::fwrite(block.data(), RECORDING_BLOCK_BYTES, 1, out) == 1;
+    }
+    return std::fclose(out) == 0 && ok;
+}
+
+void evict(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+double since_ms(clock::time_point start) {
+    return elapsed_seconds(start) * 1e3;
+}
+
+/**
+ * @brief A ReplaySource playing into a ring drained by a consumer thread
+ *        that records the latest race time it saw
+ */
+class Session {
+public:
+    bool open(const std::string& path) {
+        std::string error;
+        if (!replay_.open(path, error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return false;
+        }
+        replay_.set_speed(MAX_REPLAY_SPEED);
+        return true;
+    }
+
+    ReplaySource& replay() { return replay_; }
+
+    void start() {
+        consumer_ = std::thread([this] {
+            TelemetryFrame frame;
+            uint32_t previous = 0;
+            while (ring_.pop(frame)) {
+                if (frame.timestamp_ms < previous && frame.timestamp_ms + 1000 > previous) {
+                    in_order_.store(false, std::memory_order_relaxed);  // Went back without a seek
+                }
+                previous = frame.timestamp_ms;
+                latest_ms_.store(frame.timestamp_ms, std::memory_order_release);
+                received_.fetch_add(1, std::memory_order_release);
+            }
+        });
+        producer_ = std::thread([this] { replay_.run(); });
+    }
+
+    uint64_t received() const { return received_.load(std::memory_order_acquire); }
+
+    // Until a frame within a second after `target_ms` comes out of the ring
+    void wait_for(uint32_t target_ms) const {
+        for (;;) {
+            const uint32_t at = latest_ms_.load(std::memory_order_acquire);
+            if (received() > 0 && at >= target_ms && at < target_ms + 1000) return;
+            std::this_thread::yield();
+        }
+    }
+
+    bool stop() {
+        stop_.store(true);
+        ring_.shutdown();
+        producer_.join();
+        consumer_.join();
+        return in_order_.load();
+    }
+
+private:
+    RingBuffer<TelemetryFrame> ring_;
+    std::atomic<bool> stop_{false};
+    ReplaySource replay_{ring_, stop_};
+    std::thread producer_;
+    std::thread consumer_;
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint32_t> latest_ms_{0};
+    std::atomic<bool> in_order_{true};
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    double gigabytes = 2.0;
+    double seconds = 2.0;
+    int seeks = 20;
+    std::string dir = "/tmp";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--gb" && i + 1 < argc) gigabytes = std::atof(argv[++i]);
+        else if (arg == "--seconds" && i + 1 < argc) seconds = std::atof(argv[++i]);
+        else if (arg == "--seeks" && i + 1 < argc) seeks = std::atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::string path = dir + "/f1sim_bench_replay.f1rec";
+    uint64_t frames = 0;
+    auto start = clock::now();
+    if (!write_recording(path, gigabytes, frames)) {
+        std::fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+    std::printf("Replay: %.2f GB raw recording, %" PRIu64 " frames (written in %.1f s)\n",
+                gigabytes, frames, elapsed_seconds(start));
+    evict(path);
+
+    bool in_order = true;
+    std::mt19937 rng(7);
+    uint32_t duration = 0;
+    {
+        // Startup: open, then the first frame from mid-race, all from a cold cache
+        Session session;
+        start = clock::now();
+        if (!session.open(path)) return 1;
+        const double open_ms = since_ms(start);
+        duration = session.replay().duration_ms();
+        session.replay().seek(duration / 2);
+        session.start();
+        session.wait_for(duration / 2);
+        const double first_frame_ms = since_ms(start);
+        std::printf("  open %.3f ms, first frame from %u:%02u in %.2f ms (race is %u:%02u long)\n",
+                    open_ms, duration / 2 / 60000, duration / 2 / 1000 % 60, first_frame_ms,
+                    duration / 60000, duration / 1000 % 60);
+
+        // Sustained rate at maximum speed: 1,000x real time is 1M frames/s
+        const uint64_t before = session.received();
+        start = clock::now();
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        const double rate = static_cast<double>(session.received() - before) / elapsed_seconds(start);
+        std::printf("  %.0fx: %.0f frames/s (%.2fx real time)\n", MAX_REPLAY_SPEED, rate,
+                    rate / (NUM_DRIVERS * 50.0));
+
+        // Random seeks into blocks never read, searching block headers
+        Samples seek_ms(static_cast<size_t>(seeks));
+        for (int s = 0; s < seeks; ++s) {
+            const uint32_t target = std::uniform_int_distribution<uint32_t>(0, duration - 2000)(rng);
+            start = clock::now();
+            session.replay().seek(target);
+            session.wait_for(target);
+            seek_ms.add(since_ms(start));
+        }
+        seek_ms.finish();
+        seek_ms.print_row("  time seek (cold)", "ms");
+        in_order = session.stop() && in_order;
+    }
+
+    // Sidecar index, rebuilt from the recording alone (cold), then used by a
+    // fresh session for time and lap seeks
+    evict(path);
+    {
+        Session session;
+        if (!session.open(path)) return 1;
+        std::string error;
+        start = clock::now();
+        if (!session.replay().rebuild_index(error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        const RecordingIndex& index = session.replay().index();
+        std::printf("  index rebuilt in %.2f s: %.1f KB (%zu time, %zu lap, %zu pit entries)\n",
+                    elapsed_seconds(start), static_cast<double>(index.bytes()) / 1e3,
+                    index.time_entries(), index.lap_entries(), index.pit_entries());
+    }
+    evict(path);
+    {
+        Session session;
+        if (!session.open(path)) return 1;
+        const uint16_t laps = static_cast<uint16_t>(duration / 20 / 4500);
+        session.replay().seek(0);
+        session.start();
+        session.wait_for(0);
+
+        Samples time_ms(static_cast<size_t>(seeks));
+        Samples lap_ms(static_cast<size_t>(seeks));
+        bool found = !session.replay().index().empty();
+        for (int s = 0; s < seeks && found; ++s) {
+            const uint32_t target = std::uniform_int_distribution<uint32_t>(0, duration - 2000)(rng);
+            start = clock::now();
+            session.replay().seek(target);
+            session.wait_for(target);
+            time_ms.add(since_ms(start));
+
+            RecordingPosition lap;
+            found = session.replay().index().lap_start(
+                std::uniform_int_distribution<uint16_t>(2, laps)(rng), lap);
+            start = clock::now();
+            session.replay().seek(lap);
+            session.wait_for(lap.timestamp_ms);
+            lap_ms.add(since_ms(start));
+        }
+        if (!found) {
+            std::fprintf(stderr, "index not loaded or lap missing\n");
+            return 1;
+        }
+        time_ms.finish();
+        lap_ms.finish();
+        time_ms.print_row("  indexed time seek (cold)", "ms");
+        lap_ms.print_row("  lap seek (cold)", "ms");
+        in_order = session.stop() && in_order;
+    }
+    std::printf("  order %s\n", in_order ? "OK" : "BROKEN");
+
+    std::remove(path.c_str());
+    std::remove(recording_index_path(path).c_str());
+    return in_order ? 0 : 1;
+}
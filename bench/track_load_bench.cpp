@@ -0,0 +1,96 @@
+// Track loading benchmark: writes a synthetic 10k-point centreline, then
+// times a cold load (parse + resample + cache write) against a warm load
+// (mmap of the cache).
+//
+//   ./bench/track_load_bench [--points N] [--runs N] [--dir PATH]
+
+#include "bench_util.h"
+#include "track_loader.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+// Roughly 5.5 km loop: an ellipse with wiggles that create slow sections
+void write_synthetic_track(const std::string& path, size_t points) {
+    FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        std::perror("fopen");
+        std::exit(1);
+    }
+    std::fprintf(out, "x,y,speed_kmh,drs\n");
+    for (size_t i = 0; i < points; ++i) {
+        double t = 2.0 * M_PI * static_cast<double>(i) / static_cast<double>(points);
+        double r = 1.0 + 0.08 * std::sin(7.0 * t);
+        double x = 1100.0 * r * std::cos(t);
+        double y = 650.0 * r * std::sin(t);
+        double speed = 200.0 + 120.0 * std::cos(7.0 * t);
+        int drs = (t < 0.6) ? 1 : 0;
+        std::fprintf(out, "%.3f,%.3f,%.1f,%d\n", x, y, speed, drs);
+    }
+    std::fclose(out);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t points = 10000;
+    int runs = 20;
+    std::string dir = "/tmp";
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--points" && i + 1 < argc) points = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--runs" && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (arg == "--dir" && i + 1 < argc) dir = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    
+    const std::string path = dir + "/f1sim_bench_track.csv";
+    write_synthetic_track(path, points);
+    
+    Samples cold(static_cast<size_t>(runs));
+    Samples warm(static_cast<size_t>(runs));
+    size_t sample_count = 0;
+    
+    for (int run = 0; run < runs; ++run) {
+        std::remove((path + ".cache").c_str());
+        std::string error;
+        
+        auto start = clock::now();
+        auto track = LoadedTrack::load(path, error);
+        cold.add(elapsed_seconds(start) * 1e6);
+        if (!track || track->from_cache()) {
+            std::fprintf(stderr, "cold load failed: %s\n", error.c_str());
+            return 1;
+        }
+        sample_count = track->view().sample_count;
+        
+        start = clock::now();
+        auto cached = LoadedTrack::load(path, error);
+        warm.add(elapsed_seconds(start) * 1e6);
+        if (!cached || !cached->from_cache()) {
+            std::fprintf(stderr, "warm load did not use the cache: %s\n", error.c_str());
+            return 1;
+        }
+        do_not_optimize(cached->view().sample(1234.0f).speed_limit);
+    }
+    cold.finish();
+    warm.finish();
+    
+    std::printf("Track load: %zu points -> %zu samples, %d runs\n\n", points, sample_count, runs);
+    cold.print_row("cold (parse+resample)", "us");
+    warm.print_row("warm (mmap cache)", "us");
+    
+    std::remove(path.c_str());
+    std::remove((path + ".cache").c_str());
+    return 0;
+}
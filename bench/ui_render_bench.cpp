@@ -0,0 +1,158 @@
+// Leaderboard render benchmark: races the engine headless and feeds every
+// frame to a TelemetryUI, drawing the leaderboard every 10th tick as the
+// live UI does - once repainting the whole screen each draw, once with
+// differential updates. Times each draw (format + write to the terminal,
+// /dev/null by default), counts the bytes and heap allocations per draw
+// once the first few draws have warmed the UI up, and replays the bytes
+// into a TerminalGrid to check the screen always matches the full frame.
+//
+//   ./bench/ui_render_bench [--seed N] [--laps N] [--out PATH]
+
+#include "bench_util.h"
+#include "race_engine.h"
+#include "telemetry_ui.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+}
+
+// Every heap allocation in the process, counted
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace f1sim;
+using namespace f1sim::bench;
+
+namespace {
+
+constexpr size_t WARMUP_DRAWS = 5;
+
+std::vector<TelemetryFrame> race_frames(uint32_t seed, uint16_t laps) {
+    RingBuffer<TelemetryFrame> unused_ring;
+    std::atomic<bool> stop{false};
+    RaceEngine engine(unused_ring, stop, seed, laps);
+    engine.set_strategy_budget(std::chrono::microseconds(0));
+
+    std::vector<TelemetryFrame> frames;
+    bool done = false;
+    while (!done) {
+        done = engine.step();
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            frames.push_back(engine.frame(i));
+        }
+    }
+    return frames;
+}
+
+struct RunResult {
+    Samples draw_us;
+    uint64_t bytes = 0;
+    uint64_t allocations = 0;
+    size_t draws = 0;
+    bool screen_matches = true;
+};
+
+RunResult run(const std::vector<TelemetryFrame>& frames, bool differential) {
+    RingBuffer<TelemetryFrame> ring;
+    std::atomic<bool> stop{false};
+    TelemetryUI ui(ring, stop);
+    ui.set_differential(differential);
+    std::cout << std::flush;
+
+    // What a terminal shows after every draw's bytes, and what it should
+    TerminalGrid terminal;
+    TerminalGrid expected;
+    terminal.resize(UI_FALLBACK_ROWS, UI_FALLBACK_COLS);  // The bench's stdout isn't a terminal
+    expected.resize(UI_FALLBACK_ROWS, UI_FALLBACK_COLS);
+
+    RunResult result{Samples(frames.size() / NUM_DRIVERS / UI_REDRAW_TICKS + 1)};
+    for (size_t i = 0; i < frames.size(); ++i) {
+        ui.update(frames[i]);
+        const bool tick_done = frames[i].driver_id == NUM_DRIVERS - 1;
+        if (!tick_done || (i / NUM_DRIVERS) % UI_REDRAW_TICKS != 0) continue;
+
+        const uint64_t allocations_before = allocations.load(std::memory_order_relaxed);
+        const auto start = clock::now();
+        const std::string_view written = ui.draw();
+        const double us = elapsed_seconds(start) * 1e6;
+        if (++result.draws > WARMUP_DRAWS) {
+            result.draw_us.add(us);
+            result.allocations += allocations.load(std::memory_order_relaxed) - allocations_before;
+            result.bytes += written.size();
+        }
+
+        terminal.apply(written);
+        expected.clear();
+        expected.apply(ui.screen());
+        result.screen_matches = result.screen_matches && terminal == expected;
+    }
+    result.draw_us.finish();
+    return result;
+}
+
+void print_result(const char* label, const RunResult& result) {
+    const double measured = static_cast<double>(result.draw_us.size());
+    result.draw_us.print_row(label, "us");
+    std::printf("  %.0f bytes/draw, %.2f heap allocations/draw, screen %s\n",
+                static_cast<double>(result.bytes) / measured, static_cast<double>(result.allocations) / measured,
+                result.screen_matches ? "matches every frame" : "DIFFERS");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t seed = 42;
+    uint16_t laps = 5;
+    std::string out = "/dev/null";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = static_cast<uint32_t>(std::atoi(argv[++i]));
+        else if (arg == "--laps" && i + 1 < argc) laps = static_cast<uint16_t>(std::atoi(argv[++i]));
+        else if (arg == "--out" && i + 1 < argc) out = argv[++i];
+        else {
+            std::fprintf(stderr, "Unknown argument: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    const std::vector<TelemetryFrame> frames = race_frames(seed, laps);
+
+    // The UI writes to stdout: point it at the target for the runs
+    std::fflush(stdout);
+    const int saved_stdout = dup(STDOUT_FILENO);
+    const int target = open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (saved_stdout < 0 || target < 0 || dup2(target, STDOUT_FILENO) < 0) {
+        std::fprintf(stderr, "cannot write %s\n", out.c_str());
+        return 1;
+    }
+    close(target);
+
+    const RunResult full = run(frames, false);
+    const RunResult differential = run(frames, true);
+    std::cout << std::flush;
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    std::printf("UI render: %zu draws of %zu drivers (seed %u, %u laps) -> %s\n",
+                full.draws, NUM_DRIVERS, seed, laps, out.c_str());
+    print_result("full redraw", full);
+    print_result("differential", differential);
+    std::printf("  differential writes %.1fx fewer bytes\n",
+                static_cast<double>(full.bytes) / static_cast<double>(std::max<uint64_t>(differential.bytes, 1)));
+    return full.screen_matches && differential.screen_matches ? 0 : 1;
+}
+
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "track_model.h"
+#include "telemetry_data.h"
+#include <array>
+#include <string_view>
+
+namespace f1sim {
+
+// ============================================================================
+// Built-in Circuits
+//
+// Declared as constexpr segment lists; CompiledTrack turns each into its
+// per-metre lookup table at compile time. Layouts are simplified: corners are
+// lumped into single segments with a representative minimum speed. Pit lanes
+// are {entry, length, first box, speed limit}.
+// ============================================================================
+
+namespace circuits {
+
+using enum SegmentType;
+
+// 5 km test circuit (matches TRACK_LENGTH)
+inline constexpr CircuitLayout<15> RING_LAYOUT{"ring", {{
+    // Sector 1
+    {Straight, 800.0f, 330.0f, true},    // Main straight (DRS)
+    {Corner,   120.0f, 110.0f, false},   // T1 braking zone
+    {Straight, 380.0f, 330.0f, false},
+    {Corner,   200.0f, 160.0f, false},   // T2-T3
+    {Straight, 200.0f, 330.0f, false},
+    // Sector 2
+    {Corner,   150.0f, 210.0f, false},   // Fast sweeper
+    {Straight, 650.0f, 330.0f, true},    // Back straight (DRS)
+    {Corner,   100.0f,  90.0f, false},   // Hairpin
+    {Straight, 500.0f, 330.0f, false},
+    {Corner,   250.0f, 180.0f, false},   // Long right-hander
+    // Sector 3
+    {Straight, 400.0f, 330.0f, false},
+    {Corner,   180.0f, 140.0f, false},
+    {Straight, 300.0f, 330.0f, false},
+    {Corner,   170.0f, 120.0f, false},   // Final corner
+    {Straight, 600.0f, 330.0f, false}    // Run to the line
+}}, {1700.0f, 3350.0f}, {4700.0f, 600.0f, 180.0f, PIT_LANE_SPEED_LIMIT_KMH}};
+
+inline constexpr CircuitLayout<15> MONZA_LAYOUT{"monza", {{
+    {Straight, 1120.0f, 340.0f, true},   // Rettifilo (DRS)
+    {Corner,    150.0f,  80.0f, false},  // Variante del Rettifilo
+    {Straight,  300.0f, 340.0f, false},
+    {Corner,    450.0f, 290.0f, false},  // Curva Grande
+    {Straight,  450.0f, 340.0f, false},
+    {Corner,    120.0f,  90.0f, false},  // Variante della Roggia
+    {Straight,  250.0f, 340.0f, false},
+    {Corner,    150.0f, 180.0f, false},  // Lesmo 1
+    {Straight,  200.0f, 340.0f, false},
+    {Corner,    130.0f, 170.0f, false},  // Lesmo 2
+    {Straight,  900.0f, 340.0f, true},   // Serraglio (DRS)
+    {Corner,    300.0f, 190.0f, false},  // Variante Ascari
+    {Straight,  900.0f, 340.0f, true},   // Back straight (DRS)
+    {Corner,    300.0f, 210.0f, false},  // Curva Alboreto
+    {Straight,   73.0f, 340.0f, false}
+}}, {2020.0f, 4220.0f}, {5600.0f, 700.0f, 200.0f, PIT_LANE_SPEED_LIMIT_KMH}};
+
+inline constexpr CircuitLayout<19> SILVERSTONE_LAYOUT{"silverstone", {{
+    {Straight, 250.0f, 320.0f, true},    // Hamilton straight (DRS)
+    {Corner,   300.0f, 280.0f, false},   // Abbey / Farm
+    {Corner,   150.0f, 110.0f, false},   // Village
+    {Corner,   100.0f,  80.0f, false},   // The Loop
+    {Corner,   150.0f, 170.0f, false},   // Aintree
+    {Straight, 770.0f, 320.0f, true},    // Wellington straight (DRS)
+    {Corner,   150.0f, 120.0f, false},   // Brooklands
+    {Corner,   200.0f, 100.0f, false},   // Luffield
+    {Corner,   250.0f, 230.0f, false},   // Woodcote
+    {Straight, 600.0f, 320.0f, false},   // National pit straight
+    {Corner,   200.0f, 260.0f, false},   // Copse
+    {Straight, 350.0f, 320.0f, false},
+    {Corner,   600.0f, 220.0f, false},   // Maggotts / Becketts / Chapel
+    {Straight, 800.0f, 320.0f, true},    // Hangar straight (DRS)
+    {Corner,   200.0f, 190.0f, false},   // Stowe
+    {Straight, 250.0f, 320.0f, false},
+    {Corner,   120.0f, 100.0f, false},   // Vale
+    {Corner,   200.0f, 150.0f, false},   // Club
+    {Straight, 251.0f, 320.0f, false}
+}}, {1870.0f, 4070.0f}, {2250.0f, 700.0f, 200.0f, PIT_LANE_SPEED_LIMIT_KMH}};
+
+inline constexpr CircuitLayout<18> SPA_LAYOUT{"spa", {{
+    {Straight,  300.0f, 320.0f, false},
+    {Corner,    100.0f,  70.0f, false},  // La Source
+    {Straight,  250.0f, 320.0f, false},
+    {Corner,    350.0f, 290.0f, false},  // Eau Rouge / Raidillon
+    {Straight, 1800.0f, 330.0f, true},   // Kemmel straight (DRS)
+    {Corner,    250.0f, 140.0f, false},  // Les Combes
+    {Corner,    150.0f, 150.0f, false},  // Malmedy
+    {Corner,    200.0f, 100.0f, false},  // Bruxelles
+    {Straight,  300.0f, 320.0f, false},
+    {Corner,    400.0f, 230.0f, false},  // Pouhon
+    {Straight,  400.0f, 320.0f, false},
+    {Corner,    250.0f, 150.0f, false},  // Fagnes
+    {Corner,    300.0f, 160.0f, false},  // Campus / Stavelot
+    {Straight,  400.0f, 320.0f, false},
+    {Corner,    900.0f, 300.0f, false},  // Blanchimont
+    {Straight,  200.0f, 320.0f, false},
+    {Corner,    150.0f,  80.0f, false},  // Bus Stop chicane
+    {Straight,  304.0f, 320.0f, true}    // Start/finish straight (DRS)
+}}, {2800.0f, 5450.0f}, {6550.0f, 750.0f, 250.0f, PIT_LANE_SPEED_LIMIT_KMH}};
+
+static_assert(RING_LAYOUT.length() == TRACK_LENGTH, "Default circuit must match TRACK_LENGTH");
+
+/**
+ * @brief All compiled circuits, selectable by name
+ */
+inline constexpr std::array<TrackView, 4> ALL = {
+    CompiledTrack<RING_LAYOUT>::view(),
+    CompiledTrack<MONZA_LAYOUT>::view(),
+    CompiledTrack<SILVERSTONE_LAYOUT>::view(),
+    CompiledTrack<SPA_LAYOUT>::view()
+};
+
+constexpr TrackView default_track() {
+    return ALL[0];
+}
+
+/**
+ * @brief Find a compiled circuit by name
+ * @return nullptr if no circuit has that name
+ */
+constexpr const TrackView* find(std::string_view name) {
+    for (const auto& track : ALL) {
+        if (track.name == name) return &track;
+    }
+    return nullptr;
+}
+
+} // namespace circuits
+
+} // namespace f1sim
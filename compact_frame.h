@@ -0,0 +1,150 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace f1sim {
+
+// ============================================================================
+// Compact Telemetry Frame
+//
+// A 32-byte TelemetryFrame for rings, recordings and channels that don't
+// need full float precision: two frames per cache line, half the bytes per
+// frame through memory and onto disk.
+//
+// Floats become fixed point with the scales below, rounded to nearest and
+// saturated at the field's range; integer fields keep their value except
+// where noted. Expanding a compact frame and compacting it again gives the
+// same bits back (for distance, while a float still resolves centimetres:
+// within 167 km of the line). The other direction is exact for any frame whose
+// values sit on the grid (compact_is_lossless()), e.g. the engine's
+// pit_timer, which is always a whole number of ticks.
+// ============================================================================
+
+constexpr double COMPACT_DISTANCE_SCALE = 100.0;  // cm, ±21,474 km (negative on the grid)
+constexpr double COMPACT_SPEED_SCALE = 100.0;     // 0.01 km/h, to 655.35 km/h
+constexpr double COMPACT_WEAR_SCALE = 100.0;      // 0.01 %, to 655.35 %
+constexpr double COMPACT_GAP_SCALE = 100.0;       // 0.01 s, ±327.67 s
+constexpr double COMPACT_THROTTLE_SCALE = 255.0;  // 1/255
+constexpr float COMPACT_PIT_TIMER_STEP = 0.02f;   // One physics tick, to 20.46 s
+
+constexpr uint32_t COMPACT_LAST_LAP_BITS = 22;
+constexpr uint32_t COMPACT_LAST_LAP_MAX = (1u << COMPACT_LAST_LAP_BITS) - 1;  // ms, 69.9 min
+constexpr uint32_t COMPACT_SECTOR_MAX = UINT16_MAX;        // ms, 65.5 s
+constexpr uint8_t COMPACT_PIT_STOPS_MAX = 15;
+
+/**
+ * @brief Quantized TelemetryFrame, 32 bytes
+ *
+ * `ids` packs driver_id (bits 0-4), position (5-9), sector (10-11) and
+ * pit_stops (12-15); `lap_pit` packs last_lap_time in ms (bits 0-21) and
+ * pit_timer in ticks (22-31).
+ */
+struct alignas(32) CompactTelemetryFrame {
+    uint32_t timestamp_ms;
+    int32_t distance;         // × COMPACT_DISTANCE_SCALE
+    uint32_t lap_pit;
+    uint16_t speed;           // × COMPACT_SPEED_SCALE
+    uint16_t tire_wear;       // × COMPACT_WEAR_SCALE
+    int16_t gap_to_leader;    // × COMPACT_GAP_SCALE
+    uint16_t interval_cs;
+    uint16_t lap;
+    uint16_t sector_times[3];
+    uint16_t ids;
+    uint8_t flags;
+    uint8_t throttle;         // × COMPACT_THROTTLE_SCALE
+
+    bool operator==(const CompactTelemetryFrame&) const = default;
+};
+
+static_assert(sizeof(CompactTelemetryFrame) == 32);
+static_assert(NUM_DRIVERS <= 32, "driver_id and position are packed into 5 bits");
+
+namespace compact_detail {
+
+template <typename T>
+T quantize(float value, double scale) {
+    const double scaled = std::nearbyint(static_cast<double>(value) * scale);
+    if (!(scaled > static_cast<double>(std::numeric_limits<T>::lowest()))) return std::numeric_limits<T>::lowest();
+    if (scaled >= static_cast<double>(std::numeric_limits<T>::max())) return std::numeric_limits<T>::max();
+    return static_cast<T>(scaled);
+}
+
+template <typename T>
+float expand(T value, double scale) {
+    return static_cast<float>(static_cast<double>(value) / scale);
+}
+
+} // namespace compact_detail
+
+inline CompactTelemetryFrame to_compact(const TelemetryFrame& frame) {
+    using compact_detail::quantize;
+    CompactTelemetryFrame out;
+    out.timestamp_ms = frame.timestamp_ms;
+    out.distance = quantize<int32_t>(frame.distance, COMPACT_DISTANCE_SCALE);
+    const uint32_t pit_ticks = std::min(quantize<uint32_t>(frame.pit_timer, 1.0 / COMPACT_PIT_TIMER_STEP),
+                                        UINT32_MAX >> COMPACT_LAST_LAP_BITS);
+    out.lap_pit = std::min(uint32_t{frame.last_lap_time}, COMPACT_LAST_LAP_MAX) | pit_ticks << COMPACT_LAST_LAP_BITS;
+    out.speed = quantize<uint16_t>(frame.speed, COMPACT_SPEED_SCALE);
+    out.tire_wear = quantize<uint16_t>(frame.tire_wear, COMPACT_WEAR_SCALE);
+    out.gap_to_leader = quantize<int16_t>(frame.gap_to_leader, COMPACT_GAP_SCALE);
+    out.interval_cs = frame.interval_cs;
+    out.lap = frame.lap;
+    for (size_t s = 0; s < 3; ++s) {
+        out.sector_times[s] = static_cast<uint16_t>(std::min(uint32_t{frame.sector_times[s]}, COMPACT_SECTOR_MAX));
+    }
+    out.ids = static_cast<uint16_t>((frame.driver_id & 0x1f) | (frame.position & 0x1f) << 5 |
+                                    (frame.sector & 0x3) << 10 |
+                                    std::min(uint8_t{frame.pit_stops}, COMPACT_PIT_STOPS_MAX) << 12);
+    out.flags = frame.flags;
+    out.throttle = quantize<uint8_t>(frame.throttle, COMPACT_THROTTLE_SCALE);
+    return out;
+}
+
+inline TelemetryFrame from_compact(const CompactTelemetryFrame& compact) {
+    using compact_detail::expand;
+    TelemetryFrame out{};
+    out.timestamp_ms = compact.timestamp_ms;
+    out.driver_id = static_cast<uint8_t>(compact.ids & 0x1f);
+    out.position = static_cast<uint8_t>(compact.ids >> 5 & 0x1f);
+    out.lap = compact.lap;
+    out.sector = static_cast<uint8_t>(compact.ids >> 10 & 0x3);
+    out.speed = expand(compact.speed, COMPACT_SPEED_SCALE);
+    out.distance = expand(compact.distance, COMPACT_DISTANCE_SCALE);
+    out.throttle = expand(compact.throttle, COMPACT_THROTTLE_SCALE);
+    out.tire_wear = expand(compact.tire_wear, COMPACT_WEAR_SCALE);
+    out.pit_stops = static_cast<uint8_t>(compact.ids >> 12);
+    out.pit_timer = static_cast<float>(compact.lap_pit >> COMPACT_LAST_LAP_BITS) * COMPACT_PIT_TIMER_STEP;
+    out.gap_to_leader = expand(compact.gap_to_leader, COMPACT_GAP_SCALE);
+    out.flags = compact.flags;
+    for (size_t s = 0; s < 3; ++s) {
+        out.sector_times[s] = compact.sector_times[s];
+    }
+    out.last_lap_time = compact.lap_pit & COMPACT_LAST_LAP_MAX;
+    out.interval_cs = compact.interval_cs;
+    return out;
+}
+
+/**
+ * @brief Whether `frame` survives to_compact() and back bit for bit
+ */
+inline bool compact_is_lossless(const TelemetryFrame& frame) {
+    const TelemetryFrame back = from_compact(to_compact(frame));
+    auto same = [](float a, float b) { return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b); };
+    return back.timestamp_ms == frame.timestamp_ms && back.driver_id == frame.driver_id &&
+           back.position == frame.position && back.lap == frame.lap && back.sector == frame.sector &&
+           same(back.speed, frame.speed) && same(back.distance, frame.distance) &&
+           same(back.throttle, frame.throttle) && same(back.tire_wear, frame.tire_wear) &&
+           back.pit_stops == frame.pit_stops && same(back.pit_timer, frame.pit_timer) &&
+           same(back.gap_to_leader, frame.gap_to_leader) && back.flags == frame.flags &&
+           back.sector_times[0] == frame.sector_times[0] && back.sector_times[1] == frame.sector_times[1] &&
+           back.sector_times[2] == frame.sector_times[2] && back.last_lap_time == frame.last_lap_time &&
+           back.interval_cs == frame.interval_cs;
+}
+
+} // namespace f1sim
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "race_engine.h"
+#include "ring_buffer.h"
+#include "state_hash.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Determinism Verification Harness
+// ============================================================================
+
+/**
+ * @brief Outcome of comparing a candidate run against a reference run
+ *
+ * Tick numbers are 1-based (the hash after the first update is tick 1).
+ */
+struct DeterminismReport {
+    const char* variant = "";
+    bool identical = true;
+    uint64_t ticks_compared = 0;
+    uint64_t first_divergent_tick = 0;  // 0 when identical
+    uint64_t expected_hash = 0;         // Reference hash at the divergent tick
+    uint64_t actual_hash = 0;           // Candidate hash at the divergent tick
+};
+
+/**
+ * @brief Runs the engine headless and compares per-tick state hashes
+ *
+ * Every variant replays the same seed and must match the reference trace
+ * tick for tick. New variants (different thread counts, SIMD paths, ...)
+ * only need to construct or configure the engine differently and call
+ * compare_run().
+ */
+class DeterminismHarness {
+public:
+    DeterminismHarness(uint32_t seed, uint16_t laps, uint64_t max_ticks,
+                       TrackView track = circuits::default_track())
+        : seed_(seed)
+        , laps_(laps)
+        , track_(track)
+        , max_ticks_(max_ticks)
+        , ring_buffer_(std::make_unique<RingBuffer<TelemetryFrame>>())
+    {
+    }
+
+    /**
+     * @brief Race every variant with these profiles instead of the built-in
+     *        ones, as the live race does with a season file
+     */
+    void set_profiles(const std::array<DriverProfile, NUM_DRIVERS>& drivers,
+                      const std::array<CarProfile, NUM_DRIVERS>& cars) {
+        profiles_ = Profiles{drivers, cars};
+    }
+
+    /**
+     * @brief Record the reference trace (must be called before any verify_*)
+     * @return Number of ticks recorded
+     */
+    uint64_t record_reference() {
+        auto engine = make_engine(seed_);
+        reference_ = run_to_end(*engine);
+        return reference_.size();
+    }
+
+    // Same seed, fresh engine
+    DeterminismReport verify_repeat() {
+        auto engine = make_engine(seed_);
+        return compare_run("repeat", *engine, 0);
+    }
+
+    /**
+     * @brief Run to checkpoint_tick, snapshot, and resume the snapshot in an
+     *        engine built from a different seed
+     *
+     * Any state missing from the checkpoint shows up as a divergence right
+     * after the restore point.
+     */
+    DeterminismReport verify_checkpoint_restore(uint64_t checkpoint_tick) {
+        auto source = make_engine(seed_);
+        for (uint64_t t = 0; t < checkpoint_tick && t < reference_.size(); ++t) {
+            source->step();
+        }
+        
+        auto resumed = make_engine(seed_ ^ 0x5a5a5a5aU);
+        resumed->restore(source->checkpoint());
+        return compare_run("checkpoint-restore", *resumed, source->tick_count());
+    }
+
+    /**
+     * @brief Same seed with a different number of pit strategy workers; plans
+     *        must not depend on how the cars were spread over threads
+     */
+    DeterminismReport verify_strategy_workers(size_t workers, const char* variant) {
+        auto engine = make_engine(seed_);
+        engine->set_strategy_workers(workers);
+        return compare_run(variant, *engine, 0);
+    }
+
+    /**
+     * @brief Compare an arbitrary engine against the reference trace
+     * @param start_tick Number of ticks the engine has already run
+     */
+    DeterminismReport compare_run(const char* variant, RaceEngine& engine, uint64_t start_tick) {
+        DeterminismReport report;
+        report.variant = variant;
+        
+        for (uint64_t t = start_tick; t < reference_.size(); ++t) {
+            engine.step();
+            report.ticks_compared++;
+            
+            if (engine.state_hash() != reference_[t]) {
+                report.identical = false;
+                report.first_divergent_tick = t + 1;
+                report.expected_hash = reference_[t];
+                report.actual_hash = engine.state_hash();
+                break;
+            }
+        }
+        return report;
+    }
+
+    std::unique_ptr<RaceEngine> make_engine(uint32_t seed) {
+        auto engine = std::make_unique<RaceEngine>(*ring_buffer_, stop_flag_, seed, laps_, track_);
+        if (profiles_) {
+            engine->set_profiles(profiles_->drivers, profiles_->cars);
+        }
+        return engine;
+    }
+
+    const std::vector<uint64_t>& reference() const { return reference_; }
+
+private:
+    std::vector<uint64_t> run_to_end(RaceEngine& engine) {
+        std::vector<uint64_t> trace;
+        trace.reserve(static_cast<size_t>(max_ticks_));
+        
+        for (uint64_t t = 0; t < max_ticks_; ++t) {
+            bool complete = engine.step();
+            trace.push_back(engine.state_hash());
+            if (complete) break;
+        }
+        return trace;
+    }
+
+    struct Profiles {
+        std::array<DriverProfile, NUM_DRIVERS> drivers;
+        std::array<CarProfile, NUM_DRIVERS> cars;
+    };
+
+    uint32_t seed_;
+    uint16_t laps_;
+    TrackView track_;
+    uint64_t max_ticks_;
+    std::optional<Profiles> profiles_;
+    std::unique_ptr<RingBuffer<TelemetryFrame>> ring_buffer_;  // Unused, engine requires one
+    std::atomic<bool> stop_flag_{false};
+    std::vector<uint64_t> reference_;
+};
+
+} // namespace f1sim
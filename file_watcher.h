@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace f1sim {
+
+// ============================================================================
+// File Watcher
+// ============================================================================
+
+/**
+ * @brief Calls back on a background thread whenever a file is rewritten
+ *
+ * Watches the file's directory rather than the file itself: editors and
+ * deploy scripts usually write a temp file and rename it over the original,
+ * which replaces the inode an inode watch would be attached to. Events for
+ * other names in the directory are ignored.
+ *
+ * The callback runs on the watcher thread, so it may parse and allocate
+ * freely; it must hand results to other threads through their own staging.
+ */
+class FileWatcher {
+public:
+    FileWatcher(std::string path, std::function<void()> on_change)
+        : on_change_(std::move(on_change))
+    {
+        size_t slash = path.find_last_of('/');
+        directory_ = slash == std::string::npos ? "." : path.substr(0, slash);
+        if (directory_.empty()) directory_ = "/";
+        name_ = slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+    ~FileWatcher() {
+        stop();
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * @return false (with `error` set) if inotify is unavailable
+     */
+    bool start(std::string& error) {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (inotify_fd_ < 0 || wake_fd_ < 0 ||
+            inotify_add_watch(inotify_fd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            error = "inotify on " + directory_ + ": " + std::strerror(errno);
+            close_fds();
+            return false;
+        }
+
+        thread_ = std::thread([this] { watch_loop(); });
+        return true;
+    }
+
+    void stop() {
+        if (thread_.joinable()) {
+            uint64_t one = 1;
+            (void)!write(wake_fd_, &one, sizeof(one));
+            thread_.join();
+        }
+        close_fds();
+    }
+
+private:
+    void watch_loop() {
+        // Room for a burst of events with names
+        alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        for (;;) {
+            if (poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            if (fds[1].revents & POLLIN) {
+                return;
+            }
+
+            // One callback per read, however many matching events it holds
+            // (a save is often several writes plus a rename)
+            bool changed = false;
+            ssize_t n;
+            while ((n = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* p = buffer; p < buffer + n;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(p);
+                    if (event->len > 0 && name_ == event->name) {
+                        changed = true;
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+            if (changed) {
+                on_change_();
+            }
+        }
+    }
+
+    void close_fds() {
+        if (inotify_fd_ >= 0) ::close(inotify_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        inotify_fd_ = -1;
+        wake_fd_ = -1;
+    }
+
+    std::string directory_;
+    std::string name_;
+    std::function<void()> on_change_;
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;
+    std::thread thread_;
+};
+
+} // namespace f1sim
@@ -1,12 +1,27 @@
 #include "race_engine.h"
 #include "telemetry_ui.h"
 #include "ring_buffer.h"
+#include "determinism.h"
+#include "state_hash.h"
+#include "realtime.h"
+#include "track_loader.h"
+#include "season_loader.h"
+#include "file_watcher.h"
+#include "telemetry_recorder.h"
+#include "replay_source.h"
+#include "recording_reader.h"
+#include "telemetry_export.h"
 #include <iostream>
+#include <fstream>
+#include <cinttypes>
 #include <thread>
+#include <cmath>
 #include <csignal>
 #include <cstdlib>
 #include <cstring>
 #include <atomic>
+#include <charconv>
+#include <filesystem>
 
 using namespace f1sim;
 
@@ -29,12 +44,115 @@ void signal_handler(int signal) {
 // Command-line argument parsing
 // ============================================================================
 
+// Where --replay-from starts playback
+struct ReplayTarget {
+    enum class Kind : uint8_t { Time, Lap, Stint };
+    
+    Kind kind = Kind::Time;
+    uint32_t time_ms = 0;
+    uint16_t number = 0;           // Lap or stint
+    uint8_t driver = INDEX_RACE;   // Lap: the race's lap unless a driver is given
+};
+
 struct SimulationConfig {
     uint32_t seed = 42;
     uint16_t laps = 5;
     bool show_help = false;
+    bool verify_determinism = false;
+    std::string hash_log_path;
+    OverrunPolicy overrun_policy = OverrunPolicy::CatchUp;
+    ThreadPlacement engine_placement;
+    ThreadPlacement ui_placement;
+    bool rt_priority_set = false;     // Explicit --rt-priority; otherwise physics gets 10
+    bool lock_memory = false;
+    TrackView track = circuits::default_track();
+    std::string track_file;
+    size_t strategy_workers = DEFAULT_STRATEGY_WORKERS;
+    std::string season_file = "data/season_2025.txt";
+    bool season_file_given = false;   // Explicit --season must load; the default may be absent
+    bool watch_season = true;
+    std::string record_path;
+    WriteBackend record_backend = DEFAULT_RECORDER_BACKEND;
+    RecordingEncoding record_encoding = RecordingEncoding::Delta;
+    SegmentPolicy record_segments;
+    std::string recover_path;
+    std::string replay_path;
+    double replay_speed = 1.0;
+    ReplayTarget replay_from;
+    std::string export_path;       // Recording to export
+    std::string export_to;         // Output file (default: recording path, new extension)
+    bool export_format_set = false;
+    ExportOptions export_options;
+    size_t export_threads = 0;     // 0: one per hardware thread
+    bool export_parts = false;     // One output file per chunk
+    uint32_t ui_redraw_ticks = UI_REDRAW_TICKS;
+    bool ui_differential = true;
 };
 
+// "90", "1:30" or "1:01:30" (seconds, m:ss, h:mm:ss) to milliseconds
+// Fails rather than wraps past UINT32_MAX milliseconds (~49.7 days)
+bool parse_race_time(std::string_view text, uint32_t& ms) {
+    constexpr uint64_t max_seconds = UINT32_MAX / 1000;
+    uint64_t seconds = 0;
+    uint64_t field = 0;
+    bool digits = false;
+    for (char c : text) {
+        if (c >= '0' && c <= '9') {
+            field = field * 10 + static_cast<uint64_t>(c - '0');
+            if (field > max_seconds) return false;
+            digits = true;
+        } else if (c == ':' && digits) {
+            if (seconds + field > max_seconds / 60) return false;
+            seconds = (seconds + field) * 60;
+            field = 0;
+            digits = false;
+        } else {
+            return false;
+        }
+    }
+    if (!digits || seconds + field > max_seconds) return false;
+    ms = static_cast<uint32_t>((seconds + field) * 1000);
+    return true;
+}
+
+bool parse_uint(std::string_view text, uint32_t max, uint32_t& value) {
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return ec == std::errc() && end == text.data() + text.size() && value <= max;
+}
+
+bool parse_count(std::string_view text, uint32_t max, uint32_t& value) {
+    return parse_uint(text, max, value) && value > 0;
+}
+
+// A race time, "lap42", "d7:lap42" (driver 7's lap 42) or "d7:stint3"
+bool parse_replay_target(std::string_view text, ReplayTarget& target) {
+    target = ReplayTarget{};
+    if (text.size() > 1 && text[0] == 'd') {
+        const size_t colon = text.find(':');
+        uint32_t driver = 0;
+        if (colon == std::string_view::npos ||
+            std::from_chars(text.data() + 1, text.data() + colon, driver).ptr != text.data() + colon ||
+            driver >= NUM_DRIVERS) {
+            return false;
+        }
+        target.driver = static_cast<uint8_t>(driver);
+        text.remove_prefix(colon + 1);
+    }
+
+    uint32_t number = 0;
+    if (text.starts_with("lap")) {
+        target.kind = ReplayTarget::Kind::Lap;
+        if (!parse_count(text.substr(3), UINT16_MAX, number)) return false;
+    } else if (text.starts_with("stint") && target.driver != INDEX_RACE) {
+        target.kind = ReplayTarget::Kind::Stint;
+        if (!parse_count(text.substr(5), UINT8_MAX, number)) return false;
+    } else {
+        return target.driver == INDEX_RACE && parse_race_time(text, target.time_ms);
+    }
+    target.number = static_cast<uint16_t>(number);
+    return true;
+}
+
 SimulationConfig parse_arguments(int argc, char* argv[]) {
     SimulationConfig config;
     
@@ -50,12 +168,194 @@ SimulationConfig parse_arguments(int argc, char* argv[]) {
         else if (arg == "--laps" && i + 1 < argc) {
             config.laps = static_cast<uint16_t>(std::atoi(argv[++i]));
         }
+        else if (arg == "--verify-determinism") {
+            config.verify_determinism = true;
+        }
+        else if (arg == "--hash-log" && i + 1 < argc) {
+            config.hash_log_path = argv[++i];
+        }
+        else if (arg == "--track" && i + 1 < argc) {
+            const TrackView* track = circuits::find(argv[++i]);
+            if (track) {
+                config.track = *track;
+            } else {
+                std::cerr << "Unknown track: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--track-file" && i + 1 < argc) {
+            config.track_file = argv[++i];
+        }
+        else if (arg == "--engine-cpu" && i + 1 < argc) {
+            config.engine_placement.cpu = std::atoi(argv[++i]);
+        }
+        else if (arg == "--ui-cpu" && i + 1 < argc) {
+            config.ui_placement.cpu = std::atoi(argv[++i]);
+        }
+        else if (arg == "--rt-policy" && i + 1 < argc) {
+            if (!parse_sched_policy(argv[++i], config.engine_placement.policy)) {
+                std::cerr << "Unknown scheduling policy: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+            config.ui_placement.policy = config.engine_placement.policy;
+        }
+        else if (arg == "--rt-priority" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+            const int min = sched_get_priority_min(SCHED_FIFO);
+            const int max = sched_get_priority_max(SCHED_FIFO);
+            int priority = 0;
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), priority);
+            if (ec != std::errc{} || end != value.data() + value.size() || priority < min || priority > max) {
+                std::cerr << "--rt-priority must be " << min << " to " << max << "\n";
+                config.show_help = true;
+            } else {
+                config.engine_placement.priority = priority;
+                config.rt_priority_set = true;
+            }
+        }
+        else if (arg == "--mlock") {
+            config.lock_memory = true;
+        }
+        else if (arg == "--season" && i + 1 < argc) {
+            config.season_file = argv[++i];
+            config.season_file_given = true;
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            config.record_path = argv[++i];
+        }
+        else if (arg == "--record-io" && i + 1 < argc) {
+            if (!parse_write_backend(argv[++i], config.record_backend)) {
+                std::cerr << "Unknown recording backend: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--record-format" && i + 1 < argc) {
+            if (!parse_recording_encoding(argv[++i], config.record_encoding)) {
+                std::cerr << "Unknown recording format: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--record-segment-mb" && i + 1 < argc) {
+            config.record_segments.max_bytes = static_cast<uint64_t>(std::max(1, std::atoi(argv[++i]))) << 20;
+        }
+        else if (arg == "--record-segment-time" && i + 1 < argc) {
+            uint32_t ms = 0;
+            if (!parse_race_time(argv[++i], ms) || ms == 0) {
+                std::cerr << "Bad segment length: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+            config.record_segments.max_ms = ms;
+        }
+        else if (arg == "--record-keep" && i + 1 < argc) {
+            config.record_segments.keep_segments = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        }
+        else if (arg == "--record-overwrite") {
+            config.record_segments.overwrite = true;
+        }
+        else if (arg == "--record-keep-mb" && i + 1 < argc) {
+            config.record_segments.keep_bytes = static_cast<uint64_t>(std::max(0, std::atoi(argv[++i]))) << 20;
+        }
+        else if (arg == "--recover" && i + 1 < argc) {
+            config.recover_path = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            config.replay_path = argv[++i];
+        }
+        else if (arg == "--replay-speed" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+            double speed = 0.0;
+            const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), speed);
+            // Written so NaN fails too
+            if (ec != std::errc{} || end != value.data() + value.size() ||
+                !(speed >= MIN_REPLAY_SPEED && speed <= MAX_REPLAY_SPEED)) {
+                std::cerr << "Replay speed must be between " << MIN_REPLAY_SPEED << " and "
+                          << MAX_REPLAY_SPEED << "\n";
+                config.show_help = true;
+            } else {
+                config.replay_speed = speed;
+            }
+        }
+        else if (arg == "--replay-from" && i + 1 < argc) {
+            if (!parse_replay_target(argv[++i], config.replay_from)) {
+                std::cerr << "Bad replay position: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--export" && i + 1 < argc) {
+            config.export_path = argv[++i];
+        }
+        else if (arg == "--export-to" && i + 1 < argc) {
+            config.export_to = argv[++i];
+        }
+        else if (arg == "--export-format" && i + 1 < argc) {
+            config.export_format_set = parse_export_format(argv[++i], config.export_options.format);
+            if (!config.export_format_set) {
+                std::cerr << "Unknown export format: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--export-fields" && i + 1 < argc) {
+            std::string error;
+            if (!parse_export_fields(argv[++i], config.export_options.fields, error)) {
+                std::cerr << "Bad --export-fields: " << error << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--export-drivers" && i + 1 < argc) {
+            std::string error;
+            if (!parse_export_drivers(argv[++i], config.export_options.drivers, error)) {
+                std::cerr << "Bad --export-drivers: " << error << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--export-threads" && i + 1 < argc) {
+            config.export_threads = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        }
+        else if (arg == "--export-parts") {
+            config.export_parts = true;
+        }
+        else if (arg == "--ui-hz" && i + 1 < argc) {
+            const int hz = std::atoi(argv[++i]);
+            if (hz >= 1 && hz <= static_cast<int>(SIMULATION_HZ)) {
+                config.ui_redraw_ticks = static_cast<uint32_t>(std::lround(SIMULATION_HZ / hz));
+            } else {
+                std::cerr << "--ui-hz must be 1 to " << SIMULATION_HZ << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--ui-full-redraw") {
+            config.ui_differential = false;
+        }
+        else if (arg == "--no-watch") {
+            config.watch_season = false;
+        }
+        else if (arg == "--strategy-workers" && i + 1 < argc) {
+            uint32_t workers = 0;
+            if (parse_uint(argv[++i], MAX_STRATEGY_WORKERS, workers)) {
+                config.strategy_workers = workers;
+            } else {
+                std::cerr << "--strategy-workers must be 0 to " << MAX_STRATEGY_WORKERS << "\n";
+                config.show_help = true;
+            }
+        }
+        else if (arg == "--overrun-policy" && i + 1 < argc) {
+            if (!parse_overrun_policy(argv[++i], config.overrun_policy)) {
+                std::cerr << "Unknown overrun policy: " << argv[i] << "\n";
+                config.show_help = true;
+            }
+        }
         else {
             std::cerr << "Unknown argument: " << arg << "\n";
             config.show_help = true;
         }
     }
     
+    // Physics outranks the UI so rendering can never delay a tick
+    if (!config.rt_priority_set) {
+        config.engine_placement.priority = 10;
+    }
+    config.ui_placement.priority = std::max(1, config.engine_placement.priority - 1);
+    
     return config;
 }
 
@@ -73,6 +373,59 @@ void print_usage(const char* program_name) {
     std::cout << "Options:\n";
     std::cout << "  --seed N     Set random seed for deterministic replay (default: 42)\n";
     std::cout << "  --laps N     Set number of race laps (default: 5)\n";
+    std::cout << "  --track NAME Circuit to race on:";
+    for (const auto& track : circuits::ALL) {
+        std::cout << " " << track.name;
+    }
+    std::cout << " (default: " << circuits::default_track().name << ")\n";
+    std::cout << "  --track-file PATH  Load a custom circuit (CSV \"x,y,speed_kmh[,drs]\"\n";
+    std::cout << "               or binary points); resampled once and cached as PATH.cache\n";
+    std::cout << "  --verify-determinism  Run the race headless several ways and\n";
+    std::cout << "               report the first tick where state hashes diverge\n";
+    std::cout << "  --hash-log FILE  Write the per-tick state hash to FILE\n";
+    std::cout << "  --overrun-policy P  What to do when a tick blows its 20ms budget:\n";
+    std::cout << "               catchup (burst, default), drop (skip missed slots),\n";
+    std::cout << "               slow (stretch the race)\n";
+    std::cout << "  --season FILE    Teams, drivers and profiles (default: data/season_2025.txt,\n";
+    std::cout << "               built-in profiles if absent); reloaded live when edited\n";
+    std::cout << "  --no-watch       Don't reload the season file while racing\n";
+    std::cout << "  --record FILE    Write every telemetry frame to FILE on a separate I/O thread\n";
+    std::cout << "  --record-io B    Recording writes: uring (default, pwrite pool if unavailable),\n";
+    std::cout << "               pool or write\n";
+    std::cout << "  --record-format F  delta (default, ~12x smaller, lossless), raw frames,\n";
+    std::cout << "               or compact (32-byte quantized frames, half of raw)\n";
+    std::cout << "  --record-segment-mb N  Split the recording into FILE.segNNNNN files of N MiB\n";
+    std::cout << "  --record-segment-time T  ... or of T race time (seconds, m:ss or h:mm:ss)\n";
+    std::cout << "  --record-keep N  Keep only the last N closed segments\n";
+    std::cout << "  --record-keep-mb N  Keep only the last N MiB of closed segments\n";
+    std::cout << "  --record-overwrite  Replace segments an earlier run left at FILE\n";
+    std::cout << "               (without it the recording refuses to start)\n";
+    std::cout << "  --recover FILE   Truncate recording FILE (or its segments) after the last\n";
+    std::cout << "               intact block, e.g. after a crash (no race)\n";
+    std::cout << "  --replay FILE    Watch a recording instead of racing (no physics)\n";
+    std::cout << "  --replay-speed X Playback speed, 0.25 to 1000 (default: 1)\n";
+    std::cout << "  --replay-from T  Start at race time T (seconds, m:ss or h:mm:ss), lapN,\n";
+    std::cout << "               dD:lapN or dD:stintN (driver D's lap or stint N)\n";
+    std::cout << "  --export FILE    Convert recording FILE to CSV/JSON/NDJSON (no race)\n";
+    std::cout << "  --export-to OUT  Output file; format from its extension (default: FILE.csv)\n";
+    std::cout << "  --export-format F  csv, json (one array) or ndjson (one object per line)\n";
+    std::cout << "  --export-fields LIST  Fields to write, e.g. timestamp_ms,driver_id,speed\n";
+    std::cout << "               (default: all, named as in telemetry_archive.h)\n";
+    std::cout << "  --export-drivers LIST  Only these driver ids, e.g. 0,7\n";
+    std::cout << "  --export-threads N  Threads decoding and formatting (default: all cores)\n";
+    std::cout << "  --export-parts   One file per chunk (OUT.partNNNNN.ext) instead of one file\n";
+    std::cout << "  --ui-hz N        Leaderboard redraws per second, 1 to " << SIMULATION_HZ << " (default: "
+              << SIMULATION_HZ / UI_REDRAW_TICKS << ")\n";
+    std::cout << "  --ui-full-redraw Repaint the whole screen every redraw instead of\n";
+    std::cout << "               only the cells that changed\n";
+    std::cout << "  --strategy-workers N  Threads for the pit strategy solver (default: "
+              << DEFAULT_STRATEGY_WORKERS << ", 0 = physics thread)\n";
+    std::cout << "  --engine-cpu N   Pin the physics thread to CPU N\n";
+    std::cout << "  --ui-cpu N       Pin the UI thread to CPU N\n";
+    std::cout << "  --rt-policy P    Real-time scheduling: fifo, rr or default\n";
+    std::cout << "  --rt-priority N  RT priority for physics (UI runs one below, default: 10)\n";
+    std::cout << "  --mlock          Lock and prefault memory before the race starts\n";
+    std::cout << "               (RT options fall back to defaults if not permitted)\n";
     std::cout << "  --help, -h   Show this help message\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << " --seed 1337 --laps 10\n";
@@ -80,6 +433,338 @@ void print_usage(const char* program_name) {
     std::cout << "Press Ctrl+C to stop the simulation.\n\n";
 }
 
+// ============================================================================
+// Determinism verification
+// ============================================================================
+
+// Generous upper bound on race length: every car at the 50 km/h speed floor
+uint64_t max_race_ticks(uint16_t laps, const TrackView& track) {
+    float seconds_per_lap = track.length / (50.0f / 3.6f);
+    return static_cast<uint64_t>(seconds_per_lap * SIMULATION_HZ) * (laps + 1ULL);
+}
+
+void print_report(const DeterminismReport& report) {
+    if (report.identical) {
+        std::cout << "  " << report.variant << ": OK (" << report.ticks_compared << " ticks)\n";
+    } else {
+        std::printf("  %s: DIVERGED at tick %" PRIu64 " (expected %016" PRIx64 ", got %016" PRIx64 ")\n",
+                    report.variant, report.first_divergent_tick,
+                    report.expected_hash, report.actual_hash);
+    }
+}
+
+int run_determinism_check(const SimulationConfig& config, const SeasonData* season) {
+    std::cout << "Verifying determinism (seed " << config.seed << ", "
+              << config.laps << " laps, " << config.track.name << ", "
+              << (season ? config.season_file : "built-in profiles") << ")...\n";
+    
+    DeterminismHarness harness(config.seed, config.laps, max_race_ticks(config.laps, config.track), config.track);
+    if (season) {
+        harness.set_profiles(season->driver_profiles(), season->car_profiles());
+    }
+    uint64_t ticks = harness.record_reference();
+    std::printf("  reference: %" PRIu64 " ticks, final hash %016" PRIx64 "\n",
+                ticks, ticks ? harness.reference().back() : 0);
+    
+    std::array<DeterminismReport, 4> reports = {
+        harness.verify_repeat(),
+        harness.verify_checkpoint_restore(ticks / 2),
+        harness.verify_strategy_workers(0, "strategy-serial"),
+        harness.verify_strategy_workers(8, "strategy-8-workers")
+    };
+    
+    bool all_identical = true;
+    for (const auto& report : reports) {
+        print_report(report);
+        all_identical = all_identical && report.identical;
+    }
+    return all_identical ? 0 : 1;
+}
+
+bool write_hash_log(const std::string& path, const StateHashTrace& trace) {
+    std::ofstream out(path);
+    if (!out) return false;
+    
+    char line[64];
+    const auto& hashes = trace.hashes();
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        std::snprintf(line, sizeof(line), "%zu %016" PRIx64 "\n", i + 1, hashes[i]);
+        out << line;
+    }
+    return static_cast<bool>(out);
+}
+
+// ============================================================================
+// Replay
+// ============================================================================
+
+std::string format_race_time(uint32_t ms) {
+    const uint32_t seconds = ms / 1000;
+    char text[32];
+    if (seconds >= 3600) {
+        std::snprintf(text, sizeof(text), "%u:%02u:%02u", seconds / 3600, seconds / 60 % 60, seconds % 60);
+    } else {
+        std::snprintf(text, sizeof(text), "%u:%02u", seconds / 60, seconds % 60);
+    }
+    return text;
+}
+
+// Index lookup for a lap or stint target; false if the race has no such point
+bool find_replay_target(const RecordingIndex& index, const ReplayTarget& target, RecordingPosition& position) {
+    switch (target.kind) {
+        case ReplayTarget::Kind::Time:
+            position.timestamp_ms = target.time_ms;
+            return true;
+        case ReplayTarget::Kind::Lap:
+            return index.lap_start(target.number, position, target.driver);
+        case ReplayTarget::Kind::Stint:
+            return index.stint_start(target.driver, static_cast<uint8_t>(target.number), position);
+    }
+    return false;
+}
+
+int run_replay(const SimulationConfig& config) {
+    RingBuffer<TelemetryFrame> ring_buffer;
+    std::atomic<bool> stop_flag{false};
+    ReplaySource replay(ring_buffer, stop_flag);
+    
+    std::string error;
+    if (!replay.open(config.replay_path, error)) {
+        std::cerr << "Failed to open replay: " << error << "\n";
+        return 1;
+    }
+    replay.set_speed(config.replay_speed);
+    
+    // Laps and stints need the sidecar index; rebuild it if it's missing or stale
+    const ReplayTarget& target = config.replay_from;
+    if (target.kind != ReplayTarget::Kind::Time && replay.index().empty()) {
+        std::cout << "Indexing " << config.replay_path << "...\n";
+        if (!replay.rebuild_index(error)) {
+            std::cerr << "Warning: index not saved: " << error << "\n";
+        }
+    }
+    RecordingPosition start;
+    if (!find_replay_target(replay.index(), target, start)) {
+        std::cerr << "The recording has no " << (target.kind == ReplayTarget::Kind::Lap ? "lap " : "stint ")
+                  << target.number << (target.driver != INDEX_RACE ? " for driver " + std::to_string(target.driver) : "")
+                  << "\n";
+        return 1;
+    }
+    if (target.kind != ReplayTarget::Kind::Time) {
+        replay.seek(start);
+    } else if (start.timestamp_ms > 0) {
+        replay.seek(start.timestamp_ms);
+    }
+    
+    const RecordingHeader& header = replay.header();
+    std::cout << "\n";
+    std::cout << "Replay " << config.replay_path << ":\n";
+    std::cout << "  • Random Seed:    " << header.seed << "\n";
+    std::cout << "  • Race Laps:      " << header.laps << "\n";
+    std::cout << "  • Track:          " << header.track_name << " (" << header.track_length << " meters)\n";
+    std::cout << "  • Duration:       " << format_race_time(replay.duration_ms())
+              << " (" << recording_encoding_name(header.encoding) << " frames)\n";
+    std::cout << "  • Speed:          " << replay.speed() << "x"
+              << (start.timestamp_ms > 0 ? ", from " + format_race_time(start.timestamp_ms) : "") << "\n";
+    std::cout << "\n";
+    
+    g_ring_buffer = &ring_buffer;
+    g_stop_flag = &stop_flag;
+    std::signal(SIGINT, signal_handler);
+    
+    TelemetryUI ui(ring_buffer, stop_flag, header.track_length > 0.0f ? header.track_length : TRACK_LENGTH);
+    ui.set_redraw_ticks(config.ui_redraw_ticks);
+    ui.set_differential(config.ui_differential);
+    SeasonData season;
+    if (load_season(config.season_file, season, error)) {
+        ui.set_roster(season.roster());
+    }
+    
+    std::thread producer_thread([&replay, &config]() {
+        apply_thread_placement(config.engine_placement, "replay");
+        replay.run();
+    });
+    std::thread consumer_thread([&ui, &config]() {
+        apply_thread_placement(config.ui_placement, "ui");
+        ui.run();
+    });
+    
+    producer_thread.join();
+    ring_buffer.shutdown();
+    consumer_thread.join();
+    
+    std::printf("\nReplay stopped at %s: %" PRIu64 " frames played\n\n",
+                format_race_time(replay.position_ms()).c_str(), replay.frames_played());
+    return 0;
+}
+
+// ============================================================================
+// Export
+// ============================================================================
+
+int run_export(SimulationConfig config) {
+    RecordingReader reader;
+    std::string error;
+    if (!reader.open(config.export_path, error)) {
+        std::cerr << "Failed to open recording " << config.export_path << ": " << error << "\n";
+        return 1;
+    }
+    
+    ExportOptions& options = config.export_options;
+    std::string& out_path = config.export_to;
+    if (!config.export_format_set && !out_path.empty() && !export_format_from_path(out_path, options.format)) {
+        options.format = ExportFormat::Csv;
+    }
+    if (out_path.empty()) {
+        out_path = std::filesystem::path(config.export_path).replace_extension(export_format_name(options.format));
+    }
+    
+    // Chunks of blocks decoded and formatted on every thread, this one included
+    size_t threads = config.export_threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    ThreadPool pool(threads - 1);
+    
+    const auto start = std::chrono::steady_clock::now();
+    ParallelExportStats stats;
+    const ExportLayout layout = config.export_parts ? ExportLayout::Parts : ExportLayout::Single;
+    if (!export_recording(reader, pool, options, out_path, layout, stats, error)) {
+        std::cerr << "Failed to export: " << error << "\n";
+        return 1;
+    }
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("Exported %" PRIu64 " frames to %s (%s, %.1f MB) in %.2f s on %zu threads\n", stats.frames,
+                config.export_parts ? export_part_path(out_path, 0).c_str() : out_path.c_str(),
+                export_format_name(options.format).data(), static_cast<double>(stats.bytes) / 1e6, seconds, threads);
+    if (config.export_parts && stats.parts > 1) {
+        std::printf("  ... %zu parts, through %s\n", stats.parts, export_part_path(out_path, stats.parts - 1).c_str());
+    }
+    return 0;
+}
+
+// ============================================================================
+// Recovery
+// ============================================================================
+
+int run_recover(const SimulationConfig& config) {
+    std::vector<std::string> paths = {config.recover_path};
+    if (!std::filesystem::exists(config.recover_path)) {
+        paths = find_recording_segments(config.recover_path);
+        if (paths.empty()) {
+            std::cerr << "No recording or segments at " << config.recover_path << "\n";
+            return 1;
+        }
+    }
+    
+    int status = 0;
+    for (const std::string& path : paths) {
+        RecoveryStats stats;
+        std::string error;
+        if (!recover_recording(path, stats, error)) {
+            std::cerr << path << ": " << error << "\n";
+            status = 1;
+            continue;
+        }
+        std::printf("%s: %" PRIu64 " blocks, %" PRIu64 " frames intact", path.c_str(), stats.blocks, stats.frames);
+        if (stats.bytes_after < stats.bytes_before) {
+            std::printf(", truncated %.1f KB of torn tail\n",
+                        static_cast<double>(stats.bytes_before - stats.bytes_after) / 1e3);
+        } else {
+            std::printf("\n");
+        }
+    }
+    return status;
+}
+
+// ============================================================================
+// Tick timing report
+// ============================================================================
+
+void print_recording_report(const std::string& path, RecordingEncoding encoding,
+                            const RecorderStats& stats, uint64_t dropped) {
+    using micros = std::chrono::duration<double, std::micro>;
+    
+    std::printf("Recording %s (%s, %s, %s):\n", path.c_str(), recording_encoding_name(encoding).data(),
+                write_backend_name(stats.io.backend).data(), stats.io.direct_io ? "direct I/O" : "buffered");
+    std::printf("  %" PRIu64 " frames in %" PRIu64 " blocks, %.1f MB in %" PRIu64 " writes\n",
+                stats.frames, stats.blocks, static_cast<double>(stats.io.bytes) / 1e6, stats.io.writes);
+    std::printf("  blocked  total %8.1f us   max %8.1f us   cpu %.1f ms\n",
+                micros(stats.io.wait_total).count(), micros(stats.io.wait_max).count(),
+                std::chrono::duration<double, std::milli>(stats.cpu_time).count());
+    if (dropped > 0) {
+        std::printf("  dropped  %" PRIu64 " frames (recorder fell behind)\n", dropped);
+    }
+    if (stats.io.error != 0) {
+        std::printf("  write failed: %s (recording truncated)\n", std::strerror(stats.io.error));
+    }
+    if (stats.segments.segments > 0) {
+        std::printf("  segments %" PRIu32 " written (%s to %s), %" PRIu32 " deleted, longest rotation %.1f us\n",
+                    stats.segments.segments, recording_segment_path(path, 0).c_str(),
+                    recording_segment_path(path, stats.segments.segments - 1).c_str(), stats.segments.deleted,
+                    std::chrono::duration<double, std::micro>(stats.rotate_max).count());
+        if (stats.segments.replaced > 0) {
+            std::printf("  replaced %" PRIu32 " segments of an earlier recording\n", stats.segments.replaced);
+        }
+        if (stats.segments.error != 0) {
+            std::printf("  segment create failed: %s (kept writing the last one)\n",
+                        std::strerror(stats.segments.error));
+        }
+        if (stats.index_bytes > 0) {
+            std::printf("  index    one per segment (%.1f KB in all)\n", static_cast<double>(stats.index_bytes) / 1e3);
+        }
+    } else if (stats.index_bytes > 0) {
+        std::printf("  index    %s (%.1f KB)\n", recording_index_path(path).c_str(),
+                    static_cast<double>(stats.index_bytes) / 1e3);
+    }
+}
+
+void print_strategy_report(const StrategyStats& stats) {
+    using micros = std::chrono::duration<double, std::micro>;
+    
+    if (stats.solves == 0) return;
+    
+    std::printf("Pit strategy (%" PRIu64 " solves):\n", stats.solves);
+    std::printf("  solve    avg %8.1f us   max %8.1f us\n",
+                micros(stats.total).count() / static_cast<double>(stats.solves),
+                micros(stats.max).count());
+    if (stats.over_budget > 0) {
+        std::printf("  over budget %" PRIu64 " (> %" PRId64 " us)\n", stats.over_budget,
+                    static_cast<int64_t>(DEFAULT_STRATEGY_BUDGET.count()));
+    }
+}
+
+void print_timing_report(const TickTimingStats& stats, OverrunPolicy policy) {
+    using micros = std::chrono::duration<double, std::micro>;
+    
+    if (stats.ticks == 0) return;
+    
+    double ticks = static_cast<double>(stats.ticks);
+    std::printf("Tick timing (%" PRIu64 " ticks, policy: %s):\n",
+                stats.ticks, overrun_policy_name(policy).data());
+    std::printf("  compute  avg %8.1f us   max %8.1f us\n",
+                micros(stats.compute_total).count() / ticks, micros(stats.compute_max).count());
+    std::printf("  push     avg %8.1f us   max %8.1f us\n",
+                micros(stats.push_total).count() / ticks, micros(stats.push_max).count());
+    std::printf("  slack    min %8.1f us\n", micros(stats.slack_min).count());
+    std::printf("  overruns %" PRIu64 " (%.3f%%), worst %.1f us\n",
+                stats.overruns, 100.0 * static_cast<double>(stats.overruns) / ticks,
+                micros(stats.overrun_max).count());
+    
+    if (stats.dropped_ticks > 0) {
+        std::printf("  dropped  %" PRIu64 " wall-clock slots\n", stats.dropped_ticks);
+    }
+    if (stats.slow_motion_slip.count() > 0) {
+        std::printf("  slip     %.1f ms behind real time\n",
+                    std::chrono::duration<double, std::milli>(stats.slow_motion_slip).count());
+    }
+    
+    for (size_t b = 0; b < TickTimingStats::HISTOGRAM_BUCKETS; ++b) {
+        if (stats.overrun_histogram[b] == 0) continue;
+        std::printf("    >= %8" PRIu64 " us : %" PRIu64 "\n",
+                    TickTimingStats::bucket_floor_us(b), stats.overrun_histogram[b]);
+    }
+}
+
 // ============================================================================
 // Main Entry Point
 // ============================================================================
@@ -93,6 +778,77 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Custom circuits outlive everything that holds a view of them
+    std::unique_ptr<LoadedTrack> loaded_track;
+    if (!config.track_file.empty()) {
+        std::string error;
+        loaded_track = LoadedTrack::load(config.track_file, error);
+        if (!loaded_track) {
+            std::cerr << "Failed to load track: " << error << "\n";
+            return 1;
+        }
+        config.track = loaded_track->view();
+    }
+    
+    if (!config.recover_path.empty()) {
+        return run_recover(config);
+    }
+    
+    if (!config.replay_path.empty()) {
+        return run_replay(config);
+    }
+    
+    if (!config.export_path.empty()) {
+        return run_export(config);
+    }
+    
+    SeasonData season;
+    bool season_loaded = false;
+    {
+        std::string error;
+        season_loaded = load_season(config.season_file, season, error);
+        if (!season_loaded && config.season_file_given) {
+            std::cerr << "Failed to load season: " << error << "\n";
+            return 1;
+        }
+    }
+    
+    // Checks the race as it would run: same track, same season profiles
+    if (config.verify_determinism) {
+        return run_determinism_check(config, season_loaded ? &season : nullptr);
+    }
+    
+    // Created before the race starts so a bad path fails fast; the recorder
+    // drains its own tap, never the UI's ring
+    std::unique_ptr<TelemetryTap> recorder_tap;
+    std::unique_ptr<CompactTelemetryTap> compact_tap;  // --record-format compact
+    std::unique_ptr<TelemetryRecorder> recorder;
+    if (!config.record_path.empty()) {
+        RecordingHeader header;
+        header.seed = config.seed;
+        header.laps = config.laps;
+        header.sim_hz = static_cast<uint16_t>(SIMULATION_HZ);
+        header.track_length = config.track.length;
+        header.set_track_name(config.track.name);
+        header.encoding = config.record_encoding;
+        
+        std::string error;
+        if (config.record_encoding == RecordingEncoding::Compact) {
+            compact_tap = std::make_unique<CompactTelemetryTap>();
+            recorder = std::make_unique<TelemetryRecorder>(*compact_tap);
+        } else {
+            recorder_tap = std::make_unique<TelemetryTap>();
+            recorder = std::make_unique<TelemetryRecorder>(*recorder_tap);
+        }
+        if (!recorder->open(config.record_path, header, error, config.record_backend, config.record_segments)) {
+            std::cerr << "Failed to start recording: " << error << "\n";
+            if (config.record_segments.enabled() && !config.record_segments.overwrite) {
+                std::cerr << "  (--record-overwrite replaces an earlier run's segments)\n";
+            }
+            return 1;
+        }
+    }
+    
     // Display startup info
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════════════════╗\n";
@@ -105,7 +861,12 @@ int main(int argc, char* argv[]) {
     std::cout << "  • Race Laps:      " << config.laps << "\n";
     std::cout << "  • Drivers:        " << NUM_DRIVERS << "\n";
     std::cout << "  • Physics Rate:   50 Hz (20ms per tick)\n";
-    std::cout << "  • Track Length:   " << TRACK_LENGTH << " meters\n";
+    std::cout << "  • Track:          " << config.track.name << " (" << config.track.length << " meters)\n";
+    std::cout << "  • Profiles:       " << (season_loaded ? config.season_file : "built-in") << "\n";
+    if (recorder) {
+        std::cout << "  • Recording:      " << config.record_path
+                  << (config.record_segments.enabled() ? " (segmented)" : "") << "\n";
+    }
     std::cout << "\n";
     std::cout << "Starting simulation in 2 seconds...\n";
     std::this_thread::sleep_for(std::chrono::seconds(2));
@@ -121,15 +882,69 @@ int main(int argc, char* argv[]) {
     std::signal(SIGINT, signal_handler);
     
     // Create engine and UI
-    RaceEngine engine(ring_buffer, stop_flag, config.seed, config.laps);
-    TelemetryUI ui(ring_buffer, stop_flag);
+    RaceEngine engine(ring_buffer, stop_flag, config.seed, config.laps, config.track);
+    TelemetryUI ui(ring_buffer, stop_flag, config.track.length);
+    ui.set_redraw_ticks(config.ui_redraw_ticks);
+    ui.set_differential(config.ui_differential);
+    engine.set_overrun_policy(config.overrun_policy);
+    engine.set_strategy_workers(config.strategy_workers, config.engine_placement);
+    if (recorder) {
+        if (compact_tap) {
+            engine.set_telemetry_tap(compact_tap.get());
+        } else {
+            engine.set_telemetry_tap(recorder_tap.get());
+        }
+        recorder->start();
+    }
+    
+    // Season profiles go through the same staging as live edits: the engine
+    // picks them up at its first tick
+    if (season_loaded) {
+        engine.set_profiles(season.driver_profiles(), season.car_profiles());
+        ui.set_roster(season.roster());
+    }
+    
+    // Reparse on the watcher thread; a file that fails to parse is ignored
+    FileWatcher season_watcher(config.season_file, [&engine, &ui, &config]() {
+        SeasonData reloaded;
+        std::string error;
+        if (load_season(config.season_file, reloaded, error)) {
+            engine.set_profiles(reloaded.driver_profiles(), reloaded.car_profiles());
+            ui.set_roster(reloaded.roster());
+        }
+    });
+    StateHashTrace hash_trace(config.hash_log_path.empty() ? 0 : max_race_ticks(config.laps, config.track));
+    if (!config.hash_log_path.empty()) {
+        engine.set_hash_trace(&hash_trace);
+    }
+    
+    // Fault in everything the hot loops touch before they start
+    if (config.lock_memory) {
+        lock_process_memory();
+        prefault(&ring_buffer, sizeof(ring_buffer));
+        prefault(&engine, sizeof(engine));
+        prefault(&ui, sizeof(ui));
+    }
+    
+    // Only once the prefault above is done: it rewrites bytes of the
+    // engine's and UI's staging a reload writes to
+    if (season_loaded && config.watch_season) {
+        std::string error;
+        if (!season_watcher.start(error)) {
+            std::cerr << "Season reload disabled: " << error << "\n";
+        }
+    }
     
     // Launch threads
-    std::thread producer_thread([&engine]() {
+    std::thread producer_thread([&engine, &config]() {
+        apply_thread_placement(config.engine_placement, "engine");
+        if (config.lock_memory) prefault_stack();
         engine.run();
     });
     
-    std::thread consumer_thread([&ui]() {
+    std::thread consumer_thread([&ui, &config]() {
+        apply_thread_placement(config.ui_placement, "ui");
+        if (config.lock_memory) prefault_stack();
         ui.run();
     });
     
@@ -139,10 +954,24 @@ int main(int argc, char* argv[]) {
     // Ensure ring buffer is shut down and consumer wakes up
     ring_buffer.shutdown();
     consumer_thread.join();
+    if (recorder) {
+        recorder->finish();
+    }
     
     // Cleanup
     std::cout << "\nSimulation complete!\n";
-    std::cout << "Seed used: " << config.seed << " (use this seed to replay exact race)\n\n";
+    std::cout << "Seed used: " << config.seed << " (use this seed to replay exact race)\n";
+    std::printf("Final state hash: %016" PRIx64 "\n\n", engine.state_hash());
+    print_timing_report(engine.timing_stats(), config.overrun_policy);
+    print_strategy_report(engine.strategy_stats());
+    if (recorder) {
+        print_recording_report(config.record_path, config.record_encoding, recorder->stats(), engine.tap_dropped());
+    }
+    std::cout << "\n";
+    
+    if (!config.hash_log_path.empty() && !write_hash_log(config.hash_log_path, hash_trace)) {
+        std::cerr << "Failed to write hash log: " << config.hash_log_path << "\n";
+    }
     
     return 0;
 }
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace f1sim {
+
+/**
+ * @brief Read-only memory mapping of a whole file (RAII)
+ *
+ * The mapping stays valid for the lifetime of the object, so views into it
+ * (track tables, telemetry frames) can be handed out without copying.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file read-only
+     * @param advice madvise() hint for the access pattern (e.g. MADV_SEQUENTIAL)
+     * @return false if the file cannot be opened or mapped (an empty file maps
+     *         successfully with size() == 0)
+     */
+    bool open(const std::string& path, int advice = MADV_NORMAL) {
+        close();
+        
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return false;
+        
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return false;
+            }
+            data_ = static_cast<const uint8_t*>(addr);
+            madvise(const_cast<uint8_t*>(data_), size_, advice);
+        }
+        
+        ::close(fd);  // The mapping keeps its own reference
+        return true;
+    }
+
+    void close() {
+        if (data_) {
+            munmap(const_cast<uint8_t*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Start reading [offset, offset + bytes) from disk in the background
+     *        (MADV_WILLNEED), so later accesses don't fault page by page
+     */
+    void prefetch(size_t offset, size_t bytes) const {
+        if (!data_ || offset >= size_) return;
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t start = offset & ~(page - 1);
+        const size_t end = std::min(offset + bytes, size_);
+        madvise(const_cast<uint8_t*>(data_) + start, end - start, MADV_WILLNEED);
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace f1sim
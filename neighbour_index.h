@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace f1sim {
+
+// ============================================================================
+// On-Track Neighbour Index
+// ============================================================================
+
+/**
+ * @brief Per-tick "who is around me on track" structure
+ *
+ * Answers, in O(1) per car: the car physically ahead (lap-wrapped, so a
+ * backmarker a lap down still counts), the gap to it and to the car behind
+ * in meters, and how many cars are within a fixed radius ahead. Interaction
+ * models (slipstream, dirty air, DRS) query this instead of scanning all
+ * pairs.
+ *
+ * build() keeps cars in ascending lap-distance order and re-sorts that order
+ * with an insertion sort each tick. Cars move a metre or two per tick, so the
+ * previous tick's order is already almost sorted and the sort is close to
+ * O(n); the first build is seeded from the race order the caller already has.
+ * A two-pointer sweep around the circle then fills the radius counts in O(n).
+ *
+ * @tparam MaxCars Capacity (car ids must be < MaxCars)
+ */
+template <size_t MaxCars>
+class NeighbourIndex {
+    static_assert(MaxCars < std::numeric_limits<uint16_t>::max(), "Car ids are stored as uint16_t");
+
+public:
+    static constexpr uint16_t NO_CAR = std::numeric_limits<uint16_t>::max();
+
+    /**
+     * @brief Rebuild for this tick
+     * @param cars          Ids of the cars on track, in race order (leader first)
+     * @param count         Number of entries in cars
+     * @param lap_distance  Lap-wrapped distance in [0, track_length), indexed by car id
+     * @param track_length  Lap length in meters
+     * @param radius        Look-ahead radius for count_within()
+     */
+    void build(const uint16_t* cars, size_t count, const float* lap_distance,
+               float track_length, float radius) {
+        if (count != count_ || !same_members(cars, count)) {
+            seed_order(cars, count);
+        }
+        count_ = count;
+        
+        // Insertion sort by lap distance; near-linear on last tick's order
+        for (size_t i = 1; i < count; ++i) {
+            uint16_t car = order_[i];
+            float d = lap_distance[car];
+            size_t j = i;
+            while (j > 0 && lap_distance[order_[j - 1]] > d) {
+                order_[j] = order_[j - 1];
+                --j;
+            }
+            order_[j] = car;
+        }
+        
+        for (size_t k = 0; k < count; ++k) {
+            uint16_t car = order_[k];
+            uint16_t next = order_[(k + 1) % count];
+            uint16_t prev = order_[(k + count - 1) % count];
+            
+            ahead_[car] = count > 1 ? next : NO_CAR;
+            behind_[car] = count > 1 ? prev : NO_CAR;
+            gap_ahead_[car] = count > 1 ? wrap(lap_distance[next] - lap_distance[car], track_length)
+                                        : std::numeric_limits<float>::infinity();
+            gap_behind_[car] = count > 1 ? wrap(lap_distance[car] - lap_distance[prev], track_length)
+                                         : std::numeric_limits<float>::infinity();
+        }
+        
+        // Two-pointer sweep: j is one past the furthest car within radius of order_[k]
+        size_t j = 1;
+        for (size_t k = 0; k < count; ++k) {
+            if (j < k + 1) j = k + 1;
+            while (j < k + count &&
+                   wrap(lap_distance[order_[j % count]] - lap_distance[order_[k]], track_length) <= radius) {
+                ++j;
+            }
+            within_[order_[k]] = static_cast<uint16_t>(j - k - 1);
+        }
+    }
+
+    uint16_t ahead(size_t car) const { return ahead_[car]; }
+    uint16_t behind(size_t car) const { return behind_[car]; }
+    float gap_ahead(size_t car) const { return gap_ahead_[car]; }      // meters
+    float gap_behind(size_t car) const { return gap_behind_[car]; }    // meters
+    uint16_t count_within(size_t car) const { return within_[car]; }   // cars ahead within radius
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Visit the cars within radius ahead of `car`, nearest first (O(k))
+     */
+    template <typename Fn>
+    void for_each_within(size_t car, Fn&& fn) const {
+        uint16_t other = ahead_[car];
+        for (uint16_t i = 0; i < within_[car]; ++i) {
+            fn(other);
+            other = ahead_[other];
+        }
+    }
+
+private:
+    static float wrap(float delta, float track_length) {
+        return delta < 0.0f ? delta + track_length : delta;
+    }
+
+    bool same_members(const uint16_t* cars, size_t count) {
+        // Cars join and leave rarely (pit lane, DNF): a cheap generation
+        // check avoids re-seeding on every tick
+        generation_++;
+        for (size_t i = 0; i < count; ++i) {
+            seen_[cars[i]] = generation_;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (seen_[order_[i]] != generation_) return false;
+        }
+        return true;
+    }
+
+    void seed_order(const uint16_t* cars, size_t count) {
+        // Race order is descending total distance; cars on the same lap are
+        // then in descending lap distance, so reversing it gives runs that are
+        // already ascending and the insertion sort only has to merge laps
+        for (size_t i = 0; i < count; ++i) {
+            order_[i] = cars[count - 1 - i];
+        }
+    }
+
+    size_t count_ = 0;
+    uint32_t generation_ = 0;
+    std::array<uint16_t, MaxCars> order_{};    // Car ids by ascending lap distance
+    std::array<uint32_t, MaxCars> seen_{};
+    std::array<uint16_t, MaxCars> ahead_{};
+    std::array<uint16_t, MaxCars> behind_{};
+    std::array<float, MaxCars> gap_ahead_{};
+    std::array<float, MaxCars> gap_behind_{};
+    std::array<uint16_t, MaxCars> within_{};
+};
+
+} // namespace f1sim
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace f1sim {
+
+// ============================================================================
+// Pit Lane
+// ============================================================================
+
+constexpr float PIT_BOX_SPACING_M = 12.0f;  // Garage frontage per team along the lane
+
+/**
+ * @brief Cars currently off the racing line: driving the lane at the limiter
+ *        or standing in their box
+ *
+ * The engine moves a car in here when it turns in at the pit entry, so the
+ * on-track physics loop never sees it. Two compact structures cover the lane:
+ *
+ * - movers: cars driving in or out, a contiguous array advanced in one tight
+ *   loop (everyone runs at the same limiter speed)
+ * - stopped: cars standing in a box, a min-heap keyed on the tick they are
+ *   released, so a tick only touches the cars that actually leave
+ *
+ * Teammates share a box (car / 2, like the team tables). A car arriving while
+ * its teammate is still being serviced queues behind it: its release is
+ * scheduled from the moment the box frees up. Everything is O(1) or
+ * O(log stopped) per car and per event, so a whole field pitting on the same
+ * lap costs no more than the cars involved.
+ *
+ * @tparam MaxCars Capacity (car ids must be < MaxCars)
+ */
+template <size_t MaxCars>
+class PitLane {
+public:
+    static constexpr size_t NUM_BOXES = (MaxCars + 1) / 2;
+
+    struct Mover {
+        float target;       // Race distance to stop at (box) or leave the lane (exit)
+        float exit;         // Race distance of the lane exit
+        uint16_t car;
+        bool outbound;      // Serviced, heading for the exit
+    };
+
+    struct Stop {
+        uint64_t release_tick;
+        float exit;
+        uint16_t car;
+    };
+
+    void reset() {
+        mover_count_ = 0;
+        stop_count_ = 0;
+        box_free_tick_.fill(0);
+    }
+
+    size_t size() const { return mover_count_ + stop_count_; }
+    size_t mover_count() const { return mover_count_; }
+    size_t stop_count() const { return stop_count_; }
+    Mover& mover(size_t i) { return movers_[i]; }
+    const Stop& stop(size_t i) const { return stops_[i]; }
+
+    static size_t box_of(uint16_t car) { return car / 2; }
+
+    /**
+     * @brief A car turned in at the entry
+     * @param box_distance   Race distance of its box
+     * @param exit_distance  Race distance of the lane exit
+     */
+    void enter(uint16_t car, float box_distance, float exit_distance) {
+        movers_[mover_count_++] = Mover{box_distance, exit_distance, car, false};
+    }
+
+    /**
+     * @brief Mover `i` reached its box: queue it for `service_ticks` once the
+     *        box is free. Mover `i` is replaced by the last mover.
+     * @return Tick at which it will be released
+     */
+    uint64_t stop_mover(size_t i, uint64_t now_tick, uint64_t service_ticks) {
+        const Mover m = movers_[i];
+        remove_mover(i);
+
+        auto& box_free = box_free_tick_[box_of(m.car)];
+        const uint64_t release = std::max(now_tick, box_free) + service_ticks;
+        box_free = release;
+
+        stops_[stop_count_++] = Stop{release, m.exit, m.car};
+        std::push_heap(stops_.begin(), stops_.begin() + stop_count_, later);
+        return release;
+    }
+
+    /**
+     * @brief Mover `i` left the lane; it is replaced by the last mover
+     */
+    void remove_mover(size_t i) {
+        movers_[i] = movers_[--mover_count_];
+    }
+
+    /**
+     * @brief Release every car whose service ends at or before `now_tick`;
+     *        they become outbound movers. fn(car) is called for each.
+     */
+    template <typename Fn>
+    void release_due(uint64_t now_tick, Fn&& fn) {
+        while (stop_count_ > 0 && stops_[0].release_tick <= now_tick) {
+            std::pop_heap(stops_.begin(), stops_.begin() + stop_count_, later);
+            const Stop s = stops_[--stop_count_];
+            movers_[mover_count_++] = Mover{s.exit, s.exit, s.car, true};
+            fn(s.car);
+        }
+    }
+
+private:
+    // Min-heap on release tick; car id breaks ties so release order never
+    // depends on heap layout
+    static bool later(const Stop& a, const Stop& b) {
+        return a.release_tick != b.release_tick ? a.release_tick > b.release_tick : a.car > b.car;
+    }
+
+    size_t mover_count_ = 0;
+    size_t stop_count_ = 0;
+    std::array<Mover, MaxCars> movers_{};
+    std::array<Stop, MaxCars> stops_{};
+    std::array<uint64_t, NUM_BOXES> box_free_tick_{};
+};
+
+} // namespace f1sim
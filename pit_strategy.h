@@ -0,0 +1,220 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include "track_model.h"
+#include "thread_pool.h"
+#include "realtime.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Pit Strategy Solver
+// ============================================================================
+
+constexpr size_t STRATEGY_MAX_LAPS = 256;  // Longest horizon planned; DP tables live on the stack
+constexpr float STRATEGY_MIN_SPEED_KMH = 50.0f;  // Matches the physics floor
+
+/**
+ * @brief What the solver needs to know about one car, snapshotted by the engine
+ */
+struct StrategyCar {
+    float base_speed;        // km/h on fresh tires
+    float wear_per_second;   // Tire wear rate
+    float corner_grip;       // Fraction of segment speed limits this car reaches
+    float pit_duration;      // Stationary service time (seconds)
+    float tire_wear;         // Current wear (0-1)
+    float lap_left;          // Fraction of the current lap still to drive (0-1]
+    uint16_t current_lap;
+    uint16_t laps_remaining; // Including the current lap
+    bool can_stop_this_lap;  // Pit entry still ahead on the current lap
+    bool in_pits;            // Being serviced now: plans start on fresh tires
+};
+
+/**
+ * @brief Fastest plan found for one car
+ */
+struct StrategyPlan {
+    float expected_time = 0.0f;  // Seconds to the flag
+    uint16_t pit_lap = 0;        // Lap on which to turn in next, 0 = run to the flag
+    uint8_t stops = 0;           // Stops still to make, including that one
+    bool valid = false;          // False until a solve has covered this car
+};
+
+/**
+ * @brief Solver counters, for the end-of-race report
+ */
+struct StrategyStats {
+    uint64_t solves = 0;
+    uint64_t over_budget = 0;    // Solves that took longer than the budget
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+};
+
+/**
+ * @brief Minimum-race-time pit plans via dynamic programming over laps
+ *
+ * Lap times come from the same model the physics loop runs: tire wear scales
+ * the car's straight-line speed, and each metre of track caps it at the
+ * segment limit times the car's corner grip. The track's per-metre limits are
+ * sorted once with a prefix sum of their inverses, so the time for a whole
+ * lap at a given speed is one binary search.
+ *
+ * Per car the solver builds the cumulative time of k laps on the current
+ * tires and on a fresh set, then runs
+ *
+ *     best[l] = min over k of fresh[k] + (l + k < R ? pit_loss + best[l + k] : 0)
+ *
+ * from the flag backwards. The first stint (current tires) picks the stop lap;
+ * the stop count falls out of following the chosen stints. O(R²) per car.
+ *
+ * Cars are independent, so solve() fans them out across a thread pool.
+ * Every solve plans every car: the plans steer pit stops, so which cars get
+ * one must never depend on the wall clock. The time budget only counts the
+ * solves that ran over it.
+ */
+class StrategySolver {
+public:
+    // Workers run with `placement`: the physics thread blocks on them, so
+    // they need its CPU and scheduling class
+    StrategySolver(TrackView track, size_t workers, const ThreadPlacement& placement = {})
+        : track_(track)
+        , pool_(workers, [placement] { apply_thread_placement(placement, "strategy"); })
+    {
+        // Per-metre limits in m/s, ascending, with prefix sums of 1/limit
+        limits_.reserve(track_.sample_count);
+        for (size_t i = 0; i < track_.sample_count; ++i) {
+            limits_.push_back(track_.samples[i].speed_limit / 3.6f);
+        }
+        std::sort(limits_.begin(), limits_.end());
+
+        inverse_prefix_.resize(limits_.size() + 1);
+        inverse_prefix_[0] = 0.0;
+        for (size_t i = 0; i < limits_.size(); ++i) {
+            inverse_prefix_[i + 1] = inverse_prefix_[i] + 1.0 / std::max(limits_[i], 1.0f);
+        }
+    }
+
+    size_t workers() const { return pool_.workers(); }
+
+    /**
+     * @brief Plan every car; a solve taking longer than `budget` (0 = no
+     *        budget) is counted in stats().over_budget
+     * @return Number of cars planned (always `count`)
+     */
+    size_t solve(const StrategyCar* cars, size_t count, StrategyPlan* plans,
+                 std::chrono::microseconds budget) {
+        const auto start = ThreadPool::clock::now();
+
+        size_t solved = pool_.parallel_for(count, [&](size_t i) {
+            plans[i] = plan_car(cars[i]);
+        });
+
+        const auto elapsed = ThreadPool::clock::now() - start;
+        stats_.solves++;
+        if (budget.count() > 0 && elapsed > budget) stats_.over_budget++;
+        stats_.total += elapsed;
+        stats_.max = std::max<std::chrono::nanoseconds>(stats_.max, elapsed);
+        return solved;
+    }
+
+    const StrategyStats& stats() const { return stats_; }
+
+    /**
+     * @brief Seconds to cover one lap at `speed_kmh` with `grip`
+     */
+    double lap_time(float speed_kmh, float grip) const {
+        const float v = std::max(speed_kmh, STRATEGY_MIN_SPEED_KMH) / 3.6f;
+        // Metres where the car is limited by the track: grip × limit < v
+        const size_t k = static_cast<size_t>(
+            std::lower_bound(limits_.begin(), limits_.end(), v / grip) - limits_.begin());
+        const double seconds = inverse_prefix_[k] / grip + static_cast<double>(limits_.size() - k) / v;
+        return seconds / TRACK_SAMPLES_PER_METER;
+    }
+
+    StrategyPlan plan_car(const StrategyCar& car) const {
+        const size_t laps = std::min<size_t>(car.laps_remaining, STRATEGY_MAX_LAPS);
+        StrategyPlan plan;
+        plan.valid = true;
+        if (laps == 0) {
+            return plan;
+        }
+
+        // Cumulative time for k laps on the current tires and on fresh ones
+        std::array<double, STRATEGY_MAX_LAPS + 1> current{};
+        std::array<double, STRATEGY_MAX_LAPS + 1> fresh{};
+        stint_times(car, car.in_pits ? 0.0f : car.tire_wear, car.lap_left, laps, current.data());
+        stint_times(car, 0.0f, 1.0f, laps, fresh.data());
+
+        // Lane transit plus service, minus the track it bypasses
+        const PitLaneSpec& lane = track_.pit_lane;
+        const double pit_loss = lane.length / (lane.speed_limit / 3.6) + car.pit_duration
+                              - lane.length / track_.length * fresh[1];
+
+        // best[l]: fastest way to cover laps l..laps-1 starting on fresh tires
+        std::array<double, STRATEGY_MAX_LAPS + 1> best{};
+        std::array<uint16_t, STRATEGY_MAX_LAPS + 1> stint{};
+        best[laps] = 0.0;
+        for (size_t l = laps; l-- > 0;) {
+            best[l] = std::numeric_limits<double>::infinity();
+            for (size_t k = 1; l + k <= laps; ++k) {
+                double t = fresh[k] + (l + k < laps ? pit_loss + best[l + k] : 0.0);
+                if (t < best[l]) {
+                    best[l] = t;
+                    stint[l] = static_cast<uint16_t>(k);
+                }
+            }
+        }
+
+        // First stint on the current tires; stopping this lap needs the
+        // entry still ahead
+        const size_t earliest = car.can_stop_this_lap ? 1 : 2;
+        double total = current[laps];
+        size_t first = laps;
+        for (size_t k = earliest; k < laps; ++k) {
+            double t = current[k] + pit_loss + best[k];
+            if (t < total) {
+                total = t;
+                first = k;
+            }
+        }
+
+        plan.expected_time = static_cast<float>(total);
+        if (first < laps) {
+            plan.pit_lap = static_cast<uint16_t>(car.current_lap + first - 1);
+            for (size_t l = first; l < laps; l += stint[l]) {
+                plan.stops++;
+            }
+        }
+        return plan;
+    }
+
+private:
+    // out[k] = time for k laps starting at `wear`, the first of them only
+    // `first_lap` done; speed uses mid-lap wear
+    void stint_times(const StrategyCar& car, float wear, float first_lap, size_t laps, double* out) const {
+        out[0] = 0.0;
+        for (size_t k = 1; k <= laps; ++k) {
+            const double portion = k == 1 ? first_lap : 1.0;
+            double guess = portion * lap_time(car.base_speed * (1.0f - wear * TIRE_WEAR_SPEED_PENALTY), car.corner_grip);
+            float mid = std::min(wear + car.wear_per_second * static_cast<float>(guess) * 0.5f, 1.0f);
+            double t = portion * lap_time(car.base_speed * (1.0f - mid * TIRE_WEAR_SPEED_PENALTY), car.corner_grip);
+            wear = std::min(wear + car.wear_per_second * static_cast<float>(t), 1.0f);
+            out[k] = out[k - 1] + t;
+        }
+    }
+
+    TrackView track_;
+    ThreadPool pool_;
+    std::vector<float> limits_;
+    std::vector<double> inverse_prefix_;
+    StrategyStats stats_;
+};
+
+} // namespace f1sim
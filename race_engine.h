@@ -2,11 +2,23 @@
 
 #include "telemetry_data.h"
 #include "ring_buffer.h"
+#include "state_hash.h"
+#include "tick_timing.h"
+#include "track_model.h"
+#include "circuits.h"
+#include "neighbour_index.h"
+#include "timing_loops.h"
+#include "pit_lane.h"
+#include "pit_strategy.h"
+#include "recording_format.h"
 #include <random>
 #include <chrono>
 #include <thread>
 #include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
 
 namespace f1sim {
 
@@ -18,12 +30,78 @@ constexpr float SIMULATION_HZ = 50.0f;
 constexpr float DT = 1.0f / SIMULATION_HZ;  // 0.02 seconds per tick
 constexpr float BASE_SPEED_KMH = 200.0f;     // Simple constant speed for now
 
+// Car-to-car aerodynamic interactions (see update_car_physics)
+constexpr float SLIPSTREAM_RANGE_M = 40.0f;       // Tow starts inside this gap
+constexpr float SLIPSTREAM_MAX_GAIN_KMH = 8.0f;   // At zero gap, one car ahead
+constexpr float DIRTY_AIR_RANGE_M = 25.0f;        // Turbulence in corners inside this gap
+constexpr float DIRTY_AIR_MAX_LOSS = 0.05f;       // Fraction of corner speed lost at zero gap
+constexpr float DRS_DETECTION_GAP_S = 1.0f;       // Within 1s at the zone entry opens DRS
+constexpr float DRS_GAIN_KMH = 12.0f;
+constexpr uint16_t DRS_ENABLED_FROM_LAP = 3;
+
+// Pit strategy solver, re-run whenever the leader starts a lap
+constexpr size_t DEFAULT_STRATEGY_WORKERS = 2;
+constexpr uint32_t MAX_STRATEGY_WORKERS = 64;
+constexpr std::chrono::microseconds DEFAULT_STRATEGY_BUDGET{2000};  // 10% of a tick, reported only
+
 // TODO: Add realistic physics constants:
 // - Acceleration, braking, drag
 // - Tire degradation rates
 // - Fuel consumption
 // - Aerodynamic effects
 
+// ============================================================================
+// Precomputed Physics Coefficients
+// ============================================================================
+
+/**
+ * @brief Per-car physics coefficients derived from DriverProfile + CarProfile
+ *
+ * Profiles only change when someone edits them, so everything the physics
+ * loop derives from them is computed once here instead of on every tick.
+ * 20 bytes per car: the whole table for 20 cars fits in seven cache lines.
+ */
+struct CarCoefficients {
+    float base_speed;       // km/h before tire penalty (engine power × driver skill)
+    float wear_per_tick;    // Tire wear added per tick (already scaled by DT)
+    float speed_variation;  // Scale applied to the ±5 km/h random draw (1 - consistency)
+    float pit_duration;     // Stationary pit stop time (seconds)
+    float corner_grip;      // Fraction of a segment's speed limit this car can reach
+};
+
+static_assert(sizeof(CarCoefficients) == 5 * sizeof(float), "CarCoefficients should stay packed");
+
+inline CarCoefficients compute_coefficients(const DriverProfile& driver, const CarProfile& car) {
+    CarCoefficients coeff{};
+    
+    // Base wear affected by driver aggression, reduced by tire management skill
+    float wear_rate = TIRE_WEAR_BASE_RATE * (1.0f + driver.aggression * 0.5f);
+    wear_rate *= (1.0f - driver.tire_management * 0.3f);
+    coeff.wear_per_tick = wear_rate * DT;
+    
+    // Consistent drivers extract more performance from the car
+    float driver_skill = 0.80f + driver.consistency * 0.25f;  // Range: [0.80, 1.05]
+    coeff.base_speed = BASE_SPEED_KMH * car.engine_power * driver_skill;
+    
+    // Less consistent drivers have more lap-to-lap variation
+    coeff.speed_variation = 1.0f - driver.consistency;
+    
+    // Pit stop duration: 2-3 seconds based on car reliability
+    coeff.pit_duration = PIT_STOP_BASE_DURATION + (1.0f - car.reliability) * 0.5f;
+    
+    // Downforce decides how close to the limit a car can take a corner
+    coeff.corner_grip = 0.70f + car.aero_efficiency * 0.30f;
+    return coeff;
+}
+
+inline float compute_pit_threshold(const DriverProfile& driver) {
+    float threshold = 0.65f + (driver.tire_management * 0.25f);
+    // Adjust by risk tolerance: risky drivers pit later, conservative earlier
+    threshold += (driver.risk_tolerance - 0.5f) * 0.15f;
+    // Clamp to reasonable range [0.6, 0.95]
+    return std::clamp(threshold, 0.6f, 0.95f);
+}
+
 // ============================================================================
 // Race Engine - The Producer Thread
 // ============================================================================
@@ -33,16 +111,50 @@ public:
     RaceEngine(RingBuffer<TelemetryFrame>& ring_buffer, 
                std::atomic<bool>& stop_flag,
                uint32_t seed, 
-               uint16_t total_laps)
+               uint16_t total_laps,
+               TrackView track = circuits::default_track())
         : ring_buffer_(ring_buffer)
         , stop_flag_(stop_flag)
         , rng_(seed)
         , total_laps_(total_laps)
         , tick_count_(0)
+        , track_(track)
+        , strategy_(std::make_unique<StrategySolver>(track, DEFAULT_STRATEGY_WORKERS))
     {
         initialize_race();
     }
 
+    // ------------------------------------------------------------------------
+    // Live profile updates (thread-safe, callable from any thread)
+    //
+    // Updates are staged under a mutex and picked up by the physics thread at
+    // the start of the next tick, so a tick never sees a half-applied change.
+    // ------------------------------------------------------------------------
+
+    void set_driver_profile(size_t car_idx, const DriverProfile& profile) {
+        if (car_idx >= NUM_DRIVERS) return;
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        pending_driver_profiles_[car_idx] = profile;
+        stage_coefficients_locked(car_idx);
+    }
+
+    void set_car_profile(size_t car_idx, const CarProfile& profile) {
+        if (car_idx >= NUM_DRIVERS) return;
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        pending_car_profiles_[car_idx] = profile;
+        stage_coefficients_locked(car_idx);
+    }
+
+    void set_profiles(const std::array<DriverProfile, NUM_DRIVERS>& drivers,
+                      const std::array<CarProfile, NUM_DRIVERS>& cars) {
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        pending_driver_profiles_ = drivers;
+        pending_car_profiles_ = cars;
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            stage_coefficients_locked(i);
+        }
+    }
+
     // Main simulation loop (runs at 50Hz)
     void run() {
         using clock = std::chrono::steady_clock;
@@ -53,17 +165,37 @@ public:
         );
 
         while (!stop_flag_.load(std::memory_order_acquire)) {
+            const auto tick_start = clock::now();
+            
             // Update simulation
             update_simulation();
+            if (hash_trace_) {
+                hash_trace_->record(state_hash_);
+            }
+            const auto compute_end = clock::now();
             
-            // Push telemetry frames for each car to the ring buffer
+            // The taps never wait, so they get the whole tick first: a ring
+            // shut down mid-tick (Ctrl+C) must not cut the recording short of
+            // the state the final hash describes
+            std::array<TelemetryFrame, NUM_DRIVERS> frames;
             for (size_t i = 0; i < NUM_DRIVERS; ++i) {
-                TelemetryFrame frame = create_frame(i);
+                frames[i] = create_frame(i);
+                if (tap_ && !tap_->try_push(frames[i])) {
+                    tap_dropped_++;
+                }
+                if (compact_tap_ && !compact_tap_->try_push(to_compact(frames[i]))) {
+                    tap_dropped_++;
+                }
+            }
+            
+            // Push telemetry frames for each car to the ring buffer
+            for (const TelemetryFrame& frame : frames) {
                 if (!ring_buffer_.push(frame)) {
                     // Ring buffer shutdown, exit
                     return;
                 }
             }
+            const auto push_end = clock::now();
             
             // Check if race is complete
             if (is_race_complete()) {
@@ -71,12 +203,141 @@ public:
                 break;
             }
             
-            // Precise timing - sleep until next tick
+            // Deadline bookkeeping: slack is what's left of this tick's slot
             next_tick += tick_duration;
+            const auto slack = next_tick - push_end;
+            timing_.record(compute_end - tick_start, push_end - compute_end, slack);
+            
+            if (slack < clock::duration::zero()) {
+                next_tick = schedule_after_overrun(next_tick, push_end, tick_duration);
+            }
+            
+            // Precise timing - sleep until next tick
             std::this_thread::sleep_until(next_tick);
         }
     }
 
+    // ------------------------------------------------------------------------
+    // Pit strategy
+    // ------------------------------------------------------------------------
+
+    // Worker threads for the solver (0 = solve on the physics thread), placed
+    // like the physics thread
+    void set_strategy_workers(size_t workers, const ThreadPlacement& placement = {}) {
+        strategy_ = std::make_unique<StrategySolver>(track_, workers, placement);
+    }
+
+    // Solves slower than this are counted in strategy_stats(); 0 = don't count.
+    // Solves always finish, so plans never depend on load.
+    void set_strategy_budget(std::chrono::microseconds budget) { strategy_budget_ = budget; }
+
+    const StrategyPlan& pit_plan(size_t car_idx) const { return pit_plans_[car_idx]; }
+    const StrategyStats& strategy_stats() const { return strategy_->stats(); }
+
+    void set_overrun_policy(OverrunPolicy policy) { overrun_policy_ = policy; }
+    OverrunPolicy overrun_policy() const { return overrun_policy_; }
+    
+    // Producer-thread counters: read after the engine thread has finished
+    const TickTimingStats& timing_stats() const { return timing_; }
+    
+    // Second consumer of every frame (e.g. the disk recorder). The engine
+    // never waits on it: frames it has no room for are dropped and counted.
+    void set_telemetry_tap(TelemetryTap* tap) { tap_ = tap; }
+    void set_telemetry_tap(CompactTelemetryTap* tap) { compact_tap_ = tap; }  // Quantized on push
+    uint64_t tap_dropped() const { return tap_dropped_; }
+
+    // ------------------------------------------------------------------------
+    // Headless stepping, state hashing and checkpoints
+    //
+    // Used by the determinism harness: step() advances exactly one tick with
+    // no pacing and no ring buffer traffic.
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Full engine snapshot: restoring it and stepping reproduces the
+     *        original run bit-for-bit
+     */
+    struct Checkpoint {
+        RaceState state;
+        std::mt19937 rng;
+        uint64_t tick_count;
+        uint64_t state_hash;
+        std::array<uint8_t, NUM_DRIVERS> last_sector;
+        std::array<uint32_t, NUM_DRIVERS> sector_start_time;
+        std::array<uint32_t, NUM_DRIVERS> lap_start_time;
+        std::array<std::array<uint32_t, 3>, NUM_DRIVERS> current_sector_times;
+        std::array<uint32_t, NUM_DRIVERS> previous_lap_time;
+        std::array<CarCoefficients, NUM_DRIVERS> coefficients;
+        std::array<uint16_t, NUM_DRIVERS> race_order;
+        NeighbourIndex<NUM_DRIVERS> neighbours;
+        TimingLoops<NUM_DRIVERS> timing_loops;
+        PitLane<NUM_DRIVERS> pit_lane;
+        std::array<uint16_t, NUM_DRIVERS> on_track;
+        size_t on_track_count;
+        std::array<StrategyPlan, NUM_DRIVERS> pit_plans;
+        uint16_t strategy_lap;
+    };
+
+    /**
+     * @brief Advance one tick without pacing or publishing frames
+     * @return true once the race is complete
+     */
+    bool step() {
+        update_simulation();
+        if (hash_trace_) {
+            hash_trace_->record(state_hash_);
+        }
+        return is_race_complete();
+    }
+
+    uint64_t state_hash() const { return state_hash_; }
+    uint64_t tick_count() const { return tick_count_; }
+    const RaceState& state() const { return state_; }
+    const TrackView& track() const { return track_; }
+    
+    // The frame run() would publish for this car at the current tick
+    TelemetryFrame frame(size_t car_idx) const { return create_frame(car_idx); }
+
+    // Record the state hash of every tick (trace must outlive the engine run)
+    void set_hash_trace(StateHashTrace* trace) { hash_trace_ = trace; }
+
+    Checkpoint checkpoint() const {
+        return Checkpoint{state_, rng_, tick_count_, state_hash_,
+                          last_sector_, sector_start_time_, lap_start_time_,
+                          current_sector_times_, previous_lap_time_, coefficients_,
+                          race_order_, neighbours_, timing_loops_,
+                          pit_lane_, on_track_, on_track_count_,
+                          pit_plans_, strategy_lap_};
+    }
+
+    void restore(const Checkpoint& cp) {
+        state_ = cp.state;
+        rng_ = cp.rng;
+        speed_dist_.reset();
+        tick_count_ = cp.tick_count;
+        state_hash_ = cp.state_hash;
+        last_sector_ = cp.last_sector;
+        sector_start_time_ = cp.sector_start_time;
+        lap_start_time_ = cp.lap_start_time;
+        current_sector_times_ = cp.current_sector_times;
+        previous_lap_time_ = cp.previous_lap_time;
+        coefficients_ = cp.coefficients;
+        race_order_ = cp.race_order;
+        neighbours_ = cp.neighbours;
+        timing_loops_ = cp.timing_loops;
+        pit_lane_ = cp.pit_lane;
+        on_track_ = cp.on_track;
+        on_track_count_ = cp.on_track_count;
+        pit_plans_ = cp.pit_plans;
+        strategy_lap_ = cp.strategy_lap;
+        
+        std::lock_guard<std::mutex> lock(profile_mutex_);
+        pending_driver_profiles_ = state_.driver_profiles;
+        pending_car_profiles_ = state_.car_profiles;
+        pending_coefficients_ = coefficients_;
+        profiles_dirty_.store(false, std::memory_order_release);
+    }
+
 private:
     void initialize_race() {
         state_ = RaceState{};
@@ -86,6 +347,19 @@ private:
         // Initialize driver and car profiles
         initialize_profiles();
         
+        // Derive the physics coefficient table and seed the staging copy
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            coefficients_[i] = compute_coefficients(state_.driver_profiles[i], state_.car_profiles[i]);
+        }
+        pending_driver_profiles_ = state_.driver_profiles;
+        pending_car_profiles_ = state_.car_profiles;
+        pending_coefficients_ = coefficients_;
+        
+        timing_loops_.reset();
+        pit_lane_.reset();
+        pit_plans_ = {};
+        strategy_lap_ = 0;
+        
         // Initialize sector timing state
         for (size_t i = 0; i < NUM_DRIVERS; ++i) {
             last_sector_[i] = 0;  // Start in sector 0
@@ -102,6 +376,8 @@ private:
             
             telemetry.distance = -25.0f * static_cast<float>(i);  // Staggered start
             telemetry.position = static_cast<uint8_t>(i + 1);
+            race_order_[i] = static_cast<uint16_t>(i);
+            on_track_[i] = static_cast<uint16_t>(i);
             telemetry.current_lap = 1;
             telemetry.speed = 0.0f;
             
@@ -110,15 +386,13 @@ private:
             car_state.in_pits = false;
             car_state.pit_timer = 0.0f;
             car_state.pit_stops = 0;
+            car_state.drs_open = false;
+            car_state.last_track_flags = 0;
             
             // Calculate pit threshold from driver profile
-            const auto& profile = state_.driver_profiles[i];
-            car_state.pit_threshold = 0.65f + (profile.tire_management * 0.25f);
-            // Adjust by risk tolerance: risky drivers pit later, conservative earlier
-            car_state.pit_threshold += (profile.risk_tolerance - 0.5f) * 0.15f;
-            // Clamp to reasonable range [0.6, 0.95]
-            car_state.pit_threshold = std::clamp(car_state.pit_threshold, 0.6f, 0.95f);
+            car_state.pit_threshold = compute_pit_threshold(state_.driver_profiles[i]);
         }
+        on_track_count_ = NUM_DRIVERS;
     }
     
     void initialize_profiles() {
@@ -218,7 +492,10 @@ private:
         frame.pit_stops = car_state.pit_stops;
         frame.pit_timer = car_state.in_pits ? car_state.pit_timer : 0.0f;
         frame.gap_to_leader = telemetry.gap_to_leader;
+        frame.interval_cs = static_cast<uint16_t>(
+            std::min(telemetry.interval_to_ahead * 100.0f + 0.5f, 65535.0f));
         frame.flags = car_state.in_pits ? FLAG_IN_PITS : 0;
+        if (car_state.drs_open) frame.flags |= FLAG_DRS_OPEN;
         
         // Copy sector times and last lap time
         frame.sector_times[0] = current_sector_times_[car_idx][0];
@@ -229,94 +506,281 @@ private:
         return frame;
     }
     
+    float lap_distance(float distance, uint16_t lap) const {
+        return distance - (track_.length * (lap - 1));
+    }
+
     uint8_t calculate_sector(float distance, uint16_t lap) const {
-        float lap_distance = distance - (TRACK_LENGTH * (lap - 1));
-        float sector_length = TRACK_LENGTH / 3.0f;
-        
-        if (lap_distance < sector_length) return 0;
-        if (lap_distance < sector_length * 2.0f) return 1;
-        return 2;
+        return track_.sample(lap_distance(distance, lap)).sector;
     }
 
     void update_simulation() {
+        apply_pending_profiles();
+        
         tick_count_++;
         state_.tick_count = tick_count_;
         state_.race_time += DT;
         
-        // Simple physics update for each car
+        // Who is around whom, from the positions at the end of last tick
+        update_neighbours();
+        
+        // Physics for the cars on the racing line; pitting cars are moved by
+        // update_pit_lane() instead
+        pit_entry_count_ = 0;
+        for (size_t k = 0; k < on_track_count_; ++k) {
+            update_car_physics(on_track_[k]);
+        }
+        update_pit_lane();
+        
         for (size_t i = 0; i < NUM_DRIVERS; ++i) {
-            update_car_physics(i);
             update_sector_timing(i);  // Track sector times
         }
         
         // Update race order
         update_race_order();
+        
+        // Re-plan pit stops each time the leader starts a lap
+        uint16_t leader_lap = state_.cars[race_order_[0]].telemetry.current_lap;
+        if (leader_lap != strategy_lap_) {
+            strategy_lap_ = leader_lap;
+            update_strategy();
+        }
+        
+        state_hash_ = StateHasher::hash_tick(state_hash_, state_);
     }
 
     void update_car_physics(size_t idx) {
         auto& car_state = state_.cars[idx];
         auto& telemetry = car_state.telemetry;
-        const auto& driver = state_.driver_profiles[idx];
-        const auto& car = state_.car_profiles[idx];
-        
-        // Handle pit stops
-        if (car_state.in_pits) {
-            car_state.pit_timer -= DT;
-            if (car_state.pit_timer <= 0.0f) {
-                // Exit pits
-                car_state.in_pits = false;
-                car_state.tire_wear = 0.0f;  // Fresh tires
-                car_state.pit_stops++;
-            }
-            telemetry.speed = 0.0f;  // Stationary in pits
-            return;
-        }
-        
-        // Check if driver should pit
-        if (car_state.tire_wear >= car_state.pit_threshold && !car_state.in_pits) {
-            car_state.in_pits = true;
-            // Pit stop duration: 2-3 seconds based on car reliability
-            car_state.pit_timer = PIT_STOP_BASE_DURATION + (1.0f - car.reliability) * 0.5f;
-            return;
-        }
+        const auto& coeff = coefficients_[idx];
         
-        // Calculate tire wear
-        // Base wear affected by driver aggression and track characteristics
-        float wear_rate = TIRE_WEAR_BASE_RATE * (1.0f + driver.aggression * 0.5f);
-        // Tire management skill reduces wear
-        wear_rate *= (1.0f - driver.tire_management * 0.3f);
-        car_state.tire_wear += wear_rate * DT;
+        // Apply tire wear (rate precomputed from aggression and tire management)
+        car_state.tire_wear += coeff.wear_per_tick;
         car_state.tire_wear = std::min(car_state.tire_wear, 1.0f);
         
-        // Calculate driver skill factor
-        // Consistent drivers extract more performance from the car
-        float driver_skill = 0.80f + driver.consistency * 0.25f;  // Range: [0.80, 1.05]
-        
-        // Calculate base speed from car performance
-        float base_speed = BASE_SPEED_KMH * car.engine_power * driver_skill;
-        
         // Apply tire wear penalty
         // Worn tires reduce speed (up to 30% reduction at 100% wear)
-        float tire_factor = 1.0f - (car_state.tire_wear * 0.3f);
+        float tire_factor = 1.0f - (car_state.tire_wear * TIRE_WEAR_SPEED_PENALTY);
         
         // Add slight randomness for lap time variation based on consistency
-        // Less consistent drivers have more variation
-        std::uniform_real_distribution<float> speed_dist(-5.0f, 5.0f);
-        float speed_variation = speed_dist(rng_) * (1.0f - driver.consistency);
+        float speed_variation = speed_dist_(rng_) * coeff.speed_variation;
+        
+        // Cap at what this car can carry through the current segment
+        const TrackSample& sample = track_.sample(lap_distance(telemetry.distance, telemetry.current_lap));
+        float segment_limit = sample.speed_limit * coeff.corner_grip;
+        float car_speed = (coeff.base_speed * tire_factor) + speed_variation;
+        
+        // Aerodynamic interactions with the car directly ahead on track
+        const float gap_ahead = neighbours_.gap_ahead(idx);
+        update_drs(car_state, sample.flags, gap_ahead);
+        
+        if (sample.flags & SAMPLE_CORNER) {
+            // Dirty air: turbulence costs front grip when following closely
+            if (gap_ahead < DIRTY_AIR_RANGE_M) {
+                segment_limit *= 1.0f - DIRTY_AIR_MAX_LOSS * (1.0f - gap_ahead / DIRTY_AIR_RANGE_M);
+            }
+        } else {
+            // Slipstream: the tow grows as the gap closes, a little more
+            // behind a train of cars
+            if (gap_ahead < SLIPSTREAM_RANGE_M) {
+                float train = neighbours_.count_within(idx) > 1 ? 1.25f : 1.0f;
+                car_speed += SLIPSTREAM_MAX_GAIN_KMH * train * (1.0f - gap_ahead / SLIPSTREAM_RANGE_M);
+            }
+            if (car_state.drs_open) {
+                car_speed += DRS_GAIN_KMH;
+            }
+        }
         
-        telemetry.speed = (base_speed * tire_factor) + speed_variation;
+        telemetry.speed = std::min(car_speed, segment_limit);
         telemetry.speed = std::max(telemetry.speed, 50.0f);  // Minimum speed
         
         // Update position based on speed
         float speed_ms = telemetry.speed / 3.6f;  // km/h to m/s
+        float previous_distance = telemetry.distance;
         telemetry.distance += speed_ms * DT;
+        timing_loops_.record(idx, previous_distance, telemetry.distance, tick_start_ms(), DT * 1000.0);
+        
+        // Turn in at the pit entry on the lap the strategy picked (the wear
+        // threshold only decides until the first plan exists)
+        const StrategyPlan& plan = pit_plans_[idx];
+        const bool box_this_lap = plan.valid ? plan.pit_lap == telemetry.current_lap
+                                             : car_state.tire_wear >= car_state.pit_threshold;
+        const float pit_entry = track_.length * (telemetry.current_lap - 1) + track_.pit_lane.entry;
+        if (box_this_lap && previous_distance < pit_entry && telemetry.distance >= pit_entry) {
+            pit_entries_[pit_entry_count_] = static_cast<uint16_t>(idx);
+            pit_entry_distance_[pit_entry_count_] = pit_entry;
+            pit_entry_count_++;
+        }
         
         // Check lap completion
-        if (telemetry.distance >= TRACK_LENGTH * telemetry.current_lap) {
+        if (telemetry.distance >= track_.length * telemetry.current_lap) {
             telemetry.current_lap++;
         }
     }
 
+    void update_strategy() {
+        std::array<StrategyCar, NUM_DRIVERS> cars;
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            const auto& car_state = state_.cars[i];
+            const auto& telemetry = car_state.telemetry;
+            const auto& coeff = coefficients_[i];
+            int laps_left = static_cast<int>(total_laps_) - static_cast<int>(telemetry.current_lap) + 1;
+            float lap_done = lap_distance(telemetry.distance, telemetry.current_lap);
+            
+            cars[i] = StrategyCar{
+                coeff.base_speed,
+                coeff.wear_per_tick / DT,
+                coeff.corner_grip,
+                coeff.pit_duration,
+                car_state.tire_wear,
+                std::clamp(1.0f - lap_done / track_.length, 0.0f, 1.0f),
+                telemetry.current_lap,
+                static_cast<uint16_t>(std::max(laps_left, 0)),
+                lap_done < track_.pit_lane.entry,
+                car_state.in_pits
+            };
+        }
+        strategy_->solve(cars.data(), NUM_DRIVERS, pit_plans_.data(), strategy_budget_);
+    }
+
+    void update_pit_lane() {
+        const PitLaneSpec& lane = track_.pit_lane;
+        const float step = lane.speed_limit / 3.6f * DT;
+        
+        // Service finished: fresh tires, drive on to the exit
+        pit_lane_.release_due(tick_count_, [this](uint16_t car) {
+            auto& car_state = state_.cars[car];
+            car_state.tire_wear = 0.0f;
+            car_state.pit_timer = 0.0f;
+            car_state.pit_stops++;
+        });
+        
+        // Everyone in the lane runs at the limiter. Iterate backwards: a
+        // removal swaps in a mover that has already been handled.
+        for (size_t i = pit_lane_.mover_count(); i-- > 0;) {
+            const auto m = pit_lane_.mover(i);
+            auto& car_state = state_.cars[m.car];
+            auto& telemetry = car_state.telemetry;
+            
+            float previous_distance = telemetry.distance;
+            telemetry.distance = std::min(telemetry.distance + step, m.target);
+            telemetry.speed = lane.speed_limit;
+            timing_loops_.record(m.car, previous_distance, telemetry.distance, tick_start_ms(), DT * 1000.0);
+            if (telemetry.distance >= track_.length * telemetry.current_lap) {
+                telemetry.current_lap++;
+            }
+            
+            if (telemetry.distance < m.target) {
+                continue;
+            }
+            if (m.outbound) {
+                // Rejoin the racing line (DRS detection restarts from here)
+                car_state.in_pits = false;
+                car_state.last_track_flags = track_.sample(
+                    lap_distance(telemetry.distance, telemetry.current_lap)).flags;
+                on_track_[on_track_count_++] = m.car;
+                pit_lane_.remove_mover(i);
+            } else {
+                // In the box; waits behind a teammate still being serviced
+                auto service_ticks = static_cast<uint64_t>(std::ceil(coefficients_[m.car].pit_duration / DT));
+                pit_lane_.stop_mover(i, tick_count_, service_ticks);
+            }
+        }
+        
+        // Stationary cars count down to their release
+        for (size_t i = 0; i < pit_lane_.stop_count(); ++i) {
+            const auto& stop = pit_lane_.stop(i);
+            auto& car_state = state_.cars[stop.car];
+            car_state.telemetry.speed = 0.0f;
+            car_state.pit_timer = static_cast<float>(stop.release_tick - tick_count_) * DT;
+        }
+        
+        if (pit_entry_count_ == 0) {
+            return;
+        }
+        
+        // Cars that turned in this tick leave the racing line
+        for (size_t k = 0; k < pit_entry_count_; ++k) {
+            const uint16_t car = pit_entries_[k];
+            auto& car_state = state_.cars[car];
+            const float entry = pit_entry_distance_[k];
+            const float box = std::min(lane.box_offset + PitLane<NUM_DRIVERS>::box_of(car) * PIT_BOX_SPACING_M,
+                                       lane.length - PIT_BOX_SPACING_M);
+            car_state.in_pits = true;
+            car_state.drs_open = false;
+            car_state.telemetry.speed = std::min(car_state.telemetry.speed, lane.speed_limit);
+            pit_lane_.enter(car, entry + box, entry + lane.length);
+        }
+        size_t count = 0;
+        for (size_t k = 0; k < on_track_count_; ++k) {
+            if (!state_.cars[on_track_[k]].in_pits) {
+                on_track_[count++] = on_track_[k];
+            }
+        }
+        on_track_count_ = count;
+    }
+
+    void update_drs(CarState& car_state, uint8_t track_flags, float gap_ahead) {
+        const bool in_zone = (track_flags & SAMPLE_DRS) != 0;
+        const bool entering = in_zone && !(car_state.last_track_flags & SAMPLE_DRS);
+        car_state.last_track_flags = track_flags;
+        
+        if (!in_zone) {
+            car_state.drs_open = false;
+        } else if (entering) {
+            // Detection at the zone entry: within a second of the car ahead
+            float speed_ms = std::max(car_state.telemetry.speed / 3.6f, 1.0f);
+            car_state.drs_open = car_state.telemetry.current_lap >= DRS_ENABLED_FROM_LAP &&
+                                 gap_ahead / speed_ms <= DRS_DETECTION_GAP_S;
+        }
+    }
+
+    void update_neighbours() {
+        std::array<uint16_t, NUM_DRIVERS> on_track;
+        size_t count = 0;
+        
+        for (uint16_t car : race_order_) {
+            const auto& car_state = state_.cars[car];
+            float d = lap_distance(car_state.telemetry.distance, car_state.telemetry.current_lap);
+            // Grid slots behind the line belong to the end of the lap
+            wrapped_distance_[car] = d < 0.0f ? d + track_.length : std::min(d, track_.length);
+            if (!car_state.in_pits) {
+                on_track[count++] = car;
+            }
+        }
+        
+        neighbours_.build(on_track.data(), count, wrapped_distance_.data(),
+                          track_.length, SLIPSTREAM_RANGE_M);
+    }
+
+    // Must hold profile_mutex_
+    void stage_coefficients_locked(size_t idx) {
+        pending_coefficients_[idx] = compute_coefficients(pending_driver_profiles_[idx],
+                                                          pending_car_profiles_[idx]);
+        profiles_dirty_.store(true, std::memory_order_release);
+    }
+
+    void apply_pending_profiles() {
+        if (!profiles_dirty_.load(std::memory_order_acquire)) {
+            return;
+        }
+        
+        // Never block the physics thread: if a writer holds the lock,
+        // pick the update up on the next tick instead
+        std::unique_lock<std::mutex> lock(profile_mutex_, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return;
+        }
+        
+        state_.driver_profiles = pending_driver_profiles_;
+        state_.car_profiles = pending_car_profiles_;
+        coefficients_ = pending_coefficients_;
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            state_.cars[i].pit_threshold = compute_pit_threshold(state_.driver_profiles[i]);
+        }
+        profiles_dirty_.store(false, std::memory_order_release);
+    }
+
     void update_sector_timing(size_t idx) {
         auto& telemetry = state_.cars[idx].telemetry;
         uint8_t current_sector = calculate_sector(telemetry.distance, telemetry.current_lap);
@@ -359,24 +823,58 @@ private:
         
         // Find leader's distance for gap calculations
         float leader_distance = state_.cars[indices[0]].telemetry.distance;
+        const size_t leader = indices[0];
+        const double now_ms = tick_start_ms() + DT * 1000.0;
         
-        // Update positions and calculate gaps
+        // Update positions, gaps and intervals
         for (size_t i = 0; i < NUM_DRIVERS; ++i) {
             size_t car_idx = indices[i];
-            state_.cars[car_idx].telemetry.position = static_cast<uint8_t>(i + 1);
+            auto& telemetry = state_.cars[car_idx].telemetry;
+            telemetry.position = static_cast<uint8_t>(i + 1);
+            race_order_[i] = static_cast<uint16_t>(car_idx);
             
-            // Calculate gap to leader in seconds
-            // Gap = distance difference / average speed (in m/s)
-            float distance_diff = leader_distance - state_.cars[car_idx].telemetry.distance;
-            float avg_speed_ms = (state_.cars[car_idx].telemetry.speed / 3.6f);  // km/h to m/s
-            if (avg_speed_ms > 0.0f) {
-                state_.cars[car_idx].telemetry.gap_to_leader = distance_diff / avg_speed_ms;
-            } else {
-                state_.cars[car_idx].telemetry.gap_to_leader = 0.0f;
+            // Gaps are measured at the timing loops: the time difference between
+            // this car and the other one passing the same point on track
+            telemetry.gap_to_leader = timing_loops_.gap(car_idx, leader, now_ms);
+            telemetry.interval_to_ahead = i > 0 ? timing_loops_.gap(car_idx, indices[i - 1], now_ms) : 0.0f;
+            
+            // Beyond the loop history (many laps down): fall back to an estimate
+            if (telemetry.gap_to_leader == TimingLoops<NUM_DRIVERS>::NO_GAP) {
+                float distance_diff = leader_distance - telemetry.distance;
+                telemetry.gap_to_leader = distance_diff / (BASE_SPEED_KMH / 3.6f);
+            }
+            if (telemetry.interval_to_ahead == TimingLoops<NUM_DRIVERS>::NO_GAP) {
+                float distance_diff = state_.cars[indices[i - 1]].telemetry.distance - telemetry.distance;
+                telemetry.interval_to_ahead = distance_diff / (BASE_SPEED_KMH / 3.6f);
             }
         }
     }
 
+    // Race time at the start of the current tick, exact in ticks
+    double tick_start_ms() const {
+        return static_cast<double>(tick_count_ - 1) * (DT * 1000.0);
+    }
+
+    template <typename TimePoint, typename Duration>
+    TimePoint schedule_after_overrun(TimePoint deadline, TimePoint now, Duration tick_duration) {
+        switch (overrun_policy_) {
+            case OverrunPolicy::CatchUp:
+                // Keep the deadline; following ticks run back-to-back until caught up
+                return deadline;
+            case OverrunPolicy::DropAndResync: {
+                // Skip every slot that has already passed, land on the next boundary
+                auto missed = (now - deadline) / tick_duration + 1;
+                timing_.dropped_ticks += static_cast<uint64_t>(missed);
+                return deadline + missed * tick_duration;
+            }
+            case OverrunPolicy::SlowMotion:
+                // Absorb the overrun: the schedule restarts from now
+                timing_.slow_motion_slip += std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline);
+                return now;
+        }
+        return deadline;
+    }
+
     bool is_race_complete() const {
         // Race complete when leader completes the final lap (starts lap total_laps + 1)
         for (const auto& car_state : state_.cars) {
@@ -392,8 +890,17 @@ private:
     std::atomic<bool>& stop_flag_;
     RaceState state_;
     std::mt19937 rng_;  // For deterministic randomness
+    std::uniform_real_distribution<float> speed_dist_{-5.0f, 5.0f};
     uint16_t total_laps_;
     uint64_t tick_count_;
+    uint64_t state_hash_ = StateHasher::SEED;
+    StateHashTrace* hash_trace_ = nullptr;
+    TelemetryTap* tap_ = nullptr;
+    CompactTelemetryTap* compact_tap_ = nullptr;
+    uint64_t tap_dropped_ = 0;
+    OverrunPolicy overrun_policy_ = OverrunPolicy::CatchUp;
+    TickTimingStats timing_;
+    TrackView track_;  // Storage owned by the caller (or compiled in)
     
     // Sector timing state
     std::array<uint8_t, NUM_DRIVERS> last_sector_;        // Track last sector for each driver
@@ -401,6 +908,38 @@ private:
     std::array<uint32_t, NUM_DRIVERS> lap_start_time_;    // When current lap started (ms)
     std::array<std::array<uint32_t, 3>, NUM_DRIVERS> current_sector_times_;  // S1, S2, S3 for current lap
     std::array<uint32_t, NUM_DRIVERS> previous_lap_time_; // Last completed lap time
+    
+    // Race order (leader first) and on-track neighbours, rebuilt every tick
+    std::array<uint16_t, NUM_DRIVERS> race_order_;
+    std::array<float, NUM_DRIVERS> wrapped_distance_;
+    NeighbourIndex<NUM_DRIVERS> neighbours_;
+    
+    // Timing-line crossing history for gaps and intervals
+    TimingLoops<NUM_DRIVERS> timing_loops_;
+    
+    // Pit strategy: plans are state, the solver (and its threads) are not
+    std::unique_ptr<StrategySolver> strategy_;
+    std::chrono::microseconds strategy_budget_ = DEFAULT_STRATEGY_BUDGET;
+    std::array<StrategyPlan, NUM_DRIVERS> pit_plans_{};
+    uint16_t strategy_lap_ = 0;
+    
+    // Cars on the racing line (physics loop) and cars in the pit lane
+    std::array<uint16_t, NUM_DRIVERS> on_track_;
+    size_t on_track_count_ = 0;
+    PitLane<NUM_DRIVERS> pit_lane_;
+    std::array<uint16_t, NUM_DRIVERS> pit_entries_;   // Turned in this tick
+    std::array<float, NUM_DRIVERS> pit_entry_distance_;
+    size_t pit_entry_count_ = 0;
+    
+    // Physics coefficient table (physics thread only)
+    std::array<CarCoefficients, NUM_DRIVERS> coefficients_;
+    
+    // Staged profile updates, swapped in at the next tick boundary
+    std::mutex profile_mutex_;
+    std::atomic<bool> profiles_dirty_{false};
+    std::array<DriverProfile, NUM_DRIVERS> pending_driver_profiles_;
+    std::array<CarProfile, NUM_DRIVERS> pending_car_profiles_;
+    std::array<CarCoefficients, NUM_DRIVERS> pending_coefficients_;
 };
 
 } // namespace f1sim
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Real-Time Thread Placement
+// ============================================================================
+
+/**
+ * @brief Scheduling class requested for a thread
+ *
+ * Default leaves the thread under the normal time-sharing scheduler.
+ * Fifo/RoundRobin request SCHED_FIFO/SCHED_RR, which needs CAP_SYS_NICE or an
+ * RLIMIT_RTPRIO allowance; without it the request is refused and the thread
+ * keeps running with default scheduling.
+ */
+enum class SchedPolicy : uint8_t {
+    Default,
+    Fifo,
+    RoundRobin
+};
+
+constexpr bool parse_sched_policy(std::string_view name, SchedPolicy& out) {
+    if (name == "default" || name == "other") { out = SchedPolicy::Default; return true; }
+    if (name == "fifo") { out = SchedPolicy::Fifo; return true; }
+    if (name == "rr") { out = SchedPolicy::RoundRobin; return true; }
+    return false;
+}
+
+struct ThreadPlacement {
+    int cpu = -1;                              // CPU to pin to, -1 = don't pin
+    SchedPolicy policy = SchedPolicy::Default;
+    int priority = 0;                          // 1-99 for Fifo/RoundRobin
+};
+
+/**
+ * @brief Apply CPU affinity and scheduling class to the calling thread
+ *
+ * Every step is best effort: a refused request prints one warning naming the
+ * thread and the simulator carries on with what it has.
+ * @return true if everything requested was applied
+ */
+inline bool apply_thread_placement(const ThreadPlacement& placement, const char* thread_name) {
+    bool ok = true;
+    
+    if (placement.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(placement.cpu, &cpus);
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            std::cerr << "[" << thread_name << "] cannot pin to CPU " << placement.cpu
+                      << ": " << std::strerror(err) << " (continuing unpinned)\n";
+            ok = false;
+        }
+    }
+    
+    if (placement.policy != SchedPolicy::Default) {
+        int policy = placement.policy == SchedPolicy::Fifo ? SCHED_FIFO : SCHED_RR;
+        int priority = std::max(sched_get_priority_min(policy),
+                                std::min(placement.priority, sched_get_priority_max(policy)));
+        sched_param param{};
+        param.sched_priority = priority;
+        int err = pthread_setschedparam(pthread_self(), policy, &param);
+        if (err != 0) {
+            std::cerr << "[" << thread_name << "] cannot switch to "
+                      << (policy == SCHED_FIFO ? "SCHED_FIFO" : "SCHED_RR") << " priority " << priority
+                      << ": " << std::strerror(err) << " (continuing with default scheduling)\n";
+            ok = false;
+        }
+    }
+    
+    return ok;
+}
+
+// ============================================================================
+// Memory Locking & Prefaulting
+// ============================================================================
+
+/**
+ * @brief Lock current and future pages into RAM (mlockall)
+ *
+ * MCL_FUTURE counts every later mapping against RLIMIT_MEMLOCK, so under a
+ * finite limit an allocation made after this call (a ring, io_uring buffers)
+ * can fail outright. Without root the lock is then confined to the pages
+ * mapped now; the same fallback applies if the full lock is refused.
+ * @return false if nothing could be locked; the process continues unlocked
+ */
+inline bool lock_process_memory() {
+    rlimit limit{};
+    const bool limited = getrlimit(RLIMIT_MEMLOCK, &limit) == 0 &&
+                         limit.rlim_cur != RLIM_INFINITY && geteuid() != 0;
+
+    if (!limited && mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+        return true;
+    }
+    if (!limited) {
+        std::cerr << "mlockall(MCL_FUTURE) failed: " << std::strerror(errno)
+                  << " (locking current pages only)\n";
+    } else {
+        std::cerr << "RLIMIT_MEMLOCK is " << (limit.rlim_cur >> 10)
+                  << " KiB: locking current pages only, later allocations stay unlocked\n";
+    }
+    if (mlockall(MCL_CURRENT) != 0) {
+        std::cerr << "mlockall failed: " << std::strerror(errno)
+                  << " (continuing without locked memory)\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Touch every page of [data, data + size) so it is resident before the
+ *        hot loop runs
+ *
+ * Reads and writes back one byte per page: contents are unchanged, but the
+ * page is faulted in writable. Call before the memory is shared between threads.
+ */
+inline void prefault(void* data, size_t size) {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto* bytes = static_cast<volatile unsigned char*>(data);
+    
+    for (size_t offset = 0; offset < size; offset += page) {
+        bytes[offset] = bytes[offset];
+    }
+    if (size > 0) {
+        bytes[size - 1] = bytes[size - 1];
+    }
+}
+
+/**
+ * @brief Fault in the top of the calling thread's stack
+ */
+template <size_t Bytes = 256 * 1024>
+inline void prefault_stack() {
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    volatile unsigned char stack[Bytes];
+    
+    for (size_t offset = 0; offset < Bytes; offset += page) {
+        stack[offset] = 0;
+    }
+    (void)stack;
+}
+
+} // namespace f1sim
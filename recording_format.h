@@ -0,0 +1,221 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include "telemetry_codec.h"
+#include "compact_frame.h"
+#include "ring_buffer.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace f1sim {
+
+// ============================================================================
+// Telemetry Recording Format
+//
+//   [file header, padded to RECORDING_ALIGNMENT]
+//   [block][block]...
+//
+// Every block is exactly RECORDING_BLOCK_BYTES: a 64-byte header followed by
+// the payload, zero-padded. The payload is up to RECORDING_FRAMES_PER_BLOCK
+// raw TelemetryFrames, up to RECORDING_COMPACT_FRAMES_PER_BLOCK
+// CompactTelemetryFrames, or a FrameEncoder stream that starts with a
+// keyframe for every driver, so each block decodes on its own. Fixed,
+// aligned blocks keep the file writable with O_DIRECT and let a reader find
+// block n at header + n × block size without scanning.
+//
+// Integers are little-endian (host order on every supported target).
+// ============================================================================
+
+constexpr uint32_t RECORDING_MAGIC = 0x43455246;        // "FREC"
+constexpr uint32_t RECORDING_BLOCK_MAGIC = 0x4b4c4246;  // "FBLK"
+constexpr uint16_t RECORDING_VERSION = 1;
+constexpr size_t RECORDING_ALIGNMENT = 4096;            // O_DIRECT offset/size granularity
+constexpr size_t RECORDING_BLOCK_BYTES = 64 * 1024;     // ~1 s of frames at the live rate
+constexpr size_t RECORDING_TRACK_NAME_BYTES = 32;
+
+// Frames between the engine and the recorder thread: 16 s at the live rate,
+// enough to ride out a slow disk without the physics thread ever waiting
+constexpr size_t RECORDER_RING_FRAMES = 16384;
+using TelemetryTap = RingBuffer<TelemetryFrame, RECORDER_RING_FRAMES>;
+using CompactTelemetryTap = RingBuffer<CompactTelemetryFrame, RECORDER_RING_FRAMES>;  // Half the bytes
+
+/**
+ * @brief How frames are stored in a block's payload
+ */
+enum class RecordingEncoding : uint16_t {
+    Raw,     // TelemetryFrames as they are in memory
+    Delta,   // FrameEncoder stream (~12x smaller, lossless)
+    Compact  // CompactTelemetryFrames (half size, quantized)
+};
+
+constexpr std::string_view recording_encoding_name(RecordingEncoding encoding) {
+    switch (encoding) {
+        case RecordingEncoding::Raw:     return "raw";
+        case RecordingEncoding::Delta:   return "delta";
+        case RecordingEncoding::Compact: return "compact";
+    }
+    return "unknown";
+}
+
+constexpr bool parse_recording_encoding(std::string_view name, RecordingEncoding& out) {
+    for (auto encoding : {RecordingEncoding::Raw, RecordingEncoding::Delta, RecordingEncoding::Compact}) {
+        if (name == recording_encoding_name(encoding)) {
+            out = encoding;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief What was raced, written once at the start of the file
+ */
+struct RecordingHeader {
+    uint32_t magic = RECORDING_MAGIC;
+    uint16_t version = RECORDING_VERSION;
+    uint16_t frame_bytes = sizeof(TelemetryFrame);
+    uint32_t header_bytes = RECORDING_ALIGNMENT;     // Offset of the first block
+    uint32_t block_bytes = RECORDING_BLOCK_BYTES;
+    uint32_t seed = 0;
+    uint16_t laps = 0;
+    uint16_t drivers = NUM_DRIVERS;
+    uint16_t sim_hz = 0;
+    RecordingEncoding encoding = RecordingEncoding::Raw;
+    float track_length = 0.0f;
+    char track_name[RECORDING_TRACK_NAME_BYTES] = {};
+    uint32_t segment = 0;                            // Number in a segmented recording (0 if not)
+
+    void set_track_name(std::string_view name) {
+        std::memset(track_name, 0, sizeof(track_name));
+        std::memcpy(track_name, name.data(), std::min(name.size(), sizeof(track_name) - 1));
+    }
+};
+
+static_assert(sizeof(RecordingHeader) <= RECORDING_ALIGNMENT);
+
+/**
+ * @brief Check a recording's header against this build's layout
+ * @param file_bytes Size of the whole recording file
+ * @return false (with `error` set) if the file can't be read as a recording
+ */
+inline bool check_recording_header(const RecordingHeader& header, size_t file_bytes, std::string& error) {
+    if (header.magic != RECORDING_MAGIC || header.version != RECORDING_VERSION ||
+        header.frame_bytes != sizeof(TelemetryFrame) || header.block_bytes != RECORDING_BLOCK_BYTES ||
+        header.header_bytes > file_bytes) {
+        error = "not a telemetry recording (or an unsupported version)";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Per-block header: what the block covers and how to check it
+ *
+ * Same size as a frame, so the payload after it stays 64-byte aligned.
+ */
+struct RecordingBlockHeader {
+    uint32_t magic = RECORDING_BLOCK_MAGIC;
+    uint32_t sequence = 0;            // Block number from 0, in file order
+    uint32_t frame_count = 0;
+    uint32_t first_timestamp_ms = 0;  // Race-time range of the frames (one tick = 20 ms)
+    uint32_t last_timestamp_ms = 0;
+    uint32_t payload_bytes = 0;       // Raw: frame_count × 64; Compact: × 32; Delta: stream length
+    uint64_t checksum = 0;            // recording_checksum() of the payload
+    uint8_t padding[32] = {};
+};
+
+static_assert(sizeof(RecordingBlockHeader) == sizeof(TelemetryFrame));
+
+constexpr size_t RECORDING_PAYLOAD_BYTES = RECORDING_BLOCK_BYTES - sizeof(RecordingBlockHeader);
+constexpr size_t RECORDING_FRAMES_PER_BLOCK = RECORDING_PAYLOAD_BYTES / sizeof(TelemetryFrame);
+constexpr size_t RECORDING_COMPACT_FRAMES_PER_BLOCK = RECORDING_PAYLOAD_BYTES / sizeof(CompactTelemetryFrame);
+
+static_assert(RECORDING_BLOCK_BYTES % RECORDING_ALIGNMENT == 0);
+
+/**
+ * @brief 64-bit checksum for catching torn or corrupted blocks
+ *
+ * Four independent multiply-xor lanes over 8-byte words, folded at the end,
+ * so it runs at several GB/s. Not cryptographic.
+ */
+inline uint64_t recording_checksum(const void* data, size_t bytes) {
+    constexpr uint64_t K = 0x9e3779b97f4a7c15ULL;
+    auto mix = [](uint64_t h, uint64_t v) {
+        h = (h ^ v) * K;
+        return h ^ (h >> 29);
+    };
+
+    const auto* p = static_cast<const unsigned char*>(data);
+    uint64_t lanes[4] = {K, K + 1, K + 2, K + 3};
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        for (size_t l = 0; l < 4; ++l) {
+            uint64_t word;
+            std::memcpy(&word, p + i + l * 8, 8);
+            lanes[l] = mix(lanes[l], word);
+        }
+    }
+    uint64_t h = mix(mix(lanes[0], lanes[1]), mix(lanes[2], lanes[3]));
+    for (; i < bytes; ++i) {
+        h = mix(h, p[i]);
+    }
+    return mix(h, bytes);
+}
+
+/**
+ * @brief Check a block read back from disk
+ * @param block RECORDING_BLOCK_BYTES starting at the block header
+ */
+inline bool verify_recording_block(const unsigned char* block) {
+    RecordingBlockHeader header;
+    std::memcpy(&header, block, sizeof(header));
+    if (header.magic != RECORDING_BLOCK_MAGIC || header.payload_bytes > RECORDING_PAYLOAD_BYTES) {
+        return false;
+    }
+    return recording_checksum(block + sizeof(header), header.payload_bytes) == header.checksum;
+}
+
+/**
+ * @brief Call fn(frame) for every frame in a verified block
+ * @return false if a delta payload doesn't decode to frame_count frames
+ */
+template <typename Fn>
+bool decode_recording_block(const unsigned char* block, RecordingEncoding encoding, Fn&& fn) {
+    RecordingBlockHeader header;
+    std::memcpy(&header, block, sizeof(header));
+    const unsigned char* payload = block + sizeof(header);
+
+    TelemetryFrame frame;
+    if (encoding == RecordingEncoding::Raw) {
+        if (header.payload_bytes != header.frame_count * sizeof(TelemetryFrame)) return false;
+        for (uint32_t i = 0; i < header.frame_count; ++i) {
+            std::memcpy(&frame, payload + i * sizeof(TelemetryFrame), sizeof(frame));
+            fn(frame);
+        }
+        return true;
+    }
+    if (encoding == RecordingEncoding::Compact) {
+        if (header.payload_bytes != header.frame_count * sizeof(CompactTelemetryFrame)) return false;
+        CompactTelemetryFrame compact;
+        for (uint32_t i = 0; i < header.frame_count; ++i) {
+            std::memcpy(&compact, payload + i * sizeof(CompactTelemetryFrame), sizeof(compact));
+            fn(from_compact(compact));
+        }
+        return true;
+    }
+
+    FrameDecoder decoder;
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + header.payload_bytes;
+    for (uint32_t i = 0; i < header.frame_count; ++i) {
+        if (!decoder.decode(p, end, frame)) return false;
+        fn(frame);
+    }
+    return p == end;
+}
+
+} // namespace f1sim
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "recording_format.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Recording Index - Sidecar Seek Table (<recording>.idx)
+//
+//   [RecordingIndexHeader]
+//   [IndexTimeEntry  × time_entries]   one per interval_ms of race time
+//   [IndexLapEntry   × lap_entries]    sorted by (driver, lap)
+//   [IndexPitEntry   × pit_entries]    sorted by (driver, stop, event)
+//
+// Every entry names the block its tick starts in, so any lookup is a binary
+// search over a few KB followed by one block read. The index only holds
+// what can be derived from the frames, so it is rebuilt from the recording
+// whenever it is missing or no longer matches the data file.
+// ============================================================================
+
+constexpr uint32_t RECORDING_INDEX_MAGIC = 0x58444946;  // "FIDX"
+constexpr uint16_t RECORDING_INDEX_VERSION = 1;
+constexpr uint32_t DEFAULT_INDEX_INTERVAL_MS = 1000;
+constexpr uint8_t INDEX_RACE = 0xff;  // Lap entries for the race: the first car to start each lap
+
+/**
+ * @brief Where a lookup lands: the tick's race time and the block it starts in
+ */
+struct RecordingPosition {
+    uint32_t timestamp_ms = 0;
+    uint32_t block = 0;
+};
+
+struct IndexTimeEntry {
+    uint32_t timestamp_ms;  // First tick at or after a multiple of interval_ms
+    uint32_t block;
+};
+
+struct IndexLapEntry {
+    uint8_t driver;         // Driver id, or INDEX_RACE
+    uint8_t reserved;
+    uint16_t lap;
+    uint32_t timestamp_ms;  // First tick on this lap
+    uint32_t block;
+};
+
+enum class PitEvent : uint8_t { Entry, Exit };
+
+struct IndexPitEntry {
+    uint8_t driver;
+    uint8_t stop;           // 1 for the driver's first stop
+    PitEvent event;
+    uint8_t reserved;
+    uint32_t timestamp_ms;  // Entry: first tick in the pits; Exit: first tick out
+    uint32_t block;
+};
+
+struct RecordingIndexHeader {
+    uint32_t magic = RECORDING_INDEX_MAGIC;
+    uint16_t version = RECORDING_INDEX_VERSION;
+    uint16_t drivers = NUM_DRIVERS;
+    uint32_t interval_ms = DEFAULT_INDEX_INTERVAL_MS;
+    uint32_t blocks = 0;               // Blocks in the data file when indexed
+    uint64_t last_block_checksum = 0;  // Its last block's checksum, to spot a changed file
+    uint32_t time_entries = 0;
+    uint32_t lap_entries = 0;
+    uint32_t pit_entries = 0;
+    uint32_t reserved = 0;
+    uint64_t checksum = 0;             // recording_checksum() of the entries
+};
+
+inline std::string recording_index_path(const std::string& recording_path) {
+    return recording_path + ".idx";
+}
+
+/**
+ * @brief Time, lap and pit-stop seek table for one recording
+ *
+ * Built either frame by frame while recording (add(), then finish()) or
+ * from an existing recording with build(). Lookups return the tick to start
+ * from and the block holding it.
+ */
+class RecordingIndex {
+public:
+    explicit RecordingIndex(uint32_t interval_ms = DEFAULT_INDEX_INTERVAL_MS) {
+        header_.interval_ms = std::max<uint32_t>(interval_ms, 1);
+        reset_builder();
+    }
+
+    const RecordingIndexHeader& header() const { return header_; }
+    bool empty() const { return times_.empty(); }
+    size_t time_entries() const { return times_.size(); }
+    size_t lap_entries() const { return laps_.size(); }
+    size_t pit_entries() const { return pits_.size(); }
+
+    size_t bytes() const {
+        return sizeof(header_) + times_.size() * sizeof(IndexTimeEntry) +
+               laps_.size() * sizeof(IndexLapEntry) + pits_.size() * sizeof(IndexPitEntry);
+    }
+
+    // ------------------------------------------------------------------------
+    // Building
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Index one frame, in recording order, stored in block `block`
+     */
+    void add(const TelemetryFrame& frame, uint32_t block) {
+        if (frame.timestamp_ms != tick_ms_ || !started_) {
+            started_ = true;
+            tick_ms_ = frame.timestamp_ms;
+            tick_block_ = block;
+            if (tick_ms_ >= next_time_ms_) {
+                times_.push_back({tick_ms_, tick_block_});
+                next_time_ms_ = (tick_ms_ / header_.interval_ms + 1) * header_.interval_ms;
+            }
+        }
+
+        const uint8_t driver = frame.driver_id;
+        if (driver >= NUM_DRIVERS) return;
+        DriverState& state = drivers_[driver];
+
+        if (!state.seen || frame.lap > state.lap) {
+            laps_.push_back({driver, 0, frame.lap, tick_ms_, tick_block_});
+            if (frame.lap > race_lap_ || race_laps_.empty()) {
+                race_lap_ = frame.lap;
+                race_laps_.push_back({INDEX_RACE, 0, frame.lap, tick_ms_, tick_block_});
+            }
+            state.lap = frame.lap;
+        }
+
+        const bool in_pits = (frame.flags & FLAG_IN_PITS) != 0;
+        if (state.seen && in_pits != state.in_pits) {
+            if (in_pits) state.stops++;
+            pits_.push_back({driver, state.stops, in_pits ? PitEvent::Entry : PitEvent::Exit, 0,
+                             tick_ms_, tick_block_});
+        }
+        state.in_pits = in_pits;
+        state.seen = true;
+    }
+
+    /**
+     * @brief Seal the index against the data file it describes
+     * @param blocks Blocks in the data file
+     * @param last_block_checksum Checksum in the last block's header
+     */
+    void finish(uint32_t blocks, uint64_t last_block_checksum) {
+        laps_.insert(laps_.end(), race_laps_.begin(), race_laps_.end());
+        race_laps_.clear();
+        std::sort(laps_.begin(), laps_.end(), lap_less);
+        std::sort(pits_.begin(), pits_.end(), pit_less);
+
+        header_.blocks = blocks;
+        header_.last_block_checksum = last_block_checksum;
+        header_.time_entries = static_cast<uint32_t>(times_.size());
+        header_.lap_entries = static_cast<uint32_t>(laps_.size());
+        header_.pit_entries = static_cast<uint32_t>(pits_.size());
+        header_.checksum = entries_checksum();
+        reset_builder();
+    }
+
+    /**
+     * @brief Rebuild the index from a mapped recording alone
+     *
+     * Stops at the first torn or corrupt block, like playback does.
+     * @return false (with `error` set) if `file` isn't a recording
+     */
+    bool build(const MappedFile& file, std::string& error) {
+        RecordingHeader recording;
+        if (!check_recording(file, recording, error)) return false;
+
+        const uint32_t interval = header_.interval_ms;
+        *this = RecordingIndex(interval);
+        const uint32_t blocks = recording_blocks(file, recording);
+        for (uint32_t b = 0; b < blocks; ++b) {
+            const size_t offset = recording.header_bytes + size_t{b} * RECORDING_BLOCK_BYTES;
+            if (b % BUILD_PREFETCH_BLOCKS == 0) {
+                file.prefetch(offset, 2 * BUILD_PREFETCH_BLOCKS * RECORDING_BLOCK_BYTES);
+            }
+            const unsigned char* block = file.data() + offset;
+            if (!verify_recording_block(block)) break;
+            const bool decoded = decode_recording_block(block, recording.encoding, [&](const TelemetryFrame& frame) {
+                add(frame, b);
+            });
+            if (!decoded) break;
+        }
+        finish(blocks, last_block_checksum(file, recording));
+        return true;
+    }
+
+    /**
+     * @brief Whether this index was built from `file` as it is now
+     */
+    bool matches(const MappedFile& file) const {
+        RecordingHeader recording;
+        std::string error;
+        return check_recording(file, recording, error) &&
+               header_.blocks == recording_blocks(file, recording) &&
+               header_.last_block_checksum == last_block_checksum(file, recording);
+    }
+
+    // ------------------------------------------------------------------------
+    // Persistence
+    // ------------------------------------------------------------------------
+
+    bool save(const std::string& path, std::string& error) const {
+        FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            error = "cannot create " + path;
+            return false;
+        }
+        bool ok = std::fwrite(&header_, sizeof(header_), 1, out) == 1;
+        ok = ok && write_all(out, times_) && write_all(out, laps_) && write_all(out, pits_);
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok) error = "cannot write " + path;
+        return ok;
+    }
+
+    /**
+     * @brief Load an index file
+     * @return false (with `error` set) if it is missing, truncated or corrupt
+     */
+    bool load(const std::string& path, std::string& error) {
+        MappedFile file;
+        if (!file.open(path)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        RecordingIndexHeader header;
+        if (file.size() < sizeof(header)) {
+            error = path + " is not a recording index";
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        const size_t expected = sizeof(header) + size_t{header.time_entries} * sizeof(IndexTimeEntry) +
+                                size_t{header.lap_entries} * sizeof(IndexLapEntry) +
+                                size_t{header.pit_entries} * sizeof(IndexPitEntry);
+        if (header.magic != RECORDING_INDEX_MAGIC || header.version != RECORDING_INDEX_VERSION ||
+            header.interval_ms == 0 || file.size() != expected) {
+            error = path + " is not a recording index (or an unsupported version)";
+            return false;
+        }
+
+        RecordingIndex index(header.interval_ms);
+        const unsigned char* p = file.data() + sizeof(header);
+        p = read_all(p, header.time_entries, index.times_);
+        p = read_all(p, header.lap_entries, index.laps_);
+        read_all(p, header.pit_entries, index.pits_);
+        index.header_ = header;
+        if (index.entries_checksum() != header.checksum) {
+            error = path + " is corrupt";
+            return false;
+        }
+        *this = std::move(index);
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Lookups (binary searches over the loaded entries)
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Blocks that can hold the first tick at or after `timestamp_ms`
+     *
+     * Exact (first == last) whenever no block boundary falls between the
+     * two time entries around it; otherwise a binary search over just those
+     * block headers finishes the job.
+     */
+    bool time_blocks(uint32_t timestamp_ms, uint32_t& first, uint32_t& last) const {
+        if (times_.empty() || header_.blocks == 0) return false;
+        auto after = std::upper_bound(times_.begin(), times_.end(), timestamp_ms,
+                                      [](uint32_t ms, const IndexTimeEntry& entry) { return ms < entry.timestamp_ms; });
+        first = after == times_.begin() ? 0 : std::prev(after)->block;
+        last = after == times_.end() ? header_.blocks - 1 : after->block;
+        return true;
+    }
+
+    /**
+     * @brief Start of `lap` for `driver`, or for the race (the leader) by default
+     */
+    bool lap_start(uint16_t lap, RecordingPosition& out, uint8_t driver = INDEX_RACE) const {
+        const IndexLapEntry key{driver, 0, lap, 0, 0};
+        auto it = std::lower_bound(laps_.begin(), laps_.end(), key, lap_less);
+        if (it == laps_.end() || it->driver != driver || it->lap != lap) return false;
+        out = {it->timestamp_ms, it->block};
+        return true;
+    }
+
+    /**
+     * @brief Pit entry or exit of `driver`'s `stop` (1-based)
+     */
+    bool pit_stop(uint8_t driver, uint8_t stop, PitEvent event, RecordingPosition& out) const {
+        const IndexPitEntry key{driver, stop, event, 0, 0, 0};
+        auto it = std::lower_bound(pits_.begin(), pits_.end(), key, pit_less);
+        if (it == pits_.end() || pit_less(key, *it)) return false;
+        out = {it->timestamp_ms, it->block};
+        return true;
+    }
+
+    /**
+     * @brief Start of `driver`'s `stint` (1-based): the first frame for
+     *        stint 1, the pit exit of stop stint - 1 after that
+     */
+    bool stint_start(uint8_t driver, uint8_t stint, RecordingPosition& out) const {
+        if (stint == 0) return false;
+        if (stint == 1) {
+            const IndexLapEntry key{driver, 0, 0, 0, 0};
+            auto it = std::lower_bound(laps_.begin(), laps_.end(), key, lap_less);
+            if (it == laps_.end() || it->driver != driver) return false;
+            out = {it->timestamp_ms, it->block};
+            return true;
+        }
+        return pit_stop(driver, static_cast<uint8_t>(stint - 1), PitEvent::Exit, out);
+    }
+
+private:
+    // The file may be mapped for random access: read ahead explicitly (4 MiB)
+    static constexpr uint32_t BUILD_PREFETCH_BLOCKS = 64;
+
+    struct DriverState {
+        bool seen = false;
+        bool in_pits = false;
+        uint8_t stops = 0;
+        uint16_t lap = 0;
+    };
+
+    static bool lap_less(const IndexLapEntry& a, const IndexLapEntry& b) {
+        return std::tie(a.driver, a.lap) < std::tie(b.driver, b.lap);
+    }
+
+    static bool pit_less(const IndexPitEntry& a, const IndexPitEntry& b) {
+        return std::tie(a.driver, a.stop, a.event) < std::tie(b.driver, b.stop, b.event);
+    }
+
+    static bool check_recording(const MappedFile& file, RecordingHeader& recording, std::string& error) {
+        if (file.size() < sizeof(recording)) {
+            error = "not a telemetry recording";
+            return false;
+        }
+        std::memcpy(&recording, file.data(), sizeof(recording));
+        return check_recording_header(recording, file.size(), error);
+    }
+
+    static uint32_t recording_blocks(const MappedFile& file, const RecordingHeader& recording) {
+        return static_cast<uint32_t>((file.size() - recording.header_bytes) / RECORDING_BLOCK_BYTES);
+    }
+
+    static uint64_t last_block_checksum(const MappedFile& file, const RecordingHeader& recording) {
+        const uint32_t blocks = recording_blocks(file, recording);
+        if (blocks == 0) return 0;
+        RecordingBlockHeader header;
+        std::memcpy(&header, file.data() + recording.header_bytes + size_t{blocks - 1} * RECORDING_BLOCK_BYTES,
+                    sizeof(header));
+        return header.checksum;
+    }
+
+    template <typename Entry>
+    static bool write_all(FILE* out, const std::vector<Entry>& entries) {
+        return entries.empty() || std::fwrite(entries.data(), sizeof(Entry), entries.size(), out) == entries.size();
+    }
+
+    template <typename Entry>
+    static const unsigned char* read_all(const unsigned char* p, size_t count, std::vector<Entry>& entries) {
+        entries.resize(count);
+        if (count > 0) std::memcpy(entries.data(), p, count * sizeof(Entry));
+        return p + count * sizeof(Entry);
+    }
+
+    uint64_t entries_checksum() const {
+        const uint64_t parts[3] = {
+            recording_checksum(times_.data(), times_.size() * sizeof(IndexTimeEntry)),
+            recording_checksum(laps_.data(), laps_.size() * sizeof(IndexLapEntry)),
+            recording_checksum(pits_.data(), pits_.size() * sizeof(IndexPitEntry)),
+        };
+        return recording_checksum(parts, sizeof(parts));
+    }
+
+    void reset_builder() {
+        started_ = false;
+        tick_ms_ = 0;
+        tick_block_ = 0;
+        next_time_ms_ = 0;
+        race_lap_ = 0;
+        drivers_ = {};
+    }
+
+    RecordingIndexHeader header_;
+    std::vector<IndexTimeEntry> times_;
+    std::vector<IndexLapEntry> laps_;
+    std::vector<IndexPitEntry> pits_;
+
+    // Builder state, between add() and finish()
+    std::vector<IndexLapEntry> race_laps_;
+    std::array<DriverState, NUM_DRIVERS> drivers_{};
+    bool started_ = false;
+    uint32_t tick_ms_ = 0;
+    uint32_t tick_block_ = 0;
+    uint32_t next_time_ms_ = 0;
+    uint16_t race_lap_ = 0;
+};
+
+} // namespace f1sim
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "recording_format.h"
+#include "mapped_file.h"
+#include "thread_pool.h"
+#include "telemetry_export.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Recording Reader - Parallel Chunked Decode
+// ============================================================================
+
+/**
+ * @brief Decodes a recording in chunks of whole blocks on a ThreadPool
+ *
+ * Every block decodes on its own (raw frames, or a delta stream that starts
+ * with keyframes), so a file splits at any block boundary with no scan.
+ * A chunk is chunk_blocks() consecutive blocks; pool threads claim chunks
+ * in file order and decode them into frame buffers that are reused from
+ * chunk to chunk.
+ *
+ * for_each_chunk() hands chunks to a callback in whatever order they
+ * finish (aggregations, part files). for_each_chunk_ordered() also runs a
+ * transform in parallel but feeds its output to a sink strictly in file
+ * order, with at most a window of chunks in flight - that is how a single
+ * sequential output file is written without holding the whole result.
+ *
+ * Decoding stops at the first torn or corrupt block, as playback does:
+ * chunks after it are skipped, and the torn chunk contributes the frames
+ * before the bad block.
+ */
+class RecordingReader {
+public:
+    bool open(const std::string& path, std::string& error) {
+        if (!file_.open(path)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        if (file_.size() < sizeof(header_)) {
+            error = "not a telemetry recording";
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (!check_recording_header(header_, file_.size(), error)) return false;
+        blocks_ = (file_.size() - header_.header_bytes) / RECORDING_BLOCK_BYTES;
+        return true;
+    }
+
+    const RecordingHeader& header() const { return header_; }
+    size_t block_count() const { return blocks_; }
+
+    // ~16 k frames (1 MiB raw, 512 KiB compact), ~20 k frames (128 KiB) delta
+    size_t chunk_blocks() const {
+        switch (header_.encoding) {
+            case RecordingEncoding::Raw:     return 16;
+            case RecordingEncoding::Compact: return 8;
+            case RecordingEncoding::Delta:   return 2;
+        }
+        return 2;
+    }
+
+    size_t chunk_count() const {
+        return (blocks_ + chunk_blocks() - 1) / chunk_blocks();
+    }
+
+    /**
+     * @brief Decode chunk `chunk` into `frames` (replacing its contents)
+     * @return false if it holds a torn or corrupt block; `frames` then has
+     *         the frames before it
+     */
+    bool decode_chunk(size_t chunk, std::vector<TelemetryFrame>& frames) const {
+        frames.clear();
+        const size_t first = chunk * chunk_blocks();
+        const size_t last = std::min(first + chunk_blocks(), blocks_);
+        file_.prefetch(block_offset(first), (last - first) * RECORDING_BLOCK_BYTES);
+        for (size_t b = first; b < last; ++b) {
+            const unsigned char* block = file_.data() + block_offset(b);
+            if (!verify_recording_block(block)) return false;
+            const size_t before = frames.size();
+            const bool decoded = decode_recording_block(block, header_.encoding, [&](const TelemetryFrame& frame) {
+                frames.push_back(frame);
+            });
+            if (!decoded) {
+                frames.resize(before);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run fn(chunk, frames, count) for every chunk, in any order and
+     *        on any of the pool's threads
+     *
+     * Chunks after a torn one may still have been handed to `fn` if they
+     * finished before it was found; the return value says which to keep.
+     * @return Chunks up to and including the first torn one (all if none)
+     */
+    template <typename Fn>
+    size_t for_each_chunk(ThreadPool& pool, Fn&& fn) const {
+        const size_t chunks = chunk_count();
+        std::atomic<size_t> torn{chunks};
+
+        pool.parallel_for(chunks, [&](size_t chunk) {
+            if (chunk > torn.load(std::memory_order_relaxed)) return;
+            thread_local std::vector<TelemetryFrame> frames;  // Reused by each pool thread
+            if (!decode_chunk(chunk, frames)) {
+                lower(torn, chunk);
+            }
+            fn(chunk, frames.data(), frames.size());
+        });
+        return std::min(torn.load() + 1, chunks);
+    }
+
+    /**
+     * @brief transform(frames, count, out) on the pool for every chunk, then
+     *        sink(chunk, out) for each in file order
+     *
+     * `out` is a reused buffer, cleared before each transform. Sinks never
+     * run concurrently; whichever thread finishes the chunk the sink is
+     * waiting for runs it, and then any later chunks already done. A chunk
+     * isn't started until the one `window` chunks before it has been sunk.
+     * A sink returning false stops the run.
+     * @return false if a sink failed
+     */
+    template <typename Transform, typename Sink>
+    bool for_each_chunk_ordered(ThreadPool& pool, Transform&& transform, Sink&& sink) const {
+        const size_t chunks = chunk_count();
+        const size_t window = 4 * (pool.workers() + 1);
+        std::vector<Slot> slots(window);
+
+        std::mutex mutex;
+        std::condition_variable sunk;
+        size_t next_sink = 0;       // Guarded by mutex
+        size_t end = chunks;        // First chunk not to sink (torn or failed), guarded by mutex
+        bool sinking = false;       // A thread is running sinks, guarded by mutex
+        bool failed = false;
+
+        pool.parallel_for(chunks, [&](size_t chunk) {
+            Slot& slot = slots[chunk % window];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                sunk.wait(lock, [&] { return chunk < next_sink + window || chunk >= end; });
+                if (chunk >= end) return;
+            }
+
+            const bool intact = decode_chunk(chunk, slot.frames);
+            slot.out.clear();
+            transform(slot.frames.data(), slot.frames.size(), slot.out);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            slot.ready = true;
+            if (!intact) end = std::min(end, chunk + 1);
+            if (sinking || chunk != next_sink) return;
+
+            // Sink this chunk and every finished one after it, in order
+            sinking = true;
+            while (next_sink < end && slots[next_sink % window].ready) {
+                Slot& done = slots[next_sink % window];
+                lock.unlock();
+                const bool ok = sink(next_sink, static_cast<const std::vector<char>&>(done.out));
+                lock.lock();
+                done.ready = false;
+                if (!ok) {
+                    failed = true;
+                    end = next_sink;
+                }
+                next_sink++;
+                sunk.notify_all();
+            }
+            sinking = false;
+        });
+        return !failed;
+    }
+
+private:
+    struct Slot {
+        std::vector<TelemetryFrame> frames;
+        std::vector<char> out;
+        bool ready = false;
+    };
+
+    size_t block_offset(size_t block) const {
+        return header_.header_bytes + block * RECORDING_BLOCK_BYTES;
+    }
+
+    static void lower(std::atomic<size_t>& value, size_t to) {
+        size_t current = value.load(std::memory_order_relaxed);
+        while (to < current && !value.compare_exchange_weak(current, to, std::memory_order_relaxed)) {
+        }
+    }
+
+    MappedFile file_;
+    RecordingHeader header_;
+    size_t blocks_ = 0;
+};
+
+// ============================================================================
+// Parallel Export
+// ============================================================================
+
+enum class ExportLayout : uint8_t {
+    Single,  // One file, chunks in order
+    Parts    // One file per chunk (<stem>.partNNNNN.<ext>), written as chunks finish
+};
+
+struct ParallelExportStats {
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    size_t parts = 0;
+};
+
+inline std::string export_part_path(const std::string& path, size_t part) {
+    std::filesystem::path p(path);
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".part%05zu", part);
+    const std::string extension = p.extension().string();
+    return p.replace_extension().string() + suffix + extension;
+}
+
+/**
+ * @brief Export a recording as CSV/JSON/NDJSON with every pool thread
+ *        formatting chunks
+ *
+ * Single: the output is byte for byte what TelemetryExporter writes.
+ * Parts: each part is a complete file of its own (CSV header, JSON array).
+ * @return false (with `error` set) if a file can't be written
+ */
+inline bool export_recording(const RecordingReader& reader, ThreadPool& pool, const ExportOptions& options,
+                             const std::string& path, ExportLayout layout, ParallelExportStats& stats,
+                             std::string& error) {
+    const ExportFormatter formatter(options);
+    stats = {};
+    std::atomic<uint64_t> frames{0};
+
+    auto write_file = [](FILE* file, const char* data, size_t bytes) {
+        return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+    };
+
+    if (layout == ExportLayout::Parts) {
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<int> failure{0};
+        const size_t kept = reader.for_each_chunk(pool, [&](size_t chunk, const TelemetryFrame* chunk_frames, size_t count) {
+            thread_local std::vector<char> out;
+            out.clear();
+            const std::string begin = formatter.begin();
+            out.insert(out.end(), begin.begin(), begin.end());
+            const size_t rows = formatter.rows(chunk_frames, count, out);
+            if (rows > 0 && formatter.first_row_skip() > 0) {
+                out.erase(out.begin() + static_cast<std::ptrdiff_t>(begin.size()),
+                          out.begin() + static_cast<std::ptrdiff_t>(begin.size() + formatter.first_row_skip()));
+            }
+            const std::string_view end = formatter.end(rows > 0);
+            out.insert(out.end(), end.begin(), end.end());
+
+            FILE* file = std::fopen(export_part_path(path, chunk).c_str(), "wb");
+            const bool ok = file && write_file(file, out.data(), out.size());
+            if ((!file || std::fclose(file) != 0 || !ok) && failure.load() == 0) {
+                failure.store(errno != 0 ? errno : EIO);
+            }
+            frames.fetch_add(rows, std::memory_order_relaxed);
+            bytes.fetch_add(out.size(), std::memory_order_relaxed);
+        });
+        // Parts past a torn block aren't part of the recording's intact prefix
+        for (size_t chunk = kept; chunk < reader.chunk_count(); ++chunk) {
+            std::remove(export_part_path(path, chunk).c_str());
+        }
+        stats.frames = frames.load();
+        stats.bytes = bytes.load();
+        stats.parts = kept;
+        if (failure.load() != 0) {
+            error = "cannot write parts of " + path + ": " + std::strerror(failure.load());
+            return false;
+        }
+        return true;
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IONBF, 0);  // Chunks are written whole
+
+    const std::string begin = formatter.begin();
+    bool ok = write_file(file, begin.data(), begin.size());
+    stats.bytes = begin.size();
+    ok = reader.for_each_chunk_ordered(pool,
+        [&](const TelemetryFrame* chunk_frames, size_t count, std::vector<char>& out) {
+            frames.fetch_add(formatter.rows(chunk_frames, count, out), std::memory_order_relaxed);
+        },
+        [&](size_t, const std::vector<char>& out) {
+            // Runs in file order: the first row written skips its separator
+            const size_t skip = stats.bytes == begin.size() ? std::min(formatter.first_row_skip(), out.size()) : 0;
+            stats.bytes += out.size() - skip;
+            return write_file(file, out.data() + skip, out.size() - skip);
+        }) && ok;
+    stats.frames = frames.load();
+
+    const std::string_view end = formatter.end(stats.frames > 0);
+    ok = write_file(file, end.data(), end.size()) && ok;
+    stats.bytes += end.size();
+    stats.parts = 1;
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        error = "cannot write " + path + ": " + std::strerror(errno != 0 ? errno : EIO);
+    }
+    return ok;
+}
+
+} // namespace f1sim
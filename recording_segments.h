@@ -0,0 +1,418 @@
+#pragma once
+
+#include "recording_format.h"
+#include "recording_index.h"
+#include "mapped_file.h"
+#include "async_file_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Segmented Recordings
+//
+// A long recording can be split into segments: race.seg00000.f1rec,
+// race.seg00001.f1rec, ... Each segment is a complete recording of its own
+// (header, blocks numbered from 0, its own index sidecar), so replay, export
+// and recovery work on any one of them; the header's `segment` field says
+// where it falls in the run.
+// ============================================================================
+
+// Space reserved ahead for a segment rotated by time only
+constexpr uint64_t SEGMENT_PREALLOCATE_BYTES = 64ull << 20;
+
+/**
+ * @brief When to start a new segment and how many old ones to keep
+ *
+ * Zero means no limit. Rotation happens on block boundaries, so a segment
+ * ends within a block of max_ms. Retention only ever deletes closed
+ * segments, and never the newest of them.
+ */
+struct SegmentPolicy {
+    uint64_t max_bytes = 0;     // Rotate before a segment grows past this
+    uint32_t max_ms = 0;        // Rotate once a segment spans this much race time
+    size_t keep_segments = 0;   // Delete the oldest closed segments beyond this many...
+    uint64_t keep_bytes = 0;    // ... or beyond this many bytes in total
+    bool overwrite = false;     // Replace an earlier run's segments instead of refusing to start
+
+    bool enabled() const { return max_bytes > 0 || max_ms > 0; }
+};
+
+inline std::string recording_segment_path(const std::string& path, uint32_t segment) {
+    std::filesystem::path p(path);
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".seg%05u", segment);
+    const std::string extension = p.extension().string();
+    return p.replace_extension().string() + suffix + extension;
+}
+
+/**
+ * @brief Existing segments of the recording at `path`, oldest first
+ */
+inline std::vector<std::string> find_recording_segments(const std::string& path) {
+    const std::filesystem::path p(path);
+    const std::string stem = p.stem().string() + ".seg";
+    const std::string extension = p.extension().string();
+    const std::filesystem::path dir = p.has_parent_path() ? p.parent_path() : std::filesystem::path(".");
+
+    std::vector<std::pair<uint32_t, std::string>> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= stem.size() + extension.size() || name.compare(0, stem.size(), stem) != 0 ||
+            name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        const std::string_view digits(name.data() + stem.size(), name.size() - stem.size() - extension.size());
+        if (digits.size() < 5 || digits.find_first_not_of("0123456789") != std::string_view::npos) continue;
+        found.emplace_back(static_cast<uint32_t>(std::strtoul(std::string(digits).c_str(), nullptr, 10)),
+                           p.has_parent_path() ? (dir / name).string() : name);
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::string> paths;
+    for (auto& [segment, segment_path] : found) {
+        paths.push_back(std::move(segment_path));
+    }
+    return paths;
+}
+
+// ============================================================================
+// Recovery
+// ============================================================================
+
+struct RecoveryStats {
+    uint64_t blocks = 0;        // Intact blocks kept
+    uint64_t frames = 0;
+    uint64_t bytes_before = 0;
+    uint64_t bytes_after = 0;   // Less than bytes_before if the tail was cut off
+};
+
+/**
+ * @brief Cut a recording back to its last intact block
+ *
+ * After a crash the end of a recording can hold a half-written block, a
+ * hole (writes complete out of order) or preallocated zeros. Blocks are
+ * checked in order - checksum, sequence number, and that the payload
+ * decodes - and the file is truncated after the last good one, which is
+ * exactly the prefix playback would have shown. A stale index sidecar is
+ * removed with it.
+ * @return false (with `error` set) if the file isn't a recording or can't
+ *         be truncated
+ */
+inline bool recover_recording(const std::string& path, RecoveryStats& stats, std::string& error) {
+    stats = {};
+    {
+        MappedFile file;
+        if (!file.open(path, MADV_SEQUENTIAL)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        RecordingHeader header;
+        if (file.size() < sizeof(header)) {
+            error = "not a telemetry recording";
+            return false;
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (!check_recording_header(header, file.size(), error)) return false;
+
+        const uint64_t blocks = (file.size() - header.header_bytes) / RECORDING_BLOCK_BYTES;
+        for (; stats.blocks < blocks; ++stats.blocks) {
+            const unsigned char* block = file.data() + header.header_bytes + stats.blocks * RECORDING_BLOCK_BYTES;
+            RecordingBlockHeader block_header;
+            std::memcpy(&block_header, block, sizeof(block_header));
+            if (!verify_recording_block(block) || block_header.sequence != stats.blocks ||
+                !decode_recording_block(block, header.encoding, [](const TelemetryFrame&) {})) {
+                break;
+            }
+            stats.frames += block_header.frame_count;
+        }
+        stats.bytes_before = file.size();
+        stats.bytes_after = header.header_bytes + stats.blocks * RECORDING_BLOCK_BYTES;
+    }
+
+    if (stats.bytes_after < stats.bytes_before) {
+        if (::truncate(path.c_str(), static_cast<off_t>(stats.bytes_after)) != 0) {
+            error = "cannot truncate " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        std::remove(recording_index_path(path).c_str());
+    }
+    return true;
+}
+
+// ============================================================================
+// Segment Rotator - Opens and Closes Segments off the Recorder Thread
+// ============================================================================
+
+/**
+ * @brief Rotator counters, read after stop()
+ */
+struct SegmentStats {
+    uint32_t segments = 0;       // Segments written
+    uint32_t deleted = 0;        // Removed by the retention policy
+    uint32_t replaced = 0;       // An earlier run's segments removed at start (overwrite)
+    uint64_t index_bytes = 0;    // All segments' index sidecars
+    int error = 0;               // errno of the first segment that couldn't be created, 0 if none
+};
+
+/**
+ * @brief Hands a TelemetryRecorder ready-made segment files
+ *
+ * A helper thread keeps the next segment ready at all times: created
+ * (O_DIRECT where possible), header written, and space preallocated with
+ * fallocate(FALLOC_FL_KEEP_SIZE) so its blocks needn't be allocated
+ * during the writes while the file size still only covers what was
+ * written. Rotating is then take() and a descriptor swap on the recorder
+ * thread.
+ *
+ * Segments handed back with retire() are finished on the same thread: the
+ * unused preallocation trimmed, the data synced, the index finished and
+ * saved, and the retention policy applied.
+ */
+class SegmentRotator {
+public:
+    struct Segment {
+        int fd = -1;
+        bool direct_io = false;
+        uint32_t number = 0;
+        std::string path;
+    };
+
+    SegmentRotator() = default;
+
+    ~SegmentRotator() {
+        stop();
+    }
+
+    SegmentRotator(const SegmentRotator&) = delete;
+    SegmentRotator& operator=(const SegmentRotator&) = delete;
+
+    /**
+     * @brief Start preparing segment 0
+     *
+     * Segments an earlier run left at `path` are only removed with
+     * policy.overwrite; otherwise nothing is touched and start() fails.
+     * @return false (with `error` set) if earlier segments are in the way
+     */
+    bool start(const std::string& path, const RecordingHeader& header, const SegmentPolicy& policy,
+               std::string& error) {
+        const std::vector<std::string> old = find_recording_segments(path);
+        if (!old.empty() && !policy.overwrite) {
+            error = std::to_string(old.size()) + " segment(s) of an earlier recording exist (" + old.front() +
+                    (old.size() > 1 ? " to " + old.back() : "") + ")";
+            return false;
+        }
+        for (const std::string& segment : old) {
+            std::remove(segment.c_str());
+            std::remove(recording_index_path(segment).c_str());
+        }
+        stats_.replaced = static_cast<uint32_t>(old.size());
+
+        path_ = path;
+        header_ = header;
+        policy_ = policy;
+        thread_ = std::thread([this] { run(); });
+        return true;
+    }
+
+    /**
+     * @brief Take the next segment, waiting if it isn't ready yet
+     * @return false (with errno in stats().error) if it couldn't be created
+     */
+    bool take(Segment& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        ready_.wait(lock, [this] { return prepared_.fd >= 0 || stats_.error != 0; });
+        if (prepared_.fd < 0) return false;
+        out = std::move(prepared_);
+        prepared_ = Segment{};
+        stats_.segments++;
+        work_.notify_one();  // Start on the one after
+        return true;
+    }
+
+    /**
+     * @brief Hand back a finished segment (its descriptor, or -1 if already
+     *        closed) to be trimmed to `bytes`, synced and indexed
+     * @param save_index False if the segment's writes failed
+     */
+    void retire(Segment segment, uint64_t bytes, RecordingIndex index, uint32_t blocks,
+                uint64_t last_checksum, bool save_index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back({std::move(segment), bytes, std::move(index), blocks, last_checksum, save_index});
+        work_.notify_one();
+    }
+
+    /**
+     * @brief Finish every retired segment, drop the unused prepared one and
+     *        join the helper
+     */
+    void stop() {
+        if (!thread_.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_.notify_one();
+        thread_.join();
+    }
+
+    const SegmentStats& stats() const { return stats_; }
+
+private:
+    struct Retired {
+        Segment segment;
+        uint64_t bytes = 0;
+        RecordingIndex index;
+        uint32_t blocks = 0;
+        uint64_t last_checksum = 0;
+        bool save_index = false;
+    };
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            const bool prepare = !stopping_ && prepared_.fd < 0 && stats_.error == 0;
+            if (prepare) {
+                Segment segment;
+                segment.number = next_number_++;
+                segment.path = recording_segment_path(path_, segment.number);
+                lock.unlock();
+                const int err = create(segment);
+                lock.lock();
+                if (err != 0) {
+                    stats_.error = err;
+                } else {
+                    prepared_ = std::move(segment);
+                }
+                ready_.notify_one();
+            } else if (!retired_.empty()) {
+                Retired retired = std::move(retired_.front());
+                retired_.pop_front();
+                lock.unlock();
+                close(retired);
+                lock.lock();
+            } else if (stopping_) {
+                break;
+            } else {
+                work_.wait(lock);
+            }
+        }
+
+        if (prepared_.fd >= 0) {
+            ::close(prepared_.fd);
+            std::remove(prepared_.path.c_str());
+            prepared_ = Segment{};
+        }
+        ready_.notify_all();
+    }
+
+    // Returns 0 or an errno
+    int create(Segment& segment) {
+        segment.fd = create_output_file(segment.path, segment.direct_io);
+        if (segment.fd < 0) return errno;
+
+        // Header padded to a full alignment unit so blocks start aligned
+        std::unique_ptr<unsigned char, decltype(&std::free)> buffer(
+            static_cast<unsigned char*>(std::aligned_alloc(WRITE_BUFFER_ALIGNMENT, RECORDING_ALIGNMENT)), &std::free);
+        if (!buffer) return fail(segment, ENOMEM);
+        RecordingHeader header = header_;
+        header.segment = segment.number;
+        std::memset(buffer.get(), 0, RECORDING_ALIGNMENT);
+        std::memcpy(buffer.get(), &header, sizeof(header));
+
+        ssize_t n = ::pwrite(segment.fd, buffer.get(), RECORDING_ALIGNMENT, 0);
+        if (n < 0 && errno == EINVAL && segment.direct_io) {
+            fcntl(segment.fd, F_SETFL, fcntl(segment.fd, F_GETFL) & ~O_DIRECT);
+            segment.direct_io = false;
+            n = ::pwrite(segment.fd, buffer.get(), RECORDING_ALIGNMENT, 0);
+        }
+        if (n != static_cast<ssize_t>(RECORDING_ALIGNMENT)) return fail(segment, n < 0 ? errno : EIO);
+
+        // Best effort: without it the filesystem allocates as the writes land
+        const uint64_t reserve = policy_.max_bytes > 0 ? policy_.max_bytes : SEGMENT_PREALLOCATE_BYTES;
+        (void)::fallocate(segment.fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(reserve));
+        return 0;
+    }
+
+    static int fail(Segment& segment, int err) {
+        ::close(segment.fd);
+        std::remove(segment.path.c_str());
+        segment.fd = -1;
+        return err;
+    }
+
+    void close(Retired& retired) {
+        const Segment& segment = retired.segment;
+        if (segment.fd >= 0) {
+            (void)::ftruncate(segment.fd, static_cast<off_t>(retired.bytes));  // Releases the preallocation
+            (void)::fdatasync(segment.fd);
+            ::close(segment.fd);
+        } else {
+            (void)::truncate(segment.path.c_str(), static_cast<off_t>(retired.bytes));
+        }
+
+        if (retired.save_index) {
+            retired.index.finish(retired.blocks, retired.last_checksum);
+            std::string error;
+            if (retired.index.save(recording_index_path(segment.path), error)) {
+                stats_.index_bytes += retired.index.bytes();
+            }
+        }
+
+        closed_.push_back({segment.path, retired.bytes});
+        closed_bytes_ += retired.bytes;
+        auto over = [this] {
+            return (policy_.keep_segments > 0 && closed_.size() > policy_.keep_segments) ||
+                   (policy_.keep_bytes > 0 && closed_bytes_ > policy_.keep_bytes);
+        };
+        while (closed_.size() > 1 && over()) {
+            std::remove(closed_.front().path.c_str());
+            std::remove(recording_index_path(closed_.front().path).c_str());
+            closed_bytes_ -= closed_.front().bytes;
+            closed_.pop_front();
+            stats_.deleted++;
+        }
+    }
+
+    struct Closed {
+        std::string path;
+        uint64_t bytes = 0;
+    };
+
+    std::string path_;
+    RecordingHeader header_;
+    SegmentPolicy policy_;
+
+    std::mutex mutex_;
+    std::condition_variable work_;    // Helper: something to prepare, retire, or stop
+    std::condition_variable ready_;   // Recorder: a prepared segment (or a failure)
+    Segment prepared_;                // Guarded by mutex_
+    std::deque<Retired> retired_;     // Guarded by mutex_
+    uint32_t next_number_ = 0;        // Guarded by mutex_
+    bool stopping_ = false;           // Guarded by mutex_
+    SegmentStats stats_;              // error and segments guarded by mutex_; the rest the helper's
+
+    std::deque<Closed> closed_;       // Helper thread only: oldest first
+    uint64_t closed_bytes_ = 0;
+    std::thread thread_;
+};
+
+} // namespace f1sim
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "recording_format.h"
+#include "recording_index.h"
+#include "mapped_file.h"
+#include "ring_buffer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <thread>
+
+namespace f1sim {
+
+// ============================================================================
+// Replay Source - Recorded Race Back Into the UI's Ring
+// ============================================================================
+
+constexpr double MIN_REPLAY_SPEED = 0.25;
+constexpr double MAX_REPLAY_SPEED = 1000.0;
+
+// Blocks requested from disk ahead of the one playing (1 MiB, ~1,000 ticks)
+constexpr size_t REPLAY_READAHEAD_BLOCKS = 16;
+
+/**
+ * @brief Plays a recording into a RingBuffer in place of RaceEngine, paced by
+ *        the frames' timestamp_ms
+ *
+ * The file is memory-mapped and never read up front: open() looks at the
+ * header (and the sidecar index, if there is one), a seek is a binary
+ * search over block headers (fixed-size blocks, so block n is at a known
+ * offset) or an index lookup, and playback prefetches the blocks just
+ * ahead of it - a multi-GB recording starts instantly. Raw blocks are
+ * pushed straight from the mapping into the ring; delta blocks are decoded
+ * from the mapping one frame at a time. Either way no file data is staged
+ * in an intermediate buffer.
+ *
+ * Speed and seek requests may come from any thread; they take effect at the
+ * next tick boundary. Playback stops at the end of the file, at the first
+ * torn or corrupt block, on the stop flag, or when the ring shuts down.
+ */
+class ReplaySource {
+public:
+    using clock = std::chrono::steady_clock;
+
+    ReplaySource(RingBuffer<TelemetryFrame>& ring_buffer, std::atomic<bool>& stop_flag)
+        : ring_buffer_(ring_buffer)
+        , stop_flag_(stop_flag)
+    {
+    }
+
+    /**
+     * @brief Map a recording and check its header
+     * @return false (with `error` set) if it isn't a playable recording
+     */
+    bool open(const std::string& path, std::string& error) {
+        if (!file_.open(path, MADV_RANDOM)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        if (file_.size() < sizeof(header_)) {
+            error = "not a telemetry recording";
+            return false;
+        }
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (!check_recording_header(header_, file_.size(), error)) return false;
+
+        blocks_ = (file_.size() - header_.header_bytes) / RECORDING_BLOCK_BYTES;
+        path_ = path;
+
+        // A missing or stale sidecar index just means seeks search block headers
+        std::string index_error;
+        if (!index_.load(recording_index_path(path), index_error) || !index_.matches(file_)) {
+            index_ = RecordingIndex();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Rebuild the sidecar index from the recording and save it
+     * @return false (with `error` set) if it can't be saved; the rebuilt
+     *         index is used for this replay either way
+     */
+    bool rebuild_index(std::string& error) {
+        if (!index_.build(file_, error)) return false;
+        return index_.save(recording_index_path(path_), error);
+    }
+
+    // Empty unless a matching sidecar was found or rebuild_index() ran
+    const RecordingIndex& index() const { return index_; }
+
+    const RecordingHeader& header() const { return header_; }
+    size_t block_count() const { return blocks_; }
+
+    // Race time of the last frame, from the last intact block's header
+    uint32_t duration_ms() const {
+        for (size_t b = blocks_; b > 0; --b) {
+            RecordingBlockHeader header;
+            if (block_header(b - 1, header)) return header.last_timestamp_ms;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Playback speed as a multiple of real time, clamped to
+     *        [MIN_REPLAY_SPEED, MAX_REPLAY_SPEED]
+     */
+    void set_speed(double multiplier) {
+        speed_.store(std::clamp(multiplier, MIN_REPLAY_SPEED, MAX_REPLAY_SPEED), std::memory_order_release);
+    }
+
+    double speed() const { return speed_.load(std::memory_order_acquire); }
+
+    // Continue from the first tick at or after `timestamp_ms`
+    void seek(uint32_t timestamp_ms) {
+        seek_target_.store(timestamp_ms, std::memory_order_relaxed);
+        seek_pending_.store(true, std::memory_order_release);
+    }
+
+    // Continue from an index lookup: its block is read without any search
+    void seek(const RecordingPosition& position) {
+        seek_target_.store((uint64_t{position.block} + 1) << 32 | position.timestamp_ms, std::memory_order_relaxed);
+        seek_pending_.store(true, std::memory_order_release);
+    }
+
+    uint64_t frames_played() const { return frames_played_.load(std::memory_order_relaxed); }
+
+    // Race time of the tick being played
+    uint32_t position_ms() const { return position_ms_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Push frames until the recording ends or playback is stopped
+     */
+    void run() {
+        size_t block = 0;
+        size_t seek_block = 0;
+        uint32_t skip_until = 0;
+        anchored_ = false;
+
+        while (!stop_flag_.load(std::memory_order_acquire)) {
+            if (seek_pending_.exchange(false, std::memory_order_acq_rel)) {
+                const uint64_t target = seek_target_.load(std::memory_order_relaxed);
+                skip_until = static_cast<uint32_t>(target);
+                block = (target >> 32) > 0 ? (target >> 32) - 1 : find_block(skip_until);
+                seek_block = block;
+                anchored_ = false;
+            }
+            if (block >= blocks_) break;
+
+            // Keep the next blocks on their way; the mapping itself does no
+            // read-ahead, so a seek's binary search reads only what it probes
+            if (block % REPLAY_READAHEAD_BLOCKS == 0 || block == seek_block) {
+                file_.prefetch(block_offset(block), REPLAY_READAHEAD_BLOCKS * 2 * RECORDING_BLOCK_BYTES);
+            }
+
+            const unsigned char* data = file_.data() + block_offset(block);
+            if (!verify_recording_block(data)) break;  // Torn tail or corruption
+
+            const PlayResult result = play_block(data, skip_until);
+            if (result == PlayResult::Stopped) break;
+            if (result == PlayResult::Finished) block++;
+            // Interrupted: a seek is pending, picked up at the top
+        }
+    }
+
+private:
+    enum class PlayResult : uint8_t { Finished, Interrupted, Stopped };
+
+    size_t block_offset(size_t block) const {
+        return header_.header_bytes + block * RECORDING_BLOCK_BYTES;
+    }
+
+    bool block_header(size_t block, RecordingBlockHeader& header) const {
+        std::memcpy(&header, file_.data() + block_offset(block), sizeof(header));
+        return header.magic == RECORDING_BLOCK_MAGIC && header.frame_count > 0;
+    }
+
+    // Last block starting before `timestamp_ms` (block 0 if none): the tick
+    // starts in it or at the top of the next. The sidecar index, if loaded,
+    // narrows the search to the blocks between two of its time entries.
+    size_t find_block(uint32_t timestamp_ms) const {
+        size_t lo = 0;
+        size_t hi = blocks_;
+        uint32_t first_block = 0;
+        uint32_t last_block = 0;
+        if (index_.time_blocks(timestamp_ms, first_block, last_block) && last_block < blocks_) {
+            lo = first_block;
+            hi = size_t{last_block} + 1;
+        }
+        while (hi - lo > 1) {
+            const size_t mid = lo + (hi - lo) / 2;
+            RecordingBlockHeader header;
+            const uint32_t first = block_header(mid, header) ? header.first_timestamp_ms
+                                                             : std::numeric_limits<uint32_t>::max();
+            if (first < timestamp_ms) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    PlayResult play_block(const unsigned char* block, uint32_t skip_until) {
+        RecordingBlockHeader header;
+        std::memcpy(&header, block, sizeof(header));
+        const unsigned char* payload = block + sizeof(header);
+
+        if (header_.encoding == RecordingEncoding::Raw) {
+            if (header.payload_bytes != header.frame_count * sizeof(TelemetryFrame)) return PlayResult::Stopped;
+            const auto* frames = reinterpret_cast<const TelemetryFrame*>(payload);
+            for (uint32_t i = 0; i < header.frame_count; ++i) {
+                const PlayResult result = play(frames[i], skip_until);
+                if (result != PlayResult::Finished) return result;
+            }
+            return PlayResult::Finished;
+        }
+        if (header_.encoding == RecordingEncoding::Compact) {
+            if (header.payload_bytes != header.frame_count * sizeof(CompactTelemetryFrame)) return PlayResult::Stopped;
+            const auto* frames = reinterpret_cast<const CompactTelemetryFrame*>(payload);
+            for (uint32_t i = 0; i < header.frame_count; ++i) {
+                const PlayResult result = play(from_compact(frames[i]), skip_until);
+                if (result != PlayResult::Finished) return result;
+            }
+            return PlayResult::Finished;
+        }
+
+        FrameDecoder decoder;
+        const uint8_t* p = payload;
+        const uint8_t* end = payload + header.payload_bytes;
+        TelemetryFrame frame;
+        for (uint32_t i = 0; i < header.frame_count; ++i) {
+            if (!decoder.decode(p, end, frame)) return PlayResult::Stopped;
+            const PlayResult result = play(frame, skip_until);
+            if (result != PlayResult::Finished) return result;
+        }
+        return PlayResult::Finished;
+    }
+
+    // Paces at each new tick, then pushes the frame
+    PlayResult play(const TelemetryFrame& frame, uint32_t skip_until) {
+        if (frame.timestamp_ms < skip_until) return PlayResult::Finished;
+
+        if (!anchored_ || frame.timestamp_ms != position_ms_.load(std::memory_order_relaxed)) {
+            if (seek_pending_.load(std::memory_order_acquire)) return PlayResult::Interrupted;
+            if (stop_flag_.load(std::memory_order_acquire)) return PlayResult::Stopped;
+            pace(frame.timestamp_ms);
+        }
+
+        if (!ring_buffer_.push(frame)) return PlayResult::Stopped;
+        frames_played_.fetch_add(1, std::memory_order_relaxed);
+        return PlayResult::Finished;
+    }
+
+    // Sleep until `timestamp_ms` is due; re-anchors after a seek or a speed change
+    void pace(uint32_t timestamp_ms) {
+        const double speed = speed_.load(std::memory_order_acquire);
+        const auto now = clock::now();
+        if (!anchored_ || speed != anchor_speed_ || timestamp_ms < anchor_ms_) {
+            anchored_ = true;
+            anchor_speed_ = speed;
+            anchor_ms_ = timestamp_ms;
+            anchor_time_ = now;
+        }
+        position_ms_.store(timestamp_ms, std::memory_order_relaxed);
+
+        const auto due = anchor_time_ + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double, std::milli>((timestamp_ms - anchor_ms_) / speed));
+        if (due > now) {
+            std::this_thread::sleep_until(due);
+        }
+    }
+
+    RingBuffer<TelemetryFrame>& ring_buffer_;
+    std::atomic<bool>& stop_flag_;
+    MappedFile file_;
+    RecordingHeader header_;
+    size_t blocks_ = 0;
+    std::string path_;
+    RecordingIndex index_;
+
+    std::atomic<double> speed_{1.0};
+    std::atomic<uint64_t> seek_target_{0};  // Block + 1 (0: search) << 32 | race time
+    std::atomic<bool> seek_pending_{false};
+    std::atomic<uint64_t> frames_played_{0};
+    std::atomic<uint32_t> position_ms_{0};
+
+    // Playback thread only: wall-clock time at which anchor_ms_ was played
+    bool anchored_ = false;
+    double anchor_speed_ = 1.0;
+    uint32_t anchor_ms_ = 0;
+    clock::time_point anchor_time_;
+};
+
+} // namespace f1sim
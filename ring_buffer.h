@@ -1,6 +1,7 @@
 #ifndef RING_BUFFER_H
 #define RING_BUFFER_H
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <condition_variable>
@@ -12,8 +13,9 @@
  * @tparam T Element type (should be trivially copyable)
  * @tparam Capacity Buffer capacity (default 1024)
  * 
- * Producer: push() - blocks if full
- * Consumer: pop() - blocks if empty, try_pop() - returns immediately
+ * Producer: push() - blocks if full, try_push() - drops instead of waiting
+ * Consumer: pop() - blocks if empty, try_pop() - returns immediately,
+ *           pop_batch() - blocks until at least one element, takes up to N
  */
 template <typename T, size_t Capacity = 1024>
 class RingBuffer {
@@ -56,6 +58,25 @@ public:
         return true;
     }
 
+    /**
+     * @brief Push element without waiting for space
+     * @return false if the buffer is full or shut down (element not stored)
+     */
+    bool try_push(const T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        
+        if (is_full_unsafe() || shutdown_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        buffer_[head_] = item;
+        head_ = (head_ + 1) % Capacity;
+        
+        lock.unlock();
+        cv_not_empty_.notify_one();
+        return true;
+    }
+
     /**
      * @brief Pop element from buffer (blocks if empty)
      * @param item Output parameter for popped element
@@ -101,6 +122,35 @@ public:
         return item;
     }
 
+    /**
+     * @brief Pop up to `max` elements at once (blocks until at least one)
+     * @param out Destination for the popped elements, oldest first
+     * @return Number popped; 0 only once shut down and drained
+     */
+    size_t pop_batch(T* out, size_t max) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        
+        cv_not_empty_.wait(lock, [this]() {
+            return head_ != tail_ || shutdown_.load(std::memory_order_acquire);
+        });
+
+        // At most two contiguous runs: up to the end of the array, then from 0
+        size_t count = 0;
+        while (count < max && head_ != tail_) {
+            size_t end = head_ > tail_ ? head_ : Capacity;
+            size_t run = std::min(end - tail_, max - count);
+            std::copy_n(buffer_.begin() + tail_, run, out + count);
+            tail_ = (tail_ + run) % Capacity;
+            count += run;
+        }
+        
+        lock.unlock();
+        if (count > 0) {
+            cv_not_full_.notify_one();
+        }
+        return count;
+    }
+
     /**
      * @brief Signal shutdown and wake all waiting threads
      */
@@ -1,72 +1,196 @@
 #pragma once
 
-#include <string>
+#include "telemetry_data.h"
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace f1sim {
 
+constexpr size_t NUM_TEAMS = NUM_DRIVERS / 2;
+constexpr size_t ROSTER_NAME_BYTES = 24;
+
+/**
+ * @brief Name stored inline in a fixed-width buffer
+ *
+ * No heap and no pointer to follow: the roster is plain bytes, built by the
+ * compiler and copied around (e.g. on a season reload) like any POD.
+ * Longer names are truncated.
+ */
+struct RosterName {
+    char chars[ROSTER_NAME_BYTES] = {};
+    uint8_t length = 0;
+
+    constexpr RosterName() = default;
+    constexpr RosterName(std::string_view s)
+        : length(static_cast<uint8_t>(std::min(s.size(), ROSTER_NAME_BYTES)))
+    {
+        for (size_t i = 0; i < length; ++i) chars[i] = s[i];
+    }
+
+    template <size_t N>
+    constexpr RosterName(const char (&s)[N]) : RosterName(std::string_view(s, N - 1)) {}
+
+    constexpr std::string_view view() const { return {chars, length}; }
+};
+
 // 2025 F1 Driver and Team Data
+struct TeamInfo {
+    RosterName name;
+    uint8_t color;          // xterm-256 colour index
+};
+
 struct DriverInfo {
-    std::string name;
-    std::string team;
-    std::string team_color; // ANSI color code
+    RosterName name;
+    uint8_t team;           // Index into TEAM_ROSTER
 };
 
-// ANSI 256-color codes for authentic F1 team colors
+/**
+ * @brief Everything the leaderboard needs to label a car
+ */
+struct Roster {
+    std::array<TeamInfo, NUM_TEAMS> teams;
+    std::array<DriverInfo, NUM_DRIVERS> drivers;
+};
+
+// ============================================================================
+// Team Colours
+// ============================================================================
+
+// xterm-256 indices for authentic F1 team colors
 namespace TeamColors {
-    constexpr const char* RED_BULL = "\033[38;5;18m";      // Dark blue
-    constexpr const char* FERRARI = "\033[38;5;196m";      // Bright red
-    constexpr const char* MCLAREN = "\033[38;5;208m";      // Orange
-    constexpr const char* MERCEDES = "\033[38;5;50m";      // Cyan/turquoise
-    constexpr const char* ASTON_MARTIN = "\033[38;5;34m";  // Green
-    constexpr const char* ALPINE = "\033[38;5;201m";       // Pink
-    constexpr const char* RACING_BULLS = "\033[38;5;27m";  // Blue
-    constexpr const char* HAAS = "\033[38;5;245m";         // Gray/white
-    constexpr const char* WILLIAMS = "\033[38;5;33m";      // Light blue
-    constexpr const char* KICK_SAUBER = "\033[38;5;46m";   // Bright green
+    constexpr uint8_t RED_BULL = 18;        // Dark blue
+    constexpr uint8_t FERRARI = 196;        // Bright red
+    constexpr uint8_t MCLAREN = 208;        // Orange
+    constexpr uint8_t MERCEDES = 50;        // Cyan/turquoise
+    constexpr uint8_t ASTON_MARTIN = 34;    // Green
+    constexpr uint8_t ALPINE = 201;         // Pink
+    constexpr uint8_t RACING_BULLS = 27;    // Blue
+    constexpr uint8_t HAAS = 245;           // Gray/white
+    constexpr uint8_t WILLIAMS = 33;        // Light blue
+    constexpr uint8_t KICK_SAUBER = 46;     // Bright green
 }
 
+/**
+ * @brief "\033[38;5;<n>m" for every xterm-256 colour, generated at compile time
+ */
+struct AnsiColorTable {
+    struct Escape {
+        char chars[12] = {};
+        uint8_t length = 0;
+    };
+    std::array<Escape, 256> escapes{};
+
+    constexpr AnsiColorTable() {
+        for (size_t n = 0; n < 256; ++n) {
+            Escape& e = escapes[n];
+            for (char c : std::string_view("\033[38;5;")) e.chars[e.length++] = c;
+            if (n >= 100) e.chars[e.length++] = static_cast<char>('0' + n / 100);
+            if (n >= 10) e.chars[e.length++] = static_cast<char>('0' + n / 10 % 10);
+            e.chars[e.length++] = static_cast<char>('0' + n % 10);
+            e.chars[e.length++] = 'm';
+        }
+    }
+
+    constexpr std::string_view operator[](uint8_t n) const {
+        return {escapes[n].chars, escapes[n].length};
+    }
+};
+
+inline constexpr AnsiColorTable ANSI_256;
+
+// ============================================================================
+// 2025 Roster
+// ============================================================================
+
+inline constexpr std::array<TeamInfo, NUM_TEAMS> TEAM_ROSTER = {{
+    {"Red Bull Racing", TeamColors::RED_BULL},
+    {"Ferrari", TeamColors::FERRARI},
+    {"McLaren", TeamColors::MCLAREN},
+    {"Mercedes", TeamColors::MERCEDES},
+    {"Aston Martin", TeamColors::ASTON_MARTIN},
+    {"Alpine", TeamColors::ALPINE},
+    {"Racing Bulls", TeamColors::RACING_BULLS},
+    {"Haas F1 Team", TeamColors::HAAS},
+    {"Williams Racing", TeamColors::WILLIAMS},
+    {"Kick Sauber", TeamColors::KICK_SAUBER}
+}};
+
 // 2025 F1 Driver Roster (20 drivers across 10 teams)
-constexpr std::array<DriverInfo, 20> DRIVER_ROSTER = {{
+inline constexpr std::array<DriverInfo, NUM_DRIVERS> DRIVER_ROSTER = {{
     // Red Bull Racing (Drivers 0-1)
-    {"M. Verstappen", "Red Bull Racing", TeamColors::RED_BULL},
-    {"S. Perez", "Red Bull Racing", TeamColors::RED_BULL},
-    
+    {"M. Verstappen", 0},
+    {"S. Perez", 0},
+
     // Ferrari (Drivers 2-3)
-    {"C. Leclerc", "Ferrari", TeamColors::FERRARI},
-    {"L. Hamilton", "Ferrari", TeamColors::FERRARI},
-    
+    {"C. Leclerc", 1},
+    {"L. Hamilton", 1},
+
     // McLaren (Drivers 4-5)
-    {"L. Norris", "McLaren", TeamColors::MCLAREN},
-    {"O. Piastri", "McLaren", TeamColors::MCLAREN},
-    
+    {"L. Norris", 2},
+    {"O. Piastri", 2},
+
     // Mercedes (Drivers 6-7)
-    {"G. Russell", "Mercedes", TeamColors::MERCEDES},
-    {"A. Antonelli", "Mercedes", TeamColors::MERCEDES},
-    
+    {"G. Russell", 3},
+    {"A. Antonelli", 3},
+
     // Aston Martin (Drivers 8-9)
-    {"F. Alonso", "Aston Martin", TeamColors::ASTON_MARTIN},
-    {"L. Stroll", "Aston Martin", TeamColors::ASTON_MARTIN},
-    
+    {"F. Alonso", 4},
+    {"L. Stroll", 4},
+
     // Alpine (Drivers 10-11)
-    {"P. Gasly", "Alpine", TeamColors::ALPINE},
-    {"J. Doohan", "Alpine", TeamColors::ALPINE},
-    
+    {"P. Gasly", 5},
+    {"J. Doohan", 5},
+
     // Racing Bulls (Drivers 12-13)
-    {"Y. Tsunoda", "Racing Bulls", TeamColors::RACING_BULLS},
-    {"I. Hadjar", "Racing Bulls", TeamColors::RACING_BULLS},
-    
+    {"Y. Tsunoda", 6},
+    {"I. Hadjar", 6},
+
     // Haas (Drivers 14-15)
-    {"E. Ocon", "Haas F1 Team", TeamColors::HAAS},
-    {"O. Bearman", "Haas F1 Team", TeamColors::HAAS},
-    
+    {"E. Ocon", 7},
+    {"O. Bearman", 7},
+
     // Williams (Drivers 16-17)
-    {"A. Albon", "Williams Racing", TeamColors::WILLIAMS},
-    {"C. Sainz", "Williams Racing", TeamColors::WILLIAMS},
-    
+    {"A. Albon", 8},
+    {"C. Sainz", 8},
+
     // Kick Sauber (Drivers 18-19)
-    {"N. Hulkenberg", "Kick Sauber", TeamColors::KICK_SAUBER},
-    {"G. Bortoleto", "Kick Sauber", TeamColors::KICK_SAUBER}
+    {"N. Hulkenberg", 9},
+    {"G. Bortoleto", 9}
 }};
 
+inline constexpr Roster DEFAULT_ROSTER{TEAM_ROSTER, DRIVER_ROSTER};
+
+static_assert(DRIVER_ROSTER[0].name.view() == "M. Verstappen", "Roster must be usable at compile time");
+static_assert(ANSI_256[TeamColors::FERRARI] == "\033[38;5;196m");
+
+/**
+ * @brief Generate an N-car roster at compile time ("Driver 1".."Driver N",
+ *        two per team, colours cycling through the 2025 teams)
+ *
+ * For large synthetic fields: no runtime construction, no allocation.
+ */
+template <size_t Cars>
+constexpr std::array<DriverInfo, Cars> make_generated_roster() {
+    std::array<DriverInfo, Cars> out{};
+    for (size_t i = 0; i < Cars; ++i) {
+        DriverInfo& d = out[i];
+        for (char c : std::string_view("Driver ")) d.name.chars[d.name.length++] = c;
+        char digits[20];
+        size_t count = 0;
+        size_t n = i + 1;
+        do {
+            digits[count++] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n > 0);
+        while (count > 0) d.name.chars[d.name.length++] = digits[--count];
+        d.team = static_cast<uint8_t>((i / 2) % NUM_TEAMS);
+    }
+    return out;
+}
+
+static_assert(make_generated_roster<200>()[199].name.view() == "Driver 200");
+
 } // namespace f1sim
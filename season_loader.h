@@ -0,0 +1,232 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include "season_data.h"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace f1sim {
+
+// ============================================================================
+// Season Data File
+//
+// Teams, drivers and their performance profiles in one text file:
+//
+//   team   <id> "<name>" <colour> <engine> <aero> <cooling> <reliability>
+//   driver <car> <team> "<name>" <aggression> <consistency> <tire_mgmt> <risk>
+//
+// '#' starts a comment. <colour> is an xterm-256 colour index; profile values
+// are 0.0-1.0. Every team id and every car slot must appear exactly once.
+// ============================================================================
+
+struct TeamRecord {
+    RosterName name;
+    uint8_t colour;              // xterm-256 index
+    CarProfile car;
+};
+
+struct DriverRecord {
+    RosterName name;
+    uint8_t team;                // Index into SeasonData::teams
+    DriverProfile profile;
+};
+
+/**
+ * @brief Everything parsed from a season file, in flat fixed-size arrays
+ *
+ * Trivially copyable: a reload builds a new one off the physics thread and
+ * hands over plain arrays, so swapping it in never allocates.
+ */
+struct SeasonData {
+    std::array<TeamRecord, NUM_TEAMS> teams{};
+    std::array<DriverRecord, NUM_DRIVERS> drivers{};
+
+    std::array<DriverProfile, NUM_DRIVERS> driver_profiles() const {
+        std::array<DriverProfile, NUM_DRIVERS> out;
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            out[i] = drivers[i].profile;
+        }
+        return out;
+    }
+
+    // Each driver gets their team's car
+    std::array<CarProfile, NUM_DRIVERS> car_profiles() const {
+        std::array<CarProfile, NUM_DRIVERS> out;
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            out[i] = teams[drivers[i].team].car;
+        }
+        return out;
+    }
+
+    Roster roster() const {
+        Roster out;
+        for (size_t i = 0; i < NUM_TEAMS; ++i) {
+            out.teams[i] = TeamInfo{teams[i].name, teams[i].colour};
+        }
+        for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+            out.drivers[i] = DriverInfo{drivers[i].name, drivers[i].team};
+        }
+        return out;
+    }
+};
+
+namespace season_detail {
+
+inline void skip_spaces(std::string_view& s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+}
+
+inline std::string_view next_word(std::string_view& s) {
+    skip_spaces(s);
+    size_t end = s.find_first_of(" \t");
+    std::string_view word = s.substr(0, end);
+    s.remove_prefix(end == std::string_view::npos ? s.size() : end);
+    return word;
+}
+
+template <typename T>
+bool parse_number(std::string_view& s, T& out) {
+    std::string_view word = next_word(s);
+    auto [end, ec] = std::from_chars(word.data(), word.data() + word.size(), out);
+    return ec == std::errc{} && end == word.data() + word.size();
+}
+
+inline bool parse_unit(std::string_view& s, float& out) {
+    return parse_number(s, out) && out >= 0.0f && out <= 1.0f;
+}
+
+inline bool parse_name(std::string_view& s, RosterName& out) {
+    skip_spaces(s);
+    if (s.empty() || s.front() != '"') return false;
+    size_t close = s.find('"', 1);
+    if (close == std::string_view::npos || close - 1 > ROSTER_NAME_BYTES) return false;
+    out = RosterName(s.substr(1, close - 1));
+    s.remove_prefix(close + 1);
+    return true;
+}
+
+} // namespace season_detail
+
+/**
+ * @brief Parse season text into `out`
+ * @return false with `error` set on the first bad or missing entry
+ */
+inline bool parse_season(std::string_view text, SeasonData& out, std::string& error) {
+    using namespace season_detail;
+
+    std::array<bool, NUM_TEAMS> have_team{};
+    std::array<bool, NUM_DRIVERS> have_driver{};
+    size_t line_number = 0;
+
+    while (!text.empty()) {
+        size_t eol = text.find('\n');
+        std::string_view line = text.substr(0, eol);
+        text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+        line_number++;
+
+        if (size_t hash = line.find('#'); hash != std::string_view::npos) {
+            line = line.substr(0, hash);
+        }
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+            line.remove_suffix(1);
+        }
+
+        std::string_view kind = next_word(line);
+        if (kind.empty()) continue;
+
+        bool ok = false;
+        if (kind == "team") {
+            size_t id = 0;
+            unsigned colour = 0;
+            TeamRecord team{};
+            ok = parse_number(line, id) && id < NUM_TEAMS && !have_team[id] &&
+                 parse_name(line, team.name) &&
+                 parse_number(line, colour) && colour < 256 &&
+                 parse_unit(line, team.car.engine_power) &&
+                 parse_unit(line, team.car.aero_efficiency) &&
+                 parse_unit(line, team.car.cooling_efficiency) &&
+                 parse_unit(line, team.car.reliability);
+            if (ok) {
+                team.colour = static_cast<uint8_t>(colour);
+                out.teams[id] = team;
+                have_team[id] = true;
+            }
+        } else if (kind == "driver") {
+            size_t car = 0;
+            size_t team = 0;
+            DriverRecord driver{};
+            ok = parse_number(line, car) && car < NUM_DRIVERS && !have_driver[car] &&
+                 parse_number(line, team) && team < NUM_TEAMS &&
+                 parse_name(line, driver.name) &&
+                 parse_unit(line, driver.profile.aggression) &&
+                 parse_unit(line, driver.profile.consistency) &&
+                 parse_unit(line, driver.profile.tire_management) &&
+                 parse_unit(line, driver.profile.risk_tolerance);
+            if (ok) {
+                driver.team = static_cast<uint8_t>(team);
+                out.drivers[car] = driver;
+                have_driver[car] = true;
+            }
+        }
+
+        skip_spaces(line);
+        if (!ok || !line.empty()) {
+            error = "bad season entry on line " + std::to_string(line_number);
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < NUM_TEAMS; ++i) {
+        if (!have_team[i]) {
+            error = "missing team " + std::to_string(i);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < NUM_DRIVERS; ++i) {
+        if (!have_driver[i]) {
+            error = "missing driver for car " + std::to_string(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Read and parse a season file
+ *
+ * `out` is only written on success, so a half-edited file never replaces the
+ * profiles in use. The file is read into memory rather than mapped: it is
+ * edited while the race runs, and a mapping truncated under the parser
+ * raises SIGBUS.
+ */
+inline bool load_season(const std::string& path, SeasonData& out, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string text;
+    char buffer[4096];
+    while (size_t n = std::fread(buffer, 1, sizeof(buffer), file)) {
+        text.append(buffer, n);
+    }
+    const bool read_ok = !std::ferror(file);
+    std::fclose(file);
+    if (!read_ok) {
+        error = "cannot read " + path;
+        return false;
+    }
+
+    SeasonData parsed;
+    if (!parse_season(text, parsed, error)) {
+        return false;
+    }
+    out = parsed;
+    return true;
+}
+
+} // namespace f1sim
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Per-tick State Hashing
+// ============================================================================
+
+/**
+ * @brief Cheap 64-bit chained hash of the simulation state
+ *
+ * Each tick folds the fields that drive the race (distance, speed, tire wear,
+ * lap, position, pit state) into the previous tick's hash, so two runs that
+ * agree on the final hash agreed on every tick before it. Floats are hashed by
+ * bit pattern: any divergence, however small, shows up on the tick it happens.
+ *
+ * Cost is a multiply and xor-shift per word, roughly 150 words per tick for
+ * 20 cars.
+ */
+class StateHasher {
+public:
+    static constexpr uint64_t SEED = 0xcbf29ce484222325ULL;
+
+    static constexpr uint64_t mix(uint64_t h, uint64_t value) {
+        h ^= value;
+        h *= 0x9e3779b97f4a7c15ULL;
+        h ^= h >> 32;
+        return h;
+    }
+
+    static uint64_t mix_float(uint64_t h, float value) {
+        return mix(h, std::bit_cast<uint32_t>(value));
+    }
+
+    static uint64_t hash_tick(uint64_t previous, const RaceState& state) {
+        uint64_t h = mix(previous, state.tick_count);
+        h = mix_float(h, state.race_time);
+        
+        for (const auto& car : state.cars) {
+            const auto& telemetry = car.telemetry;
+            h = mix_float(h, telemetry.distance);
+            h = mix_float(h, telemetry.speed);
+            h = mix_float(h, telemetry.gap_to_leader);
+            h = mix_float(h, telemetry.interval_to_ahead);
+            h = mix_float(h, car.tire_wear);
+            h = mix_float(h, car.pit_timer);
+            h = mix(h, (uint64_t{telemetry.current_lap} << 24) |
+                       (uint64_t{telemetry.position} << 16) |
+                       (uint64_t{car.pit_stops} << 8) |
+                       (uint64_t{car.drs_open} << 1) |
+                       uint64_t{car.in_pits});
+        }
+        return h;
+    }
+};
+
+/**
+ * @brief Preallocated per-tick hash log
+ *
+ * Capacity is reserved up front so recording from the physics thread never
+ * allocates; ticks beyond capacity are counted but not stored.
+ */
+class StateHashTrace {
+public:
+    explicit StateHashTrace(size_t capacity) {
+        hashes_.reserve(capacity);
+    }
+
+    void record(uint64_t hash) {
+        if (hashes_.size() < hashes_.capacity()) {
+            hashes_.push_back(hash);
+        } else {
+            dropped_++;
+        }
+    }
+
+    const std::vector<uint64_t>& hashes() const { return hashes_; }
+    uint64_t dropped() const { return dropped_; }
+
+private:
+    std::vector<uint64_t> hashes_;  // hashes_[i] is the hash after tick i + 1
+    uint64_t dropped_ = 0;
+};
+
+} // namespace f1sim
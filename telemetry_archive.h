@@ -0,0 +1,726 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include "telemetry_codec.h"
+#include "recording_format.h"
+#include "ring_buffer.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Columnar Telemetry Archive
+//
+//   [ArchiveHeader]
+//   [chunk][chunk]...
+//
+//   chunk = [ArchiveChunkHeader][ArchiveColumnHeader × ARCHIVE_COLUMNS]
+//           [column 0 data][column 1 data]...
+//
+// For post-race analysis: a scan of one field reads only that field's bytes
+// instead of every 64-byte frame. Frames are grouped into chunks of
+// chunk_ticks ticks (chunk n covers race time [n, n + 1) × chunk span).
+// Within a chunk rows are ordered by driver, then time, so each column is
+// twenty smooth per-car traces; every column is stored with whichever of
+// the ColumnEncodings suits it best, plus its min/max (to skip chunks
+// without decoding them) and a checksum.
+//
+// Integers are little-endian (host order on every supported target).
+// ============================================================================
+
+constexpr uint32_t ARCHIVE_MAGIC = 0x43524146;        // "FARC"
+constexpr uint32_t ARCHIVE_CHUNK_MAGIC = 0x4b484346;  // "FCHK"
+constexpr uint16_t ARCHIVE_VERSION = 1;
+constexpr uint32_t DEFAULT_ARCHIVE_CHUNK_TICKS = 500; // 10 s of race, 10,000 frames
+
+/**
+ * @brief One column per TelemetryFrame field (padding excluded)
+ */
+enum class ArchiveColumn : uint8_t {
+    Timestamp, Driver, Position, Lap, Sector, Speed, Distance, Throttle, TireWear,
+    PitStops, PitTimer, GapToLeader, Flags, Sector1, Sector2, Sector3, LastLapTime, IntervalCs
+};
+
+constexpr size_t ARCHIVE_COLUMNS = 18;
+
+enum class ColumnType : uint8_t { U8, U16, U32, F32 };
+
+constexpr size_t column_type_bytes(ColumnType type) {
+    switch (type) {
+        case ColumnType::U8:  return 1;
+        case ColumnType::U16: return 2;
+        case ColumnType::U32: return 4;
+        case ColumnType::F32: return 4;
+    }
+    return 4;
+}
+
+/**
+ * @brief How a column's values are stored in a chunk
+ *
+ * The varint encodings work on 32-bit values (floats by bit pattern) and
+ * zigzag differences, so all of them are exact.
+ */
+enum class ColumnEncoding : uint8_t {
+    Plain,         // Values at their field width
+    Constant,      // One value at field width, repeated frame_count times
+    DeltaOfDelta,  // Varint change of the step per value (smooth: distance, tire wear)
+    RunLength,     // (varint difference, varint length) per run of equal values (lap, flags)
+    Linear         // (varint step change, varint length) per run of equal steps (timestamps)
+};
+
+constexpr std::string_view column_encoding_name(ColumnEncoding encoding) {
+    switch (encoding) {
+        case ColumnEncoding::Plain:        return "plain";
+        case ColumnEncoding::Constant:     return "constant";
+        case ColumnEncoding::DeltaOfDelta: return "delta-of-delta";
+        case ColumnEncoding::RunLength:    return "run-length";
+        case ColumnEncoding::Linear:       return "linear";
+    }
+    return "unknown";
+}
+
+struct ArchiveColumnInfo {
+    std::string_view name;  // TelemetryFrame field name
+    ColumnType type;
+    size_t offset;          // Of the field within TelemetryFrame
+};
+
+constexpr std::array<ArchiveColumnInfo, ARCHIVE_COLUMNS> ARCHIVE_COLUMN_INFO = {{
+    {"timestamp_ms",  ColumnType::U32, offsetof(TelemetryFrame, timestamp_ms)},
+    {"driver_id",     ColumnType::U8,  offsetof(TelemetryFrame, driver_id)},
+    {"position",      ColumnType::U8,  offsetof(TelemetryFrame, position)},
+    {"lap",           ColumnType::U16, offsetof(TelemetryFrame, lap)},
+    {"sector",        ColumnType::U8,  offsetof(TelemetryFrame, sector)},
+    {"speed",         ColumnType::F32, offsetof(TelemetryFrame, speed)},
+    {"distance",      ColumnType::F32, offsetof(TelemetryFrame, distance)},
+    {"throttle",      ColumnType::F32, offsetof(TelemetryFrame, throttle)},
+    {"tire_wear",     ColumnType::F32, offsetof(TelemetryFrame, tire_wear)},
+    {"pit_stops",     ColumnType::U8,  offsetof(TelemetryFrame, pit_stops)},
+    {"pit_timer",     ColumnType::F32, offsetof(TelemetryFrame, pit_timer)},
+    {"gap_to_leader", ColumnType::F32, offsetof(TelemetryFrame, gap_to_leader)},
+    {"flags",         ColumnType::U8,  offsetof(TelemetryFrame, flags)},
+    {"sector1_ms",    ColumnType::U32, offsetof(TelemetryFrame, sector_times)},
+    {"sector2_ms",    ColumnType::U32, offsetof(TelemetryFrame, sector_times) + 4},
+    {"sector3_ms",    ColumnType::U32, offsetof(TelemetryFrame, sector_times) + 8},
+    {"last_lap_time", ColumnType::U32, offsetof(TelemetryFrame, last_lap_time)},
+    {"interval_cs",   ColumnType::U16, offsetof(TelemetryFrame, interval_cs)},
+}};
+
+constexpr std::string_view archive_column_name(ArchiveColumn column) {
+    return ARCHIVE_COLUMN_INFO[static_cast<size_t>(column)].name;
+}
+
+constexpr bool parse_archive_column(std::string_view name, ArchiveColumn& out) {
+    for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+        if (name == ARCHIVE_COLUMN_INFO[c].name) {
+            out = static_cast<ArchiveColumn>(c);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief What was raced, written once at the start of the file
+ */
+struct ArchiveHeader {
+    uint32_t magic = ARCHIVE_MAGIC;
+    uint16_t version = ARCHIVE_VERSION;
+    uint16_t columns = ARCHIVE_COLUMNS;
+    uint32_t chunk_ticks = DEFAULT_ARCHIVE_CHUNK_TICKS;
+    uint32_t seed = 0;
+    uint16_t laps = 0;
+    uint16_t drivers = NUM_DRIVERS;
+    uint16_t sim_hz = 0;
+    uint16_t reserved = 0;
+    float track_length = 0.0f;
+    char track_name[RECORDING_TRACK_NAME_BYTES] = {};
+
+    void set_track_name(std::string_view name) {
+        std::memset(track_name, 0, sizeof(track_name));
+        std::memcpy(track_name, name.data(), std::min(name.size(), sizeof(track_name) - 1));
+    }
+
+    // Race time covered by one chunk; never 0 ms, even above 1 kHz where
+    // several ticks share a millisecond
+    uint32_t chunk_span_ms() const {
+        const uint32_t tick_ms = std::max(1000u / (sim_hz ? sim_hz : 50u), 1u);
+        return std::max(chunk_ticks, 1u) * tick_ms;
+    }
+};
+
+struct ArchiveChunkHeader {
+    uint32_t magic = ARCHIVE_CHUNK_MAGIC;
+    uint32_t sequence = 0;            // Chunk number from 0, in file order
+    uint32_t frame_count = 0;
+    uint32_t first_timestamp_ms = 0;
+    uint32_t last_timestamp_ms = 0;
+    uint32_t data_bytes = 0;          // Column data after the column headers
+    uint64_t checksum = 0;            // recording_checksum() of the column headers
+};
+
+struct ArchiveColumnHeader {
+    ArchiveColumn column = ArchiveColumn::Timestamp;
+    ColumnEncoding encoding = ColumnEncoding::Plain;
+    ColumnType type = ColumnType::U32;
+    uint8_t reserved = 0;
+    uint32_t bytes = 0;
+    double min = 0.0;                 // Exact for every field type
+    double max = 0.0;
+    uint64_t checksum = 0;            // recording_checksum() of the column data
+};
+
+static_assert(sizeof(ArchiveChunkHeader) == 32);
+static_assert(sizeof(ArchiveColumnHeader) == 32);
+
+namespace archive_detail {
+
+// Fixed-size copies per width, so loops over a column don't call memcpy
+inline uint32_t load_bits(const unsigned char* p, size_t width) {
+    switch (width) {
+        case 1: return *p;
+        case 2: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        default: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    }
+}
+
+inline void store_bits(unsigned char* p, size_t width, uint32_t bits) {
+    switch (width) {
+        case 1: *p = static_cast<uint8_t>(bits); break;
+        case 2: { const auto v = static_cast<uint16_t>(bits); std::memcpy(p, &v, 2); break; }
+        default: std::memcpy(p, &bits, 4); break;
+    }
+}
+
+inline uint32_t load_field(const TelemetryFrame& frame, const ArchiveColumnInfo& info) {
+    return load_bits(reinterpret_cast<const unsigned char*>(&frame) + info.offset, column_type_bytes(info.type));
+}
+
+inline void store_field(TelemetryFrame& frame, const ArchiveColumnInfo& info, uint32_t bits) {
+    store_bits(reinterpret_cast<unsigned char*>(&frame) + info.offset, column_type_bytes(info.type), bits);
+}
+
+inline double to_double(uint32_t bits, ColumnType type) {
+    return type == ColumnType::F32 ? static_cast<double>(std::bit_cast<float>(bits)) : static_cast<double>(bits);
+}
+
+constexpr size_t varint_bytes(uint32_t v) {
+    return v < (1u << 7) ? 1 : v < (1u << 14) ? 2 : v < (1u << 21) ? 3 : v < (1u << 28) ? 4 : 5;
+}
+
+// get_varint() without bounds checks when a full varint is known to fit
+inline bool read_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    if (end - p >= 5) {
+        v = *p & 0x7f;
+        if (!(*p++ & 0x80)) return true;
+        for (unsigned shift = 7; shift < 35; shift += 7) {
+            const uint8_t byte = *p++;
+            v |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+    return codec_detail::get_varint(p, end, v);
+}
+
+inline bool less(uint32_t a, uint32_t b, ColumnType type) {
+    return type == ColumnType::F32 ? std::bit_cast<float>(a) < std::bit_cast<float>(b) : a < b;
+}
+
+// Value i minus value i - 1 (value -1 is 0)
+inline uint32_t step(const uint32_t* values, size_t i) {
+    return values[i] - (i > 0 ? values[i - 1] : 0);
+}
+
+/**
+ * @brief Call fn(start, length) for each run of equal key(i) over [0, n)
+ */
+template <typename Key, typename Fn>
+void for_each_run(size_t n, Key&& key, Fn&& fn) {
+    for (size_t i = 0; i < n;) {
+        const uint32_t k = key(i);
+        size_t run = 1;
+        while (i + run < n && key(i + run) == k) run++;
+        fn(i, run);
+        i += run;
+    }
+}
+
+/**
+ * @brief Encode `n` (> 0) values into `out`, picking the encoding
+ */
+inline void encode_column(const uint32_t* values, size_t n, ColumnType type,
+                          std::vector<uint8_t>& out, ArchiveColumnHeader& header) {
+    using codec_detail::put_varint;
+    using codec_detail::zigzag;
+
+    auto value_at = [&](size_t i) { return values[i]; };
+    auto step_at = [&](size_t i) { return step(values, i); };
+
+    // Size every candidate
+    const size_t width = column_type_bytes(type);
+    uint32_t lo = values[0];
+    uint32_t hi = values[0];
+    size_t delta_bytes = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (less(values[i], lo, type)) lo = values[i];
+        if (less(hi, values[i], type)) hi = values[i];
+        delta_bytes += varint_bytes(zigzag(step(values, i) - (i > 0 ? step(values, i - 1) : 0)));
+    }
+    size_t runs = 0;
+    size_t run_bytes = 0;
+    uint32_t previous = 0;
+    for_each_run(n, value_at, [&](size_t start, size_t length) {
+        run_bytes += varint_bytes(zigzag(values[start] - previous)) + varint_bytes(static_cast<uint32_t>(length));
+        previous = values[start];
+        runs++;
+    });
+    size_t linear_bytes = 0;
+    previous = 0;
+    for_each_run(n, step_at, [&](size_t start, size_t length) {
+        const uint32_t s = step(values, start);
+        linear_bytes += varint_bytes(zigzag(s - previous)) + varint_bytes(static_cast<uint32_t>(length));
+        previous = s;
+    });
+
+    // Varints decode several times slower than Plain's copies (a branch
+    // per byte), so they have to at least halve the column to be worth it
+    ColumnEncoding encoding = ColumnEncoding::Plain;
+    size_t bytes = n * width;
+    if (runs == 1) {
+        encoding = ColumnEncoding::Constant;
+        bytes = width;
+    } else {
+        size_t best = bytes / 2;
+        if (delta_bytes < best) { encoding = ColumnEncoding::DeltaOfDelta; best = bytes = delta_bytes; }
+        if (run_bytes < best) { encoding = ColumnEncoding::RunLength; best = bytes = run_bytes; }
+        if (linear_bytes < best) { encoding = ColumnEncoding::Linear; best = bytes = linear_bytes; }
+    }
+
+    out.resize(bytes);
+    uint8_t* p = out.data();
+    previous = 0;
+    switch (encoding) {
+        case ColumnEncoding::Plain:
+            for (size_t i = 0; i < n; ++i, p += width) store_bits(p, width, values[i]);
+            break;
+        case ColumnEncoding::Constant:
+            store_bits(p, width, values[0]);
+            break;
+        case ColumnEncoding::DeltaOfDelta:
+            for (size_t i = 0; i < n; ++i) {
+                const uint32_t s = step(values, i);
+                p += put_varint(p, zigzag(s - previous));
+                previous = s;
+            }
+            break;
+        case ColumnEncoding::RunLength:
+            for_each_run(n, value_at, [&](size_t start, size_t length) {
+                p += put_varint(p, zigzag(values[start] - previous));
+                p += put_varint(p, static_cast<uint32_t>(length));
+                previous = values[start];
+            });
+            break;
+        case ColumnEncoding::Linear:
+            for_each_run(n, step_at, [&](size_t start, size_t length) {
+                const uint32_t s = step(values, start);
+                p += put_varint(p, zigzag(s - previous));
+                p += put_varint(p, static_cast<uint32_t>(length));
+                previous = s;
+            });
+            break;
+    }
+
+    header.encoding = encoding;
+    header.type = type;
+    header.bytes = static_cast<uint32_t>(bytes);
+    header.min = to_double(lo, type);
+    header.max = to_double(hi, type);
+    header.checksum = recording_checksum(out.data(), bytes);
+}
+
+/**
+ * @brief Call fn(i, bits) for each of the `n` values of an encoded column
+ * @return false if the data is truncated or doesn't hold exactly n values
+ */
+template <typename Fn>
+bool decode_column(const uint8_t* data, size_t bytes, ColumnEncoding encoding, ColumnType type,
+                   size_t n, Fn&& fn) {
+    using codec_detail::unzigzag;
+
+    const size_t width = column_type_bytes(type);
+    const uint8_t* p = data;
+    const uint8_t* end = data + bytes;
+    uint32_t value = 0;
+    uint32_t step = 0;
+    switch (encoding) {
+        case ColumnEncoding::Plain:
+            if (bytes != n * width) return false;
+            for (size_t i = 0; i < n; ++i, p += width) fn(i, load_bits(p, width));
+            return true;
+        case ColumnEncoding::Constant:
+            if (bytes != width) return false;
+            value = load_bits(p, width);
+            for (size_t i = 0; i < n; ++i) fn(i, value);
+            return true;
+        case ColumnEncoding::DeltaOfDelta:
+            for (size_t i = 0; i < n; ++i) {
+                uint32_t delta;
+                if (!read_varint(p, end, delta)) return false;
+                step += unzigzag(delta);
+                fn(i, value += step);
+            }
+            return p == end;
+        case ColumnEncoding::RunLength:
+        case ColumnEncoding::Linear:
+            for (size_t i = 0; i < n;) {
+                uint32_t delta, run;
+                if (!read_varint(p, end, delta) || !read_varint(p, end, run) || run == 0 || run > n - i) {
+                    return false;
+                }
+                if (encoding == ColumnEncoding::RunLength) {
+                    value += unzigzag(delta);
+                    for (const size_t stop = i + run; i < stop; ++i) fn(i, value);
+                } else {
+                    step += unzigzag(delta);
+                    for (const size_t stop = i + run; i < stop; ++i) fn(i, value += step);
+                }
+            }
+            return p == end;
+    }
+    return false;
+}
+
+} // namespace archive_detail
+
+/**
+ * @brief Archive writer counters
+ */
+struct ArchiveWriterStats {
+    uint64_t frames = 0;
+    uint64_t chunks = 0;
+    uint64_t bytes = 0;                                 // File size so far
+    std::array<uint64_t, ARCHIVE_COLUMNS> column_bytes{};
+    int error = 0;                                      // errno of the first failed write
+};
+
+/**
+ * @brief Builds an archive from frames in arrival order
+ *
+ * Frames are buffered until one from the next chunk's time span arrives,
+ * then the chunk is sorted by driver, split into columns, encoded and
+ * written with one fwrite per part. Feed it with append(), or hand it a
+ * ring to drain() on a consumer thread.
+ */
+class ArchiveWriter {
+public:
+    ArchiveWriter() = default;
+
+    ~ArchiveWriter() {
+        close();
+    }
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    /**
+     * @brief Create the file and write its header
+     * @return false (with `error` set) if the file cannot be created
+     */
+    bool open(const std::string& path, const ArchiveHeader& header, std::string& error) {
+        close();
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            error = "cannot create " + path + ": " + std::strerror(errno);
+            return false;
+        }
+
+        header_ = header;
+        header_.magic = ARCHIVE_MAGIC;
+        header_.version = ARCHIVE_VERSION;
+        header_.columns = ARCHIVE_COLUMNS;
+        header_.chunk_ticks = std::max<uint32_t>(header_.chunk_ticks, 1);
+        stats_ = {};
+        sequence_ = 0;
+        pending_.clear();
+        pending_.reserve(static_cast<size_t>(header_.chunk_ticks) * NUM_DRIVERS);
+        write(&header_, sizeof(header_));
+        return true;
+    }
+
+    void append(const TelemetryFrame& frame) {
+        const uint32_t chunk = frame.timestamp_ms / header_.chunk_span_ms();
+        if (!pending_.empty() && chunk != chunk_) {
+            flush_chunk();
+        }
+        chunk_ = chunk;
+        pending_.push_back(frame);
+    }
+
+    void append(const TelemetryFrame* frames, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            append(frames[i]);
+        }
+    }
+
+    /**
+     * @brief Archive everything popped from `ring` until it is shut down and
+     *        drained, then close the file
+     * @return false if a write failed
+     */
+    template <size_t Capacity>
+    bool drain(RingBuffer<TelemetryFrame, Capacity>& ring) {
+        std::array<TelemetryFrame, 256> batch;
+        while (const size_t n = ring.pop_batch(batch.data(), batch.size())) {
+            append(batch.data(), n);
+        }
+        return close();
+    }
+
+    /**
+     * @brief Write the last (partial) chunk and close the file
+     * @return false if any write failed
+     */
+    bool close() {
+        if (!file_) return stats_.error == 0;
+        if (!pending_.empty()) {
+            flush_chunk();
+        }
+        if (std::fclose(file_) != 0 && stats_.error == 0) {
+            stats_.error = errno;
+        }
+        file_ = nullptr;
+        return stats_.error == 0;
+    }
+
+    const ArchiveWriterStats& stats() const { return stats_; }
+
+private:
+    void flush_chunk() {
+        const size_t n = pending_.size();
+
+        // Stable counting sort by driver: each column becomes per-car traces
+        std::array<size_t, NUM_DRIVERS + 1> starts{};
+        for (const TelemetryFrame& frame : pending_) {
+            starts[bucket(frame) + 1]++;
+        }
+        for (size_t d = 0; d < NUM_DRIVERS; ++d) {
+            starts[d + 1] += starts[d];
+        }
+        sorted_.resize(n);
+        for (const TelemetryFrame& frame : pending_) {
+            sorted_[starts[bucket(frame)]++] = frame;
+        }
+
+        ArchiveChunkHeader chunk;
+        chunk.sequence = sequence_++;
+        chunk.frame_count = static_cast<uint32_t>(n);
+        chunk.first_timestamp_ms = pending_.front().timestamp_ms;
+        chunk.last_timestamp_ms = pending_.back().timestamp_ms;
+
+        values_.resize(n);
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            const ArchiveColumnInfo& info = ARCHIVE_COLUMN_INFO[c];
+            for (size_t i = 0; i < n; ++i) {
+                values_[i] = archive_detail::load_field(sorted_[i], info);
+            }
+            columns_[c] = {};
+            columns_[c].column = static_cast<ArchiveColumn>(c);
+            archive_detail::encode_column(values_.data(), n, info.type, data_[c], columns_[c]);
+            chunk.data_bytes += columns_[c].bytes;
+            stats_.column_bytes[c] += columns_[c].bytes;
+        }
+        chunk.checksum = recording_checksum(columns_.data(), sizeof(columns_));
+
+        write(&chunk, sizeof(chunk));
+        write(columns_.data(), sizeof(columns_));
+        for (const std::vector<uint8_t>& data : data_) {
+            write(data.data(), data.size());
+        }
+
+        stats_.frames += n;
+        stats_.chunks++;
+        pending_.clear();
+    }
+
+    static size_t bucket(const TelemetryFrame& frame) {
+        return std::min<size_t>(frame.driver_id, NUM_DRIVERS - 1);
+    }
+
+    void write(const void* data, size_t bytes) {
+        if (stats_.error != 0 || bytes == 0) return;
+        if (std::fwrite(data, bytes, 1, file_) != 1) {
+            stats_.error = errno ? errno : EIO;
+            return;
+        }
+        stats_.bytes += bytes;
+    }
+
+    std::FILE* file_ = nullptr;
+    ArchiveHeader header_;
+    ArchiveWriterStats stats_;
+    uint32_t sequence_ = 0;
+    uint32_t chunk_ = 0;                                 // Chunk the pending frames belong to
+    std::vector<TelemetryFrame> pending_;
+    std::vector<TelemetryFrame> sorted_;
+    std::vector<uint32_t> values_;
+    std::array<ArchiveColumnHeader, ARCHIVE_COLUMNS> columns_{};
+    std::array<std::vector<uint8_t>, ARCHIVE_COLUMNS> data_;
+};
+
+/**
+ * @brief A chunk as indexed by ArchiveReader::open()
+ */
+struct ArchiveChunk {
+    ArchiveChunkHeader header;
+    std::array<ArchiveColumnHeader, ARCHIVE_COLUMNS> columns;
+    std::array<size_t, ARCHIVE_COLUMNS> data_offset;   // File offset of each column's data
+};
+
+/**
+ * @brief Reads an archive through a read-only mapping, one column at a time
+ *
+ * open() only reads the chunk and column headers. The mapping is advised
+ * MADV_RANDOM so decoding a column faults in that column's pages and not
+ * the read-ahead of its neighbours; prefetch() the columns a scan needs to
+ * have them read in bulk. All reads are const and may run on several
+ * threads at once.
+ */
+class ArchiveReader {
+public:
+    /**
+     * @brief Map the file and index its chunks
+     * @return false (with `error` set) if it isn't a complete, intact archive;
+     *         a torn final chunk is ignored
+     */
+    bool open(const std::string& path, std::string& error) {
+        chunks_.clear();
+        frames_ = 0;
+        if (!file_.open(path, MADV_RANDOM)) {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        const uint8_t* data = file_.data();
+        const size_t size = file_.size();
+        if (size < sizeof(header_)) {
+            error = "not a telemetry archive";
+            return false;
+        }
+        std::memcpy(&header_, data, sizeof(header_));
+        if (header_.magic != ARCHIVE_MAGIC || header_.version != ARCHIVE_VERSION ||
+            header_.columns != ARCHIVE_COLUMNS) {
+            error = "not a telemetry archive (or an unsupported version)";
+            return false;
+        }
+
+        constexpr size_t HEADERS = sizeof(ArchiveChunkHeader) + ARCHIVE_COLUMNS * sizeof(ArchiveColumnHeader);
+        size_t offset = sizeof(header_);
+        while (offset + HEADERS <= size) {
+            ArchiveChunk chunk;
+            std::memcpy(&chunk.header, data + offset, sizeof(chunk.header));
+            std::memcpy(chunk.columns.data(), data + offset + sizeof(chunk.header), sizeof(chunk.columns));
+            if (chunk.header.magic != ARCHIVE_CHUNK_MAGIC ||
+                chunk.header.checksum != recording_checksum(chunk.columns.data(), sizeof(chunk.columns)) ||
+                offset + HEADERS + chunk.header.data_bytes > size) {
+                break;
+            }
+
+            size_t column_offset = offset + HEADERS;
+            for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+                chunk.data_offset[c] = column_offset;
+                column_offset += chunk.columns[c].bytes;
+            }
+            if (column_offset != offset + HEADERS + chunk.header.data_bytes) {
+                break;
+            }
+
+            chunks_.push_back(chunk);
+            frames_ += chunk.header.frame_count;
+            offset = column_offset;
+        }
+        return true;
+    }
+
+    const ArchiveHeader& header() const { return header_; }
+    size_t chunk_count() const { return chunks_.size(); }
+    const ArchiveChunk& chunk(size_t index) const { return chunks_[index]; }
+    uint64_t frame_count() const { return frames_; }
+
+    /**
+     * @brief Ask the kernel to read `column` of every chunk ahead of a scan
+     *
+     * Issued up front, the reads of all chunks overlap instead of each
+     * read_column() waiting on its own page faults.
+     */
+    void prefetch(ArchiveColumn column) const {
+        const size_t c = static_cast<size_t>(column);
+        for (const ArchiveChunk& chunk : chunks_) {
+            file_.prefetch(chunk.data_offset[c], chunk.columns[c].bytes);
+        }
+    }
+
+    /**
+     * @brief Decode one column of one chunk into `out` (frame_count values,
+     *        rows ordered by driver then time)
+     * @return false if the column data is corrupt
+     */
+    bool read_column(size_t chunk_index, ArchiveColumn column, std::vector<double>& out) const {
+        const ArchiveChunk& chunk = chunks_[chunk_index];
+        const ArchiveColumnHeader& header = chunk.columns[static_cast<size_t>(column)];
+        out.resize(chunk.header.frame_count);
+        return decode(chunk, column, [&](size_t i, uint32_t bits) {
+            out[i] = archive_detail::to_double(bits, header.type);
+        });
+    }
+
+    /**
+     * @brief Decode every column of a chunk back into frames (driver, then time order)
+     * @return false if any column is corrupt
+     */
+    bool read_frames(size_t chunk_index, std::vector<TelemetryFrame>& out) const {
+        const ArchiveChunk& chunk = chunks_[chunk_index];
+        out.assign(chunk.header.frame_count, TelemetryFrame{});
+        for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+            const ArchiveColumnInfo& info = ARCHIVE_COLUMN_INFO[c];
+            const bool ok = decode(chunk, static_cast<ArchiveColumn>(c), [&](size_t i, uint32_t bits) {
+                archive_detail::store_field(out[i], info, bits);
+            });
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+private:
+    template <typename Fn>
+    bool decode(const ArchiveChunk& chunk, ArchiveColumn column, Fn&& fn) const {
+        const size_t c = static_cast<size_t>(column);
+        const ArchiveColumnHeader& header = chunk.columns[c];
+        const uint8_t* data = file_.data() + chunk.data_offset[c];
+        if (header.column != column || header.type != ARCHIVE_COLUMN_INFO[c].type ||
+            recording_checksum(data, header.bytes) != header.checksum) {
+            return false;
+        }
+        return archive_detail::decode_column(data, header.bytes, header.encoding, header.type,
+                                             chunk.header.frame_count, fn);
+    }
+
+    MappedFile file_;
+    ArchiveHeader header_;
+    std::vector<ArchiveChunk> chunks_;
+    uint64_t frames_ = 0;
+};
+
+} // namespace f1sim
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "telemetry_data.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace f1sim {
+
+// ============================================================================
+// Compressed Telemetry Stream
+//
+// Lossless delta coding of TelemetryFrames, for recordings and any other
+// byte stream (e.g. network export). Each frame is coded against the
+// previous frame of the same driver:
+//
+//   [varint mask][driver id, if mask bit DRIVER_BIT][varint per set lane]
+//
+// A frame is split into 32-bit lanes (floats by bit pattern). Every lane has
+// a prediction: the previous value, or for lanes that move smoothly
+// (timestamp, distance, tire wear, pit timer) the previous value plus the
+// previous step - delta-of-delta. A lane equal to its prediction costs one
+// clear mask bit; otherwise the mask bit is set and the difference follows
+// as a zigzag LEB128 varint. Floats are differenced as integers, so coding
+// is exact.
+//
+// Lanes are ordered busiest first so the mask usually fits one byte.
+// reset() makes the next frame of every driver a keyframe (coded against
+// zero): streams cut at a reset, like recording blocks, decode on their own.
+// ============================================================================
+
+namespace codec_detail {
+
+enum class Prediction : uint8_t { Previous, Linear };
+
+constexpr size_t LANES = 17;
+constexpr uint32_t DRIVER_BIT = 1u << LANES;  // Driver isn't the previous one + 1
+
+// Busiest first; sector/lap/pit fields change a few times per lap at most
+constexpr std::array<Prediction, LANES> LANE_PREDICTION = {
+    Prediction::Previous,  //  0 speed
+    Prediction::Linear,    //  1 distance
+    Prediction::Linear,    //  2 tire_wear
+    Prediction::Previous,  //  3 gap_to_leader
+    Prediction::Previous,  //  4 interval_cs
+    Prediction::Linear,    //  5 timestamp_ms
+    Prediction::Linear,    //  6 pit_timer
+    Prediction::Previous,  //  7 position
+    Prediction::Previous,  //  8 sector
+    Prediction::Previous,  //  9 sector_times[0]
+    Prediction::Previous,  // 10 sector_times[1]
+    Prediction::Previous,  // 11 sector_times[2]
+    Prediction::Previous,  // 12 flags
+    Prediction::Previous,  // 13 throttle
+    Prediction::Previous,  // 14 lap
+    Prediction::Previous,  // 15 last_lap_time
+    Prediction::Previous,  // 16 pit_stops
+};
+
+using Lanes = std::array<uint32_t, LANES>;
+
+inline Lanes to_lanes(const TelemetryFrame& f) {
+    return {std::bit_cast<uint32_t>(f.speed), std::bit_cast<uint32_t>(f.distance),
+            std::bit_cast<uint32_t>(f.tire_wear), std::bit_cast<uint32_t>(f.gap_to_leader),
+            f.interval_cs, f.timestamp_ms, std::bit_cast<uint32_t>(f.pit_timer),
+            f.position, f.sector, f.sector_times[0], f.sector_times[1], f.sector_times[2],
+            f.flags, std::bit_cast<uint32_t>(f.throttle), f.lap, f.last_lap_time, f.pit_stops};
+}
+
+inline void from_lanes(const Lanes& l, uint8_t driver, TelemetryFrame& f) {
+    f = TelemetryFrame{};
+    f.driver_id = driver;
+    f.speed = std::bit_cast<float>(l[0]);
+    f.distance = std::bit_cast<float>(l[1]);
+    f.tire_wear = std::bit_cast<float>(l[2]);
+    f.gap_to_leader = std::bit_cast<float>(l[3]);
+    f.interval_cs = static_cast<uint16_t>(l[4]);
+    f.timestamp_ms = l[5];
+    f.pit_timer = std::bit_cast<float>(l[6]);
+    f.position = static_cast<uint8_t>(l[7]);
+    f.sector = static_cast<uint8_t>(l[8]);
+    f.sector_times[0] = l[9];
+    f.sector_times[1] = l[10];
+    f.sector_times[2] = l[11];
+    f.flags = static_cast<uint8_t>(l[12]);
+    f.throttle = std::bit_cast<float>(l[13]);
+    f.lap = static_cast<uint16_t>(l[14]);
+    f.last_lap_time = l[15];
+    f.pit_stops = static_cast<uint8_t>(l[16]);
+}
+
+inline uint32_t zigzag(uint32_t delta) {
+    const auto v = static_cast<int32_t>(delta);
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+inline uint32_t unzigzag(uint32_t v) {
+    return (v >> 1) ^ (0u - (v & 1));
+}
+
+inline size_t put_varint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = static_cast<uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+// Returns false on a truncated or over-long varint
+inline bool get_varint(const uint8_t*& p, const uint8_t* end, uint32_t& v) {
+    v = 0;
+    for (unsigned shift = 0; shift < 35 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Prediction state for one driver, shared by encoder and decoder
+ */
+struct LaneHistory {
+    Lanes previous{};
+    Lanes step{};  // previous - the one before, for linear prediction
+
+    uint32_t predict(size_t lane) const {
+        return LANE_PREDICTION[lane] == Prediction::Linear ? previous[lane] + step[lane] : previous[lane];
+    }
+
+    void update(size_t lane, uint32_t value) {
+        step[lane] = value - previous[lane];
+        previous[lane] = value;
+    }
+};
+
+} // namespace codec_detail
+
+// Worst case: 3-byte mask, driver id, 5 bytes per lane
+constexpr size_t MAX_ENCODED_FRAME_BYTES = 3 + 1 + 5 * codec_detail::LANES;
+
+/**
+ * @brief Encodes frames into a byte stream, one call per frame
+ */
+class FrameEncoder {
+public:
+    FrameEncoder() { reset(); }
+
+    // Next frame of every driver becomes a keyframe
+    void reset() {
+        history_ = {};
+        last_driver_ = NUM_DRIVERS - 1;
+    }
+
+    /**
+     * @brief Append one frame (driver_id < NUM_DRIVERS) to `out`, which must
+     *        have room for MAX_ENCODED_FRAME_BYTES
+     * @return Bytes written
+     */
+    size_t encode(const TelemetryFrame& frame, uint8_t* out) {
+        using namespace codec_detail;
+
+        const Lanes lanes = to_lanes(frame);
+        LaneHistory& history = history_[frame.driver_id];
+
+        uint8_t body[5 * LANES];
+        size_t body_bytes = 0;
+        uint32_t mask = 0;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            const uint32_t predicted = history.predict(lane);
+            if (lanes[lane] != predicted) {
+                mask |= 1u << lane;
+                body_bytes += put_varint(body + body_bytes, zigzag(lanes[lane] - predicted));
+            }
+            history.update(lane, lanes[lane]);
+        }
+
+        const bool next_in_turn = frame.driver_id == (last_driver_ + 1) % NUM_DRIVERS;
+        last_driver_ = frame.driver_id;
+        if (!next_in_turn) mask |= DRIVER_BIT;
+
+        size_t n = put_varint(out, mask);
+        if (!next_in_turn) out[n++] = frame.driver_id;
+        std::memcpy(out + n, body, body_bytes);
+        return n + body_bytes;
+    }
+
+private:
+    std::array<codec_detail::LaneHistory, NUM_DRIVERS> history_;
+    size_t last_driver_ = 0;
+};
+
+/**
+ * @brief Decodes a stream written by FrameEncoder, resetting where it did
+ */
+class FrameDecoder {
+public:
+    FrameDecoder() { reset(); }
+
+    void reset() {
+        history_ = {};
+        last_driver_ = NUM_DRIVERS - 1;
+    }
+
+    /**
+     * @brief Decode the frame at `p`, advancing it
+     * @return false if the stream is truncated or corrupt
+     */
+    bool decode(const uint8_t*& p, const uint8_t* end, TelemetryFrame& frame) {
+        using namespace codec_detail;
+
+        uint32_t mask;
+        if (!get_varint(p, end, mask) || mask >= (DRIVER_BIT << 1)) return false;
+
+        size_t driver = (last_driver_ + 1) % NUM_DRIVERS;
+        if (mask & DRIVER_BIT) {
+            if (p >= end || *p >= NUM_DRIVERS) return false;
+            driver = *p++;
+        }
+        last_driver_ = driver;
+
+        LaneHistory& history = history_[driver];
+        Lanes lanes;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            uint32_t value = history.predict(lane);
+            if (mask & (1u << lane)) {
+                uint32_t delta;
+                if (!get_varint(p, end, delta)) return false;
+                value += unzigzag(delta);
+            }
+            lanes[lane] = value;
+            history.update(lane, value);
+        }
+
+        from_lanes(lanes, static_cast<uint8_t>(driver), frame);
+        return true;
+    }
+
+private:
+    std::array<codec_detail::LaneHistory, NUM_DRIVERS> history_;
+    size_t last_driver_ = 0;
+};
+
+} // namespace f1sim
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <array>
 
@@ -40,6 +41,7 @@ struct CarProfile {
 constexpr size_t NUM_DRIVERS = 20;
 constexpr float TRACK_LENGTH = 5000.0f;  // meters  
 constexpr float TIRE_WEAR_BASE_RATE = 0.00125f;  // Base wear per second (~7.5% per lap, 1-2 stops per race)
+constexpr float TIRE_WEAR_SPEED_PENALTY = 0.3f;  // Fraction of speed lost at 100% wear
 constexpr float PIT_STOP_BASE_DURATION = 2.5f; // Base pit stop duration (seconds)
 
 // ============================================================================
@@ -90,7 +92,9 @@ struct TelemetryFrame {
     // - uint8_t gear;
     // - uint16_t engine_rpm;
     
-    uint8_t padding[3];       // Pad to 64 bytes (4+1+1+2+1+4+4+4+4+1+4+4+1+12+4+3=64)
+    uint16_t interval_cs;     // Interval to the car ahead in 1/100 s, saturates at 655.35 s (2 bytes)
+    
+    uint8_t padding[1];       // Pad to 64 bytes (4+1+1+2+1+4+4+4+4+1+4+4+1+12+4+2+1=64)
 } __attribute__((aligned(64)));
 
 // Status flag constants
@@ -98,6 +102,7 @@ constexpr uint8_t FLAG_IN_PITS   = 0x01;
 constexpr uint8_t FLAG_PENALTY   = 0x02;
 constexpr uint8_t FLAG_DNF       = 0x04;
 constexpr uint8_t FLAG_SAFETY_CAR = 0x08;
+constexpr uint8_t FLAG_DRS_OPEN  = 0x10;
 
 /**
  * @brief Legacy structure for double-buffered state (kept for now)
@@ -110,7 +115,8 @@ struct CarTelemetry {
     uint8_t position;         // Race position (1-20) (1 byte)
     uint16_t current_lap;     // (2 bytes)
     float gap_to_leader;      // Gap to P1 in seconds (4 bytes)
-    uint8_t padding[49];      // Pad to 64 bytes total (4+4+1+2+4+49=64)
+    float interval_to_ahead;  // Gap to the car one position ahead in seconds (4 bytes)
+    uint8_t padding[45];      // Pad to 64 bytes total (4+4+1+2+4+4+45=64)
 } __attribute__((aligned(64)));
 
 /**
@@ -123,6 +129,8 @@ struct CarState {
     bool in_pits;             // Currently in pit stop
     float pit_timer;          // Time remaining in pit stop (seconds)
     uint8_t pit_stops;        // Number of pit stops completed
+    bool drs_open;            // DRS flap open for the current zone
+    uint8_t last_track_flags; // TrackSample flags seen last tick (zone entry detection)
 };
 
 struct RaceState {
@@ -0,0 +1,391 @@
+#pragma once
+
+#include "telemetry_archive.h"
+#include "ring_buffer.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Telemetry Export - CSV / JSON / NDJSON
+//
+// Fields are named as the archive's columns (ARCHIVE_COLUMN_INFO), in the
+// order asked for. Floats are written in their shortest form that reads
+// back to the same float, so an export loses nothing; a JSON export writes
+// NaN and infinities as null.
+// ============================================================================
+
+enum class ExportFormat : uint8_t {
+    Csv,     // Header line, then one row per frame
+    Json,    // One array of objects
+    Ndjson   // One object per line
+};
+
+constexpr std::string_view export_format_name(ExportFormat format) {
+    switch (format) {
+        case ExportFormat::Csv:    return "csv";
+        case ExportFormat::Json:   return "json";
+        case ExportFormat::Ndjson: return "ndjson";
+    }
+    return "unknown";
+}
+
+constexpr bool parse_export_format(std::string_view name, ExportFormat& out) {
+    for (auto format : {ExportFormat::Csv, ExportFormat::Json, ExportFormat::Ndjson}) {
+        if (name == export_format_name(format)) {
+            out = format;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Format from a file name's extension (.csv, .json, .ndjson or .jsonl)
+constexpr bool export_format_from_path(std::string_view path, ExportFormat& out) {
+    const size_t dot = path.rfind('.');
+    if (dot == std::string_view::npos) return false;
+    const std::string_view extension = path.substr(dot + 1);
+    if (extension == "jsonl") {
+        out = ExportFormat::Ndjson;
+        return true;
+    }
+    return parse_export_format(extension, out);
+}
+
+constexpr uint32_t EXPORT_ALL_DRIVERS = (1u << NUM_DRIVERS) - 1;
+
+/**
+ * @brief What to write: format, fields and drivers
+ */
+struct ExportOptions {
+    ExportFormat format = ExportFormat::Csv;
+    std::vector<ArchiveColumn> fields;     // In output order, each once; empty for all of them
+    uint32_t drivers = EXPORT_ALL_DRIVERS; // Bit per driver id
+
+    bool wants(const TelemetryFrame& frame) const {
+        return frame.driver_id < NUM_DRIVERS && (drivers >> frame.driver_id & 1u);
+    }
+};
+
+/**
+ * @brief Parse "speed,lap,tire_wear" into export fields
+ * @return false (with `error` set) on an unknown or repeated field name
+ */
+inline bool parse_export_fields(std::string_view list, std::vector<ArchiveColumn>& fields, std::string& error) {
+    fields.clear();
+    if (list.empty()) {
+        error = "no fields given";
+        return false;
+    }
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        const std::string_view name = list.substr(0, comma);
+        ArchiveColumn column;
+        if (!parse_archive_column(name, column)) {
+            error = "unknown field '" + std::string(name) + "'";
+            return false;
+        }
+        if (std::find(fields.begin(), fields.end(), column) != fields.end()) {
+            error = "field '" + std::string(name) + "' given twice";
+            return false;
+        }
+        fields.push_back(column);
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Parse "0,3,7" into a driver mask
+ * @return false (with `error` set) on anything but driver ids
+ */
+inline bool parse_export_drivers(std::string_view list, uint32_t& drivers, std::string& error) {
+    drivers = 0;
+    if (list.empty()) {
+        error = "no drivers given";
+        return false;
+    }
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        const std::string_view id = list.substr(0, comma);
+        unsigned driver = 0;
+        const auto [end, ec] = std::from_chars(id.data(), id.data() + id.size(), driver);
+        if (ec != std::errc() || end != id.data() + id.size() || driver >= NUM_DRIVERS) {
+            error = "bad driver id '" + std::string(id) + "'";
+            return false;
+        }
+        drivers |= 1u << driver;
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Formats frames as rows of one export format
+ *
+ * Rows are written with std::to_chars behind per-field prefixes (separator,
+ * JSON key) built once up front. JSON rows carry their leading ",\n";
+ * whoever writes the first row of an array skips JSON_FIRST_ROW_SKIP bytes
+ * of it. Stateless per row, so chunks of a file can be formatted on
+ * different threads and concatenated.
+ */
+class ExportFormatter {
+public:
+    static constexpr size_t MAX_ROW_BYTES = 1024;  // 18 fields × (key + value) with room to spare
+    static constexpr size_t JSON_FIRST_ROW_SKIP = 1;
+
+    ExportFormatter() : ExportFormatter(ExportOptions{}) {}
+
+    explicit ExportFormatter(const ExportOptions& options) : options_(options) {
+        if (options_.fields.empty()) {
+            for (size_t c = 0; c < ARCHIVE_COLUMNS; ++c) {
+                options_.fields.push_back(static_cast<ArchiveColumn>(c));
+            }
+        }
+        for (size_t f = 0; f < options_.fields.size(); ++f) {
+            Field field{ARCHIVE_COLUMN_INFO[static_cast<size_t>(options_.fields[f])], {}, 0};
+            std::string prefix;
+            if (options_.format == ExportFormat::Csv) {
+                prefix = f > 0 ? "," : "";
+            } else {
+                prefix = std::string(f > 0 ? "," : "{") + "\"" + std::string(field.info.name) + "\":";
+            }
+            std::memcpy(field.prefix, prefix.data(), prefix.size());
+            field.prefix_bytes = prefix.size();
+            fields_.push_back(field);
+        }
+    }
+
+    const ExportOptions& options() const { return options_; }
+
+    // Bytes to skip at the start of a file's (or part's) first row
+    size_t first_row_skip() const {
+        return options_.format == ExportFormat::Json ? JSON_FIRST_ROW_SKIP : 0;
+    }
+
+    // CSV header line or the JSON array's opening bracket
+    std::string begin() const {
+        std::string text;
+        if (options_.format == ExportFormat::Csv) {
+            for (size_t f = 0; f < fields_.size(); ++f) {
+                if (f > 0) text += ',';
+                text += fields_[f].info.name;
+            }
+            text += '\n';
+        } else if (options_.format == ExportFormat::Json) {
+            text = "[";
+        }
+        return text;
+    }
+
+    std::string_view end(bool any_rows) const {
+        if (options_.format != ExportFormat::Json) return {};
+        return any_rows ? "\n]\n" : "]\n";
+    }
+
+    /**
+     * @brief Format one frame at `p`, which must have MAX_ROW_BYTES of room
+     * @return End of the row
+     */
+    char* row(char* p, const TelemetryFrame& frame) const {
+        if (options_.format == ExportFormat::Json) {
+            *p++ = ',';
+            *p++ = '\n';
+        }
+        for (const Field& field : fields_) {
+            std::memcpy(p, field.prefix, sizeof(field.prefix));  // Fixed size: no call
+            p += field.prefix_bytes;
+            p = value(p, frame, field.info);
+        }
+        if (options_.format == ExportFormat::Csv) {
+            *p++ = '\n';
+        } else {
+            *p++ = '}';
+            if (options_.format == ExportFormat::Ndjson) *p++ = '\n';
+        }
+        return p;
+    }
+
+    /**
+     * @brief Append the rows for the frames that pass the driver filter
+     * @return Rows appended
+     */
+    size_t rows(const TelemetryFrame* frames, size_t count, std::vector<char>& out) const {
+        size_t used = out.size();
+        size_t written = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!options_.wants(frames[i])) continue;
+            if (out.size() - used < MAX_ROW_BYTES) {
+                out.resize(std::max(out.size() * 2, used + MAX_ROW_BYTES * 64));
+            }
+            used = static_cast<size_t>(row(out.data() + used, frames[i]) - out.data());
+            written++;
+        }
+        out.resize(used);
+        return written;
+    }
+
+private:
+    struct Field {
+        ArchiveColumnInfo info;
+        char prefix[32];
+        size_t prefix_bytes;
+    };
+
+    char* value(char* p, const TelemetryFrame& frame, const ArchiveColumnInfo& info) const {
+        char* const end = p + 32;
+        const uint32_t bits = archive_detail::load_field(frame, info);
+        if (info.type != ColumnType::F32) {
+            return std::to_chars(p, end, bits).ptr;
+        }
+        const float value = std::bit_cast<float>(bits);
+        if (!std::isfinite(value) && options_.format != ExportFormat::Csv) {
+            std::memcpy(p, "null", 4);
+            return p + 4;
+        }
+        return std::to_chars(p, end, value).ptr;
+    }
+
+    ExportOptions options_;
+    std::vector<Field> fields_;
+};
+
+/**
+ * @brief Exporter counters
+ */
+struct ExportStats {
+    uint64_t frames = 0;  // Written (after the driver filter)
+    uint64_t bytes = 0;
+    int error = 0;        // errno of the first failed write
+};
+
+/**
+ * @brief Streams frames to a CSV, JSON or NDJSON file
+ *
+ * Rows are formatted by an ExportFormatter straight into one reusable 1 MiB
+ * buffer, which goes to the file in one unbuffered fwrite when it fills.
+ * Feed it with write(), or hand it a ring to drain() on a consumer thread.
+ */
+class TelemetryExporter {
+public:
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    TelemetryExporter() = default;
+
+    ~TelemetryExporter() {
+        close();
+    }
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    /**
+     * @brief Create the file and write the CSV header or JSON opening bracket
+     * @return false (with `error` set) if the file cannot be created
+     */
+    bool open(const std::string& path, const ExportOptions& options, std::string& error) {
+        close();
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            error = "cannot create " + path + ": " + std::strerror(errno);
+            return false;
+        }
+        std::setvbuf(file_, nullptr, _IONBF, 0);  // buffer_ is the only buffer
+
+        formatter_ = ExportFormatter(options);
+        stats_ = {};
+        buffer_.resize(BUFFER_BYTES);
+        used_ = 0;
+        append(formatter_.begin());
+        return true;
+    }
+
+    void write(const TelemetryFrame& frame) {
+        if (!formatter_.options().wants(frame)) return;
+        if (BUFFER_BYTES - used_ < ExportFormatter::MAX_ROW_BYTES) {
+            flush();
+        }
+        char* const row = buffer_.data() + used_;
+        char* const end = formatter_.row(row, frame);
+        size_t bytes = static_cast<size_t>(end - row);
+        if (stats_.frames == 0 && formatter_.first_row_skip() > 0) {
+            bytes -= formatter_.first_row_skip();
+            std::memmove(row, row + formatter_.first_row_skip(), bytes);
+        }
+        used_ += bytes;
+        stats_.frames++;
+    }
+
+    void write(const TelemetryFrame* frames, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            write(frames[i]);
+        }
+    }
+
+    /**
+     * @brief Export everything popped from `ring` until it is shut down and
+     *        drained, then close the file
+     * @return false if a write failed
+     */
+    template <size_t Capacity>
+    bool drain(RingBuffer<TelemetryFrame, Capacity>& ring) {
+        std::array<TelemetryFrame, 256> batch;
+        while (const size_t n = ring.pop_batch(batch.data(), batch.size())) {
+            write(batch.data(), n);
+        }
+        return close();
+    }
+
+    /**
+     * @brief Finish the JSON array, write what's buffered and close the file
+     * @return false if any write failed
+     */
+    bool close() {
+        if (!file_) return stats_.error == 0;
+        append(formatter_.end(stats_.frames > 0));
+        flush();
+        if (std::fclose(file_) != 0 && stats_.error == 0) {
+            stats_.error = errno;
+        }
+        file_ = nullptr;
+        return stats_.error == 0;
+    }
+
+    const ExportStats& stats() const { return stats_; }
+
+private:
+    void append(std::string_view text) {
+        if (text.empty()) return;
+        if (BUFFER_BYTES - used_ < text.size()) flush();
+        std::memcpy(buffer_.data() + used_, text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void flush() {
+        if (used_ == 0) return;
+        if (stats_.error == 0 && std::fwrite(buffer_.data(), 1, used_, file_) != used_) {
+            stats_.error = errno != 0 ? errno : EIO;
+        }
+        stats_.bytes += used_;
+        used_ = 0;
+    }
+
+    FILE* file_ = nullptr;
+    ExportFormatter formatter_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    ExportStats stats_;
+};
+
+} // namespace f1sim
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "recording_format.h"
+#include "recording_index.h"
+#include "recording_segments.h"
+#include "async_file_writer.h"
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Telemetry Recorder - Consumer Thread Writing to Disk
+// ============================================================================
+
+constexpr WriteBackend DEFAULT_RECORDER_BACKEND = WriteBackend::IoUring;
+
+// Pause after draining the tap, so the recorder wakes at most ~1000 times a
+// second instead of once per tick; the tap holds 16 ms of frames even at
+// 1,000x the live rate
+constexpr std::chrono::microseconds RECORDER_IDLE_NAP{1000};
+
+/**
+ * @brief Recorder counters, read after finish()
+ */
+struct RecorderStats {
+    uint64_t frames = 0;
+    uint64_t blocks = 0;
+    std::chrono::nanoseconds cpu_time{0};  // Recorder thread CPU (not the kernel's writeback)
+    AsyncWriterStats io;
+    uint64_t index_bytes = 0;              // Sidecar index size, 0 if it wasn't written
+    SegmentStats segments;                 // Segmented recordings only
+    std::chrono::nanoseconds rotate_max{0};  // Longest the recorder spent switching segments
+};
+
+/**
+ * @brief Drains a TelemetryTap into a recording file on its own thread
+ *
+ * The engine only ever try_push()es into the tap, so however slow the disk
+ * is the physics thread never waits: a stalled recorder shows up as dropped
+ * frames on the engine side, never as a late tick.
+ *
+ * Frames are popped straight into the payload of the block being filled,
+ * inside one of the AsyncFileWriter's buffers (BLOCKS_PER_WRITE blocks
+ * each). Full blocks are sealed (header + checksum) and the buffer is
+ * submitted as soon as the recorder has caught up with the tap, so at the
+ * live rate each block reaches the disk about a second after its first
+ * frame, and under a backlog sealed blocks coalesce into writes of up to a
+ * megabyte. The recorder moves on to the next free buffer while the write
+ * is in flight; it only blocks if every buffer is still being written.
+ *
+ * RecordingEncoding::Compact works the same way with CompactTelemetryFrames
+ * from a CompactTelemetryTap (the recorder is constructed with one), twice
+ * as many per block.
+ *
+ * With RecordingEncoding::Delta, frames are popped into a scratch batch and
+ * encoded into the block instead; a block is sealed when the next frame
+ * might not fit, and the encoder is reset so every block starts with
+ * keyframes.
+ *
+ * Every frame also goes through a RecordingIndex, saved next to the file
+ * (recording_index_path()) once the recording is complete.
+ *
+ * With a SegmentPolicy the recording is split into segment files instead
+ * (recording_segment_path()). When a sealed block reaches the policy's
+ * size or race-time limit, the blocks so far are submitted to the old
+ * segment and writing carries on in the next one, which a SegmentRotator
+ * has already created and preallocated in the background; closing the old
+ * one, its index and retention happen there too.
+ */
+class TelemetryRecorder {
+public:
+    static constexpr size_t BLOCKS_PER_WRITE = 16;  // 1 MiB per write buffer
+
+    explicit TelemetryRecorder(TelemetryTap& tap) : tap_(&tap) {}
+    explicit TelemetryRecorder(CompactTelemetryTap& tap) : compact_tap_(&tap) {}
+
+    ~TelemetryRecorder() {
+        finish();
+    }
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    /**
+     * @brief Create the file and queue its header
+     * @return false (with `error` set) if the file cannot be created
+     */
+    bool open(const std::string& path, const RecordingHeader& header, std::string& error,
+              WriteBackend backend = DEFAULT_RECORDER_BACKEND, const SegmentPolicy& segments = {}) {
+        if ((header.encoding == RecordingEncoding::Compact) != (compact_tap_ != nullptr)) {
+            error = compact_tap_ ? "a compact tap records only the compact encoding"
+                                 : "compact recordings are fed from a CompactTelemetryTap";
+            return false;
+        }
+        encoding_ = header.encoding;
+        if (encoding_ == RecordingEncoding::Delta) {
+            scratch_.resize(RECORDING_FRAMES_PER_BLOCK);
+        }
+
+        if (segments.enabled()) {
+            policy_ = segments;
+            rotator_ = std::make_unique<SegmentRotator>();
+            if (!rotator_->start(path, header, policy_, error)) {
+                rotator_.reset();
+                return false;
+            }
+            if (!rotator_->take(segment_)) {
+                error = "cannot create " + recording_segment_path(path, 0) + ": " +
+                        std::strerror(rotator_->stats().error);
+                rotator_.reset();
+                return false;
+            }
+            if (!writer_.open(segment_.fd, segment_.direct_io, BLOCKS_PER_WRITE * RECORDING_BLOCK_BYTES,
+                              backend, error)) {
+                return false;
+            }
+            segment_.fd = -1;  // The writer's now
+            path_ = segment_.path;
+            index_pending_ = true;
+            offset_ = RECORDING_ALIGNMENT;  // Header already written
+            return true;
+        }
+
+        if (!writer_.open(path, BLOCKS_PER_WRITE * RECORDING_BLOCK_BYTES, backend, error)) {
+            return false;
+        }
+        path_ = path;
+        index_pending_ = true;
+
+        // Header padded to a full alignment unit so blocks start aligned
+        const size_t index = writer_.acquire();
+        unsigned char* buffer = writer_.buffer(index);
+        std::memset(buffer, 0, RECORDING_ALIGNMENT);
+        std::memcpy(buffer, &header, sizeof(header));
+        writer_.submit(index, RECORDING_ALIGNMENT, 0);
+        offset_ = RECORDING_ALIGNMENT;
+        return true;
+    }
+
+    void start() {
+        thread_ = std::thread([this] {
+            if (encoding_ == RecordingEncoding::Delta) {
+                record_delta_loop();
+            } else if (encoding_ == RecordingEncoding::Compact) {
+                record_direct_loop(*compact_tap_);
+            } else {
+                record_direct_loop(*tap_);
+            }
+
+            timespec cpu{};
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+            stats_.cpu_time = std::chrono::seconds(cpu.tv_sec) + std::chrono::nanoseconds(cpu.tv_nsec);
+        });
+    }
+
+    /**
+     * @brief Shut the tap, write out everything still in it and close the file
+     */
+    void finish() {
+        if (thread_.joinable()) {
+            if (tap_) tap_->shutdown();
+            if (compact_tap_) compact_tap_->shutdown();
+            thread_.join();
+        }
+        writer_.close();
+        stats_.io = writer_.stats();
+
+        if (rotator_) {
+            if (index_pending_) {
+                rotator_->retire(std::move(segment_), offset_, std::move(index_), sequence_, last_checksum_,
+                                 stats_.io.error == 0);
+            }
+            rotator_->stop();
+            stats_.segments = rotator_->stats();
+            stats_.index_bytes = stats_.segments.index_bytes;
+            index_pending_ = false;
+            return;
+        }
+
+        // A failed write leaves a truncated file; its index can be rebuilt from it
+        if (index_pending_ && stats_.io.error == 0) {
+            index_.finish(sequence_, last_checksum_);
+            std::string error;
+            if (index_.save(recording_index_path(path_), error)) {
+                stats_.index_bytes = index_.bytes();
+            }
+        }
+        index_pending_ = false;
+    }
+
+    const RecorderStats& stats() const { return stats_; }
+
+private:
+    unsigned char* block(size_t buffer, size_t index) const {
+        return writer_.buffer(buffer) + index * RECORDING_BLOCK_BYTES;
+    }
+
+    unsigned char* payload_bytes(size_t buffer, size_t index) const {
+        return block(buffer, index) + sizeof(RecordingBlockHeader);
+    }
+
+    template <typename Frame = TelemetryFrame>
+    Frame* payload(size_t buffer, size_t index) const {
+        return reinterpret_cast<Frame*>(payload_bytes(buffer, index));
+    }
+
+    static const TelemetryFrame& full_frame(const TelemetryFrame& frame) { return frame; }
+    static TelemetryFrame full_frame(const CompactTelemetryFrame& frame) { return from_compact(frame); }
+
+    // Raw and compact: frames are popped straight into the block payload
+    template <typename Frame, size_t Capacity>
+    void record_direct_loop(RingBuffer<Frame, Capacity>& tap) {
+        constexpr size_t frames_per_block = RECORDING_PAYLOAD_BYTES / sizeof(Frame);
+        size_t current = writer_.acquire();
+        size_t sealed = 0;  // Full blocks at the front of the current buffer
+        size_t fill = 0;    // Frames in the block after them
+
+        for (;;) {
+            const size_t wanted = frames_per_block - fill;
+            const size_t n = tap.pop_batch(payload<Frame>(current, sealed) + fill, wanted);
+            if (n == 0) break;  // Shut down and drained
+
+            for (size_t i = fill; i < fill + n; ++i) {
+                index_.add(full_frame(payload<Frame>(current, sealed)[i]), sequence_);
+            }
+            fill += n;
+            if (fill == frames_per_block) {
+                seal_direct<Frame>(current, sealed++, fill);
+                fill = 0;
+            }
+
+            // Write once caught up (the pop came back short), out of room or
+            // at the end of a segment; the open block carries over into the
+            // next buffer
+            if (sealed > 0 && (n < wanted || sealed == BLOCKS_PER_WRITE || rotate_due_)) {
+                submit(current, sealed);
+                const size_t next = writer_.acquire();
+                if (fill > 0) {
+                    std::memcpy(payload<Frame>(next, 0), payload<Frame>(current, sealed), fill * sizeof(Frame));
+                }
+                current = next;
+                sealed = 0;
+                if (rotate_due_) rotate();  // Due only straight after a seal, so no open block
+            }
+
+            if (n < wanted) {
+                std::this_thread::sleep_for(RECORDER_IDLE_NAP);
+            }
+        }
+
+        if (fill > 0) {
+            seal_direct<Frame>(current, sealed++, fill);
+        }
+        if (sealed > 0) {
+            submit(current, sealed);
+        }
+    }
+
+    void record_delta_loop() {
+        FrameEncoder encoder;
+        size_t current = writer_.acquire();
+        size_t sealed = 0;  // Full blocks at the front of the current buffer
+        size_t used = 0;    // Encoded bytes in the block after them
+        size_t count = 0;   // Frames in that block
+        uint32_t first_ms = 0;
+        uint32_t last_ms = 0;
+
+        for (;;) {
+            const size_t n = tap_->pop_batch(scratch_.data(), scratch_.size());
+            if (n == 0) break;  // Shut down and drained
+
+            for (size_t i = 0; i < n; ++i) {
+                if (used + MAX_ENCODED_FRAME_BYTES > RECORDING_PAYLOAD_BYTES) {
+                    seal(current, sealed++, count, used, first_ms, last_ms);
+                    encoder.reset();
+                    used = 0;
+                    count = 0;
+                    if (sealed == BLOCKS_PER_WRITE || rotate_due_) {
+                        submit(current, sealed);
+                        current = writer_.acquire();
+                        sealed = 0;
+                        if (rotate_due_) rotate();
+                    }
+                }
+
+                const TelemetryFrame& frame = scratch_[i];
+                index_.add(frame, sequence_);
+                if (count == 0) first_ms = frame.timestamp_ms;
+                last_ms = frame.timestamp_ms;
+                used += encoder.encode(frame, payload_bytes(current, sealed) + used);
+                count++;
+            }
+
+            // Caught up: write what's sealed, carrying the open block over.
+            // A segment whose race time is up ends now, not a block later.
+            if (n < scratch_.size()) {
+                if (count > 0 && segment_time_up(first_ms, last_ms)) {
+                    seal(current, sealed++, count, used, first_ms, last_ms);
+                    encoder.reset();
+                    used = 0;
+                    count = 0;
+                }
+                if (sealed > 0) {
+                    submit(current, sealed);
+                    const size_t next = writer_.acquire();
+                    std::memcpy(payload_bytes(next, 0), payload_bytes(current, sealed), used);
+                    current = next;
+                    sealed = 0;
+                    if (rotate_due_ && count == 0) rotate();
+                }
+                std::this_thread::sleep_for(RECORDER_IDLE_NAP);
+            }
+        }
+
+        if (count > 0) {
+            seal(current, sealed++, count, used, first_ms, last_ms);
+        }
+        if (sealed > 0) {
+            submit(current, sealed);
+        }
+    }
+
+    template <typename Frame>
+    void seal_direct(size_t buffer, size_t index, size_t count) {
+        const Frame* frames = payload<Frame>(buffer, index);
+        seal(buffer, index, count, count * sizeof(Frame),
+             frames[0].timestamp_ms, frames[count - 1].timestamp_ms);
+    }
+
+    void seal(size_t buffer, size_t index, size_t count, size_t bytes, uint32_t first_ms, uint32_t last_ms) {
+        RecordingBlockHeader header;
+        header.sequence = sequence_++;
+        header.frame_count = static_cast<uint32_t>(count);
+        header.first_timestamp_ms = first_ms;
+        header.last_timestamp_ms = last_ms;
+        header.payload_bytes = static_cast<uint32_t>(bytes);
+        header.checksum = recording_checksum(payload_bytes(buffer, index), bytes);
+        std::memcpy(block(buffer, index), &header, sizeof(header));
+        last_checksum_ = header.checksum;
+
+        if (header.sequence == 0) segment_first_ms_ = first_ms;
+        if (policy_.enabled()) {
+            const uint64_t next_end = RECORDING_ALIGNMENT + uint64_t{sequence_ + 1} * RECORDING_BLOCK_BYTES;
+            rotate_due_ = (policy_.max_bytes > 0 && next_end > policy_.max_bytes) ||
+                          (policy_.max_ms > 0 && last_ms - segment_first_ms_ >= policy_.max_ms);
+        }
+
+        // Zero the unused tail of a short (final) block
+        const size_t used = sizeof(header) + bytes;
+        std::memset(block(buffer, index) + used, 0, RECORDING_BLOCK_BYTES - used);
+
+        stats_.frames += count;
+        stats_.blocks++;
+    }
+
+    // Whether an open block spanning [first_ms, last_ms] takes the segment
+    // to its race-time limit
+    bool segment_time_up(uint32_t first_ms, uint32_t last_ms) const {
+        if (policy_.max_ms == 0) return false;
+        const uint32_t segment_start = sequence_ == 0 ? first_ms : segment_first_ms_;
+        return last_ms - segment_start >= policy_.max_ms;
+    }
+
+    // Called with every sealed block submitted and no block open
+    void rotate() {
+        const auto start = std::chrono::steady_clock::now();
+        rotate_due_ = false;
+        if (writer_.stats().error != 0) {
+            // Writes are failing (and reported): later segments would only
+            // ever hold a header
+            policy_ = {};
+            return;
+        }
+        SegmentRotator::Segment next;
+        if (!rotator_->take(next)) {
+            policy_ = {};  // Can't create segments: keep writing this one
+            return;
+        }
+
+        segment_.fd = writer_.swap_file(next.fd, next.direct_io);
+        rotator_->retire(std::move(segment_), offset_, std::move(index_), sequence_, last_checksum_,
+                         writer_.stats().error == 0);
+        segment_ = std::move(next);
+        segment_.fd = -1;  // The writer's now
+        path_ = segment_.path;
+        index_ = RecordingIndex();
+        offset_ = RECORDING_ALIGNMENT;
+        sequence_ = 0;
+        stats_.rotate_max = std::max<std::chrono::nanoseconds>(stats_.rotate_max,
+                                                                std::chrono::steady_clock::now() - start);
+    }
+
+    void submit(size_t buffer, size_t blocks) {
+        writer_.submit(buffer, blocks * RECORDING_BLOCK_BYTES, offset_);
+        offset_ += blocks * RECORDING_BLOCK_BYTES;
+    }
+
+    TelemetryTap* tap_ = nullptr;              // One or the other
+    CompactTelemetryTap* compact_tap_ = nullptr;
+    AsyncFileWriter writer_;
+    RecordingEncoding encoding_ = RecordingEncoding::Raw;
+    std::vector<TelemetryFrame> scratch_;  // Delta: frames popped, not yet encoded
+    uint64_t offset_ = 0;
+    uint32_t sequence_ = 0;  // Also the number of the block being filled
+    uint64_t last_checksum_ = 0;
+    std::string path_;
+    RecordingIndex index_;
+    bool index_pending_ = false;
+
+    // Segmented recordings only
+    SegmentPolicy policy_;
+    std::unique_ptr<SegmentRotator> rotator_;
+    SegmentRotator::Segment segment_;  // Being written (its descriptor is the writer's)
+    uint32_t segment_first_ms_ = 0;
+    bool rotate_due_ = false;
+
+    RecorderStats stats_;
+    std::thread thread_;
+};
+
+} // namespace f1sim
@@ -3,15 +3,18 @@
 #include "telemetry_data.h"
 #include "season_data.h"
 #include "ring_buffer.h"
+#include "terminal_screen.h"
 #include <iostream>
-#include <iomanip>
-#include <sstream>
 #include <algorithm>
 #include <array>
 #include <thread>
 #include <chrono>
 #include <atomic>
 #include <cmath>
+#include <mutex>
+#include <string_view>
+#include <sys/ioctl.h>
+#include <unistd.h>
 
 namespace f1sim {
 
@@ -49,11 +52,23 @@ namespace ANSIColor {
     constexpr const char* CLEAR_SCREEN = "\033[2J\033[H";
 }
 
+// ============================================================================
+// Telemetry UI
+// ============================================================================
+
+constexpr size_t UI_SCREEN_BYTES = 16384;  // A full leaderboard is under 5 KiB
+constexpr uint32_t UI_REDRAW_TICKS = 10;     // 5 Hz at 50 Hz physics
+constexpr size_t UI_FALLBACK_ROWS = 50;      // When stdout isn't a terminal
+constexpr size_t UI_FALLBACK_COLS = 160;
+constexpr uint64_t UI_REPAINT_DRAWS = 250;   // Repaint all now and then: stray output heals
+
 class TelemetryUI {
 public:
-    TelemetryUI(RingBuffer<TelemetryFrame>& ring_buffer, std::atomic<bool>& stop_flag)
+    TelemetryUI(RingBuffer<TelemetryFrame>& ring_buffer, std::atomic<bool>& stop_flag,
+                float track_length = TRACK_LENGTH)
         : ring_buffer_(ring_buffer)
         , stop_flag_(stop_flag)
+        , track_length_(track_length)
         , frame_counter_(0)
     {
         std::cout << "\n" << ANSIColor::BOLD << ANSIColor::CYAN 
@@ -66,6 +81,22 @@ public:
         }
     }
 
+    /**
+     * @brief Replace driver names/teams/colours (thread-safe); shown from the
+     *        next redraw
+     */
+    void set_roster(const Roster& roster) {
+        std::lock_guard<std::mutex> lock(roster_mutex_);
+        pending_roster_ = roster;
+        roster_dirty_.store(true, std::memory_order_release);
+    }
+
+    // Redraw every `ticks` physics ticks (set before run())
+    void set_redraw_ticks(uint32_t ticks) { redraw_ticks_ = std::max(ticks, 1u); }
+
+    // Differential updates (default) or the whole screen every redraw
+    void set_differential(bool differential) { differential_ = differential; }
+
     void run() {
         while (!stop_flag_.load(std::memory_order_acquire)) {
             TelemetryFrame frame;
@@ -77,27 +108,61 @@ public:
             }
             
             // Update latest frame for this driver
-            latest_frames_[frame.driver_id] = frame;
+            update(frame);
             
-            // Render at reduced rate - update every 10 frames (~5 Hz instead of 50 Hz)
+            // Render at reduced rate - every redraw_ticks_ ticks (5 Hz by default)
             if (frame.driver_id == 0) {
                 frame_counter_++;
-                if (frame_counter_ % 10 == 0) {
-                    render_leaderboard();
+                if (frame_counter_ % redraw_ticks_ == 0) {
+                    draw();
                 }
             }
         }
         
         // Final leaderboard
-        render_leaderboard();
+        draw();
         std::cout << "\n" << ANSIColor::BOLD << ANSIColor::GREEN 
                   << "🏁 Race Complete! 🏁" << ANSIColor::RESET << "\n\n";
     }
 
+    /**
+     * @brief Latest frame for its driver; shown from the next draw()
+     */
+    void update(const TelemetryFrame& frame) {
+        latest_frames_[frame.driver_id] = frame;
+    }
+
+    /**
+     * @brief Render the leaderboard and write it to stdout in one write(2):
+     *        only the cells that changed since the last draw, unless
+     *        differential updates are off
+     * @return The bytes written
+     */
+    std::string_view draw() {
+        render_leaderboard();
+        ScreenBuffer<UI_SCREEN_BYTES>* out = &screen_;
+        if (differential_) {
+            fit_terminal();
+            if (++draws_ % UI_REPAINT_DRAWS == 0) terminal_.invalidate();
+            output_.clear();
+            terminal_.update(screen_.view(), output_);
+            out = &output_;
+        }
+        std::cout << std::flush;  // Anything already printed goes first
+        out->write_to(STDOUT_FILENO);
+        return out->view();
+    }
+
+    // The whole screen as of the last draw()
+    std::string_view screen() const { return screen_.view(); }
+
 private:
     void render_leaderboard() {
+        apply_pending_roster();
+        screen_.clear();
+        
         // Clear screen and move cursor to top
-        std::cout << ANSIColor::CLEAR_SCREEN;
+        screen_.text(ANSIColor::CLEAR_SCREEN);
         
         // Sort drivers by position
         std::array<const TelemetryFrame*, NUM_DRIVERS> sorted_frames;
@@ -116,15 +181,22 @@ private:
         if (leader->driver_id == 255) return;  // No data yet
         
         // Header
-        float race_time = leader->timestamp_ms / 1000.0f;
-        int minutes = static_cast<int>(race_time) / 60;
-        int seconds = static_cast<int>(race_time) % 60;
+        uint32_t race_seconds = leader->timestamp_ms / 1000;
         
-        std::cout << ANSIColor::BOLD << ANSIColor::BRIGHT_YELLOW 
-                  << "🏁 LAP " << leader->lap << " | Race Time: " 
-                  << minutes << ":" << std::setfill('0') << std::setw(2) << seconds 
-                  << " 🏁" << ANSIColor::RESET << "\n";
-        std::cout << ANSIColor::GRAY << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << ANSIColor::RESET;
+        screen_.text(ANSIColor::BOLD);
+        screen_.text(ANSIColor::BRIGHT_YELLOW);
+        screen_.text("🏁 LAP ");
+        screen_.integer(leader->lap);
+        screen_.text(" | Race Time: ");
+        screen_.integer(race_seconds / 60);
+        screen_.text(":");
+        screen_.integer(race_seconds % 60, 2, '0');
+        screen_.text(" 🏁");
+        screen_.text(ANSIColor::RESET);
+        screen_.text("\n");
+        screen_.text(ANSIColor::GRAY);
+        screen_.text(RULE);
+        screen_.text(ANSIColor::RESET);
         
         // Leaderboard - show top 10 or all if <= 15
         size_t display_count = std::min(size_t(15), NUM_DRIVERS);
@@ -133,19 +205,42 @@ private:
             const TelemetryFrame* frame = sorted_frames[i];
             if (frame->driver_id == 255) continue;
             
-            render_driver_row(frame, i);
+            render_driver_row(frame);
         }
         
-        std::cout << ANSIColor::GRAY << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n" << ANSIColor::RESET;
-        std::cout << std::flush;
+        screen_.text(ANSIColor::GRAY);
+        screen_.text(RULE);
+        screen_.text(ANSIColor::RESET);
+    }
+    
+    // Size the screen model to the terminal; a new size repaints everything
+    void fit_terminal() {
+        winsize size{};
+        size_t rows = UI_FALLBACK_ROWS;
+        size_t cols = UI_FALLBACK_COLS;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0 && size.ws_col > 0) {
+            rows = size.ws_row;
+            cols = size.ws_col;
+        }
+        if (rows != terminal_.rows() || cols != terminal_.cols()) {
+            terminal_.resize(rows, cols);
+        }
+    }
+    
+    void apply_pending_roster() {
+        if (!roster_dirty_.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(roster_mutex_);
+        roster_ = pending_roster_;
+        roster_dirty_.store(false, std::memory_order_release);
     }
     
-    void render_driver_row(const TelemetryFrame* frame, size_t index) {
+    void render_driver_row(const TelemetryFrame* frame) {
         // Get driver info for name and team color
-        const auto& driver_info = DRIVER_ROSTER[frame->driver_id];
+        const DriverInfo& driver_info = roster_.drivers[frame->driver_id];
+        const TeamInfo& team_info = roster_.teams[driver_info.team];
         
         // Position indicator with medal emojis for podium
-        std::string position_icon;
+        const char* position_icon;
         const char* position_color = ANSIColor::WHITE;
         
         if (frame->position == 1) {
@@ -162,115 +257,160 @@ private:
             position_color = ANSIColor::WHITE;
         }
         
-        std::cout << position_icon << " " << position_color << ANSIColor::BOLD 
-                  << "P" << std::setfill(' ') << std::setw(2) << static_cast<int>(frame->position) 
-                  << ANSIColor::RESET << "  ";
+        screen_.text(position_icon);
+        screen_.text(" ");
+        screen_.text(position_color);
+        screen_.text(ANSIColor::BOLD);
+        screen_.text("P");
+        screen_.integer(frame->position, 2);
+        screen_.text(ANSIColor::RESET);
+        screen_.text("  ");
         
         // Driver name with team color
-        std::cout << driver_info.team_color << ANSIColor::BOLD 
-                  << std::setw(14) << std::left << driver_info.name 
-                  << ANSIColor::RESET << " ";
+        screen_.text(ANSI_256[team_info.color]);
+        screen_.text(ANSIColor::BOLD);
+        screen_.text_left(driver_info.name.view(), 14);
+        screen_.text(ANSIColor::RESET);
+        screen_.text(" ");
         
         // Pit indicator or progress bar
-        if (frame->flags & FLAG_IN_PITS) {
-            // Show pit stop status
-            std::cout << ANSIColor::BRIGHT_YELLOW << "🔧 [IN PITS "
-                      << std::fixed << std::setprecision(1) << frame->pit_timer 
-                      << "s] " << ANSIColor::RESET;
+        if ((frame->flags & FLAG_IN_PITS) && frame->pit_timer > 0.0f) {
+            // Stationary in the box
+            screen_.text(ANSIColor::BRIGHT_YELLOW);
+            screen_.text("🔧 [IN PITS ");
+            screen_.fixed(frame->pit_timer, 1);
+            screen_.text("s] ");
+            screen_.text(ANSIColor::RESET);
+        } else if (frame->flags & FLAG_IN_PITS) {
+            // Driving the pit lane at the limiter
+            screen_.text(ANSIColor::BRIGHT_YELLOW);
+            screen_.text("🔧 [PIT LANE]    ");
+            screen_.text(ANSIColor::RESET);
         } else {
             // Progress bar (10 characters) showing lap completion
             float lap_progress = calculate_lap_progress(frame);
-            std::cout << render_progress_bar(lap_progress, 10) << " ";
+            render_progress_bar(lap_progress, 10);
+            screen_.text(" ");
         }
         
         // Lap number
-        std::cout << ANSIColor::CYAN << "Lap " << std::setw(2) << frame->lap << ANSIColor::RESET << "  ";
+        screen_.text(ANSIColor::CYAN);
+        screen_.text("Lap ");
+        screen_.integer(frame->lap, 2);
+        screen_.text(ANSIColor::RESET);
+        screen_.text("  ");
         
         // Gap to leader (or "LEADER" for P1)
         if (frame->position == 1) {
-            std::cout << ANSIColor::BRIGHT_GREEN << "LEADER    " << ANSIColor::RESET;
+            screen_.text(ANSIColor::BRIGHT_GREEN);
+            screen_.text("LEADER    ");
+            screen_.text(ANSIColor::RESET);
         } else {
             const char* gap_color = frame->gap_to_leader < 5.0f ? ANSIColor::BRIGHT_YELLOW : ANSIColor::WHITE;
-            std::cout << gap_color << "+" << std::fixed << std::setprecision(3) 
-                      << std::setw(6) << frame->gap_to_leader << "s" << ANSIColor::RESET << " ";
+            screen_.text(gap_color);
+            screen_.text("+");
+            screen_.fixed(frame->gap_to_leader, 3, 6);
+            screen_.text("s");
+            screen_.text(ANSIColor::RESET);
+            screen_.text(" ");
+        }
+        
+        // Interval to the car ahead
+        if (frame->position == 1) {
+            screen_.text("        ");
+        } else {
+            screen_.text(ANSIColor::GRAY);
+            screen_.text("+");
+            screen_.fixed_point(frame->interval_cs, 2, 6);
+            screen_.text(ANSIColor::RESET);
+            screen_.text(" ");
         }
         
         // Speed (color-coded: green=fast, yellow=medium, red=slow)
-        const char* speed_color = get_speed_color(frame->speed);
-        std::cout << speed_color << std::setw(3) << static_cast<int>(frame->speed) 
-                  << " km/h" << ANSIColor::RESET << "  ";
+        screen_.text(get_speed_color(frame->speed));
+        screen_.integer(static_cast<int>(frame->speed), 3);
+        screen_.text(" km/h");
+        screen_.text(ANSIColor::RESET);
+        screen_.text(" ");
+        
+        // DRS flap open
+        if (frame->flags & FLAG_DRS_OPEN) {
+            screen_.text(ANSIColor::BRIGHT_GREEN);
+            screen_.text("DRS");
+            screen_.text(ANSIColor::RESET);
+            screen_.text(" ");
+        } else {
+            screen_.text("    ");
+        }
         
         // Tire wear (color-coded: green=fresh, yellow=worn, red=critical)
-        const char* tire_color = get_tire_color(frame->tire_wear);
-        std::cout << tire_color << "Tire: " << std::setw(2) << static_cast<int>(frame->tire_wear) 
-                  << "%" << ANSIColor::RESET;
+        screen_.text(get_tire_color(frame->tire_wear));
+        screen_.text("Tire: ");
+        screen_.integer(static_cast<int>(frame->tire_wear), 2);
+        screen_.text("%");
+        screen_.text(ANSIColor::RESET);
         
         // Pit stop count
         if (frame->pit_stops > 0) {
-            std::cout << "  " << ANSIColor::MAGENTA << "Stops:" << frame->pit_stops << ANSIColor::RESET;
+            screen_.text("  ");
+            screen_.text(ANSIColor::MAGENTA);
+            screen_.text("Stops:");
+            screen_.integer(frame->pit_stops);
+            screen_.text(ANSIColor::RESET);
         }
         
         // Sector times (show if lap > 1, as we need at least one sector completion)
         if (frame->lap > 1 || frame->sector > 0) {
-            std::cout << "  " << ANSIColor::GRAY << "[";
-            
-            // S1
-            if (frame->sector_times[0] > 0) {
-                std::cout << "S1:" << format_sector_time(frame->sector_times[0]);
-            } else {
-                std::cout << "S1:--.-";
-            }
+            screen_.text("  ");
+            screen_.text(ANSIColor::GRAY);
+            screen_.text("[");
             
-            std::cout << " ";
-            
-            // S2
-            if (frame->sector_times[1] > 0) {
-                std::cout << "S2:" << format_sector_time(frame->sector_times[1]);
-            } else {
-                std::cout << "S2:--.-";
-            }
-            
-            std::cout << " ";
-            
-            // S3
-            if (frame->sector_times[2] > 0) {
-                std::cout << "S3:" << format_sector_time(frame->sector_times[2]);
-            } else {
-                std::cout << "S3:--.-";
+            static constexpr std::string_view SECTOR_LABELS[3] = {"S1:", "S2:", "S3:"};
+            for (size_t s = 0; s < 3; ++s) {
+                if (s > 0) screen_.text(" ");
+                screen_.text(SECTOR_LABELS[s]);
+                if (frame->sector_times[s] > 0) {
+                    format_sector_time(frame->sector_times[s]);
+                } else {
+                    screen_.text("--.-");
+                }
             }
             
-            std::cout << "]" << ANSIColor::RESET;
+            screen_.text("]");
+            screen_.text(ANSIColor::RESET);
         }
         
         // Last lap time (show if we've completed at least one lap)
         if (frame->last_lap_time > 0) {
-            std::cout << "  " << ANSIColor::BRIGHT_CYAN << "⏱ " 
-                      << format_lap_time(frame->last_lap_time) << ANSIColor::RESET;
+            screen_.text("  ");
+            screen_.text(ANSIColor::BRIGHT_CYAN);
+            screen_.text("⏱ ");
+            format_lap_time(frame->last_lap_time);
+            screen_.text(ANSIColor::RESET);
         }
         
-        std::cout << "\n";
+        screen_.text("\n");
     }
     
-    std::string render_progress_bar(float progress, int width) {
+    void render_progress_bar(float progress, int width) {
         int filled = static_cast<int>(progress * width);
-        std::string bar = ANSIColor::GREEN;
+        screen_.text(ANSIColor::GREEN);
         
         for (int i = 0; i < width; ++i) {
             if (i < filled) {
-                bar += "█";
+                screen_.text("█");
             } else {
-                bar += ANSIColor::GRAY;
-                bar += "░";
+                if (i == std::max(filled, 0)) screen_.text(ANSIColor::GRAY);
+                screen_.text("░");
             }
         }
         
-        bar += ANSIColor::RESET;
-        return bar;
+        screen_.text(ANSIColor::RESET);
     }
     
     float calculate_lap_progress(const TelemetryFrame* frame) {
-        float lap_distance = frame->distance - (TRACK_LENGTH * (frame->lap - 1));
-        float progress = lap_distance / TRACK_LENGTH;
+        float lap_distance = frame->distance - (track_length_ * (frame->lap - 1));
+        float progress = lap_distance / track_length_;
         return std::clamp(progress, 0.0f, 1.0f);
     }
     
@@ -286,32 +426,43 @@ private:
         return ANSIColor::BRIGHT_RED;
     }
     
-    std::string format_sector_time(uint32_t time_ms) {
+    void format_sector_time(uint32_t time_ms) {
         // Format: XX.X (e.g., 23.4)
-        float seconds = time_ms / 1000.0f;
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(1) << seconds;
-        return oss.str();
+        screen_.fixed_point((time_ms + 50) / 100, 1);
     }
     
-    std::string format_lap_time(uint32_t time_ms) {
+    void format_lap_time(uint32_t time_ms) {
         // Format: M:SS.sss (e.g., 1:42.341)
-        int minutes = time_ms / 60000;
-        int seconds = (time_ms % 60000) / 1000;
-        int milliseconds = time_ms % 1000;
-        
-        std::ostringstream oss;
-        oss << minutes << ":" 
-            << std::setfill('0') << std::setw(2) << seconds << "."
-            << std::setfill('0') << std::setw(3) << milliseconds;
-        return oss.str();
+        screen_.integer(time_ms / 60000);
+        screen_.text(":");
+        screen_.integer((time_ms % 60000) / 1000, 2, '0');
+        screen_.text(".");
+        screen_.integer(time_ms % 1000, 3, '0');
     }
 
 private:
+    static constexpr std::string_view RULE =
+        "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+
     RingBuffer<TelemetryFrame>& ring_buffer_;
     std::atomic<bool>& stop_flag_;
+    float track_length_;
     std::array<TelemetryFrame, NUM_DRIVERS> latest_frames_;
     uint64_t frame_counter_;
+    uint32_t redraw_ticks_ = UI_REDRAW_TICKS;
+    ScreenBuffer<UI_SCREEN_BYTES> screen_;  // Reused by every draw
+    
+    // What the terminal shows, and the bytes that update it
+    bool differential_ = true;
+    TerminalScreen terminal_;
+    ScreenBuffer<UI_SCREEN_BYTES> output_;
+    uint64_t draws_ = 0;
+    
+    // Driver roster, with updates staged like the engine's profiles
+    Roster roster_ = DEFAULT_ROSTER;
+    std::mutex roster_mutex_;
+    std::atomic<bool> roster_dirty_{false};
+    Roster pending_roster_ = DEFAULT_ROSTER;
 };
 
 } // namespace f1sim
@@ -0,0 +1,518 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Screen Buffer
+// ============================================================================
+
+/**
+ * @brief Fixed-capacity text buffer a whole screen is rendered into, then
+ *        written with one write(2)
+ *
+ * Numbers are formatted by hand into the buffer. Text past the capacity is
+ * dropped (truncated()) rather than grown, so rendering never allocates.
+ */
+template <size_t Capacity>
+class ScreenBuffer {
+public:
+    void clear() {
+        size_ = 0;
+        truncated_ = false;
+    }
+
+    std::string_view view() const { return {data_.data(), size_}; }
+    bool truncated() const { return truncated_; }
+
+    void text(std::string_view s) {
+        const size_t n = std::min(s.size(), Capacity - size_);
+        std::memcpy(data_.data() + size_, s.data(), n);
+        size_ += n;
+        truncated_ = truncated_ || n < s.size();
+    }
+
+    void repeat(char c, size_t count) {
+        const size_t n = std::min(count, Capacity - size_);
+        std::memset(data_.data() + size_, c, n);
+        size_ += n;
+        truncated_ = truncated_ || n < count;
+    }
+
+    // Left-aligned in `width` bytes, like std::left << std::setw(width)
+    void text_left(std::string_view s, size_t width) {
+        text(s);
+        if (s.size() < width) repeat(' ', width - s.size());
+    }
+
+    // Right-aligned in `width`, padded with `fill`
+    void integer(int64_t value, size_t width = 0, char fill = ' ') {
+        char digits[24];
+        char* end = digits + sizeof(digits);
+        char* p = format_digits(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value), end);
+        if (value < 0) *--p = '-';
+        padded(std::string_view(p, static_cast<size_t>(end - p)), width, fill);
+    }
+
+    // `scaled` / 10^decimals with exactly `decimals` digits after the point,
+    // right-aligned in `width`
+    void fixed_point(int64_t scaled, int decimals, size_t width = 0) {
+        char digits[32];
+        char* end = digits + sizeof(digits);
+        uint64_t magnitude = scaled < 0 ? 0 - static_cast<uint64_t>(scaled) : static_cast<uint64_t>(scaled);
+        char* p = end;
+        for (int d = 0; d < decimals; ++d) {
+            *--p = static_cast<char>('0' + magnitude % 10);
+            magnitude /= 10;
+        }
+        if (decimals > 0) *--p = '.';
+        p = format_digits(magnitude, p);
+        if (scaled < 0) *--p = '-';
+        padded(std::string_view(p, static_cast<size_t>(end - p)), width, ' ');
+    }
+
+    // Like std::fixed << std::setprecision(decimals) << std::setw(width)
+    void fixed(float value, int decimals, size_t width = 0) {
+        if (!std::isfinite(value)) {
+            padded("--", width, ' ');
+            return;
+        }
+        double scale = 1.0;
+        for (int d = 0; d < decimals; ++d) scale *= 10.0;
+        fixed_point(std::llround(static_cast<double>(value) * scale), decimals, width);
+    }
+
+    /**
+     * @brief Write the buffer to `fd`: one write(2) unless the kernel takes
+     *        it in parts
+     * @return false on a write error
+     */
+    bool write_to(int fd) const {
+        const char* p = data_.data();
+        size_t left = size_;
+        while (left > 0) {
+            const ssize_t n = ::write(fd, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    // Decimal digits of `value` written backwards ending at `end`
+    static char* format_digits(uint64_t value, char* end) {
+        char* p = end;
+        do {
+            *--p = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        return p;
+    }
+
+    void padded(std::string_view s, size_t width, char fill) {
+        if (s.size() < width) repeat(fill, width - s.size());
+        text(s);
+    }
+
+    std::array<char, Capacity> data_;
+    size_t size_ = 0;
+    bool truncated_ = false;
+};
+
+// ============================================================================
+// Terminal Cell Grid
+// ============================================================================
+
+constexpr uint16_t TERMINAL_BOLD = 1 << 0;
+
+/**
+ * @brief SGR state of a cell: attributes plus foreground/background colour
+ *
+ * A colour is 0 (terminal default), the SGR code itself for the 16 basic
+ * colours (30-37/90-97, 40-47/100-107), or 256 + N for 256-colour N.
+ */
+struct TerminalStyle {
+    uint16_t fg = 0;
+    uint16_t bg = 0;
+    uint16_t attributes = 0;  // TERMINAL_BOLD
+
+    bool operator==(const TerminalStyle&) const = default;
+};
+
+/**
+ * @brief One screen column: a UTF-8 glyph and its style
+ *
+ * A wide glyph (most emoji) takes its cell and the next, which holds no
+ * bytes and has width 0. Glyph bytes past `bytes` are zero and there is no
+ * padding, so cells (and whole rows) compare with memcmp.
+ */
+struct TerminalCell {
+    char glyph[8] = {' '};  // A code point plus any zero-width ones after it
+    TerminalStyle style;
+    uint8_t bytes = 1;
+    uint8_t width = 1;      // Columns: 1, 2, or 0 for the right half of a wide glyph
+
+    bool operator==(const TerminalCell& other) const {
+        return std::memcmp(this, &other, sizeof(TerminalCell)) == 0;
+    }
+};
+
+static_assert(sizeof(TerminalCell) == 16 && std::has_unique_object_representations_v<TerminalCell>);
+
+/**
+ * @brief Columns a code point takes in a terminal (wcwidth() without the
+ *        locale): 2 for East Asian wide and emoji presentation ranges, 0 for
+ *        combining marks, joiners and variation selectors, else 1
+ */
+constexpr int terminal_char_width(char32_t cp) {
+    if ((cp >= 0x0300 && cp <= 0x036F) || cp == 0x200D || (cp >= 0xFE00 && cp <= 0xFE0F)) return 0;
+    if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF) || (cp >= 0xAC00 && cp <= 0xD7A3) ||
+        (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0xFE30 && cp <= 0xFE4F) || (cp >= 0xFF00 && cp <= 0xFF60) ||
+        (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1F64F) || (cp >= 0x1F900 && cp <= 0x1FAFF) ||
+        (cp >= 0x20000 && cp <= 0x3FFFD)) {
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * @brief A terminal's screen as rows × cols cells, driven by the same
+ *        bytes a terminal would be
+ *
+ * apply() understands what the UI emits: UTF-8 text, \n and \r, SGR
+ * (ESC[...m), cursor position (ESC[r;cH), cursor forward (ESC[nC) and
+ * clear screen (ESC[2J); other escape sequences are skipped. Text past the
+ * right edge is clipped, not wrapped. Cursor and style carry over from one
+ * apply() to the next.
+ */
+class TerminalGrid {
+public:
+    void resize(size_t rows, size_t cols) {
+        rows_ = rows;
+        cols_ = cols;
+        cells_.assign(rows * cols, TerminalCell{});
+        lines_ = 0;
+        clear();
+    }
+
+    // Blank screen, cursor home, default style
+    void clear() {
+        clear_cells();
+        row_ = 0;
+        col_ = 0;
+        style_ = {};
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    const TerminalCell& at(size_t row, size_t col) const { return cells_[row * cols_ + col]; }
+
+    // Rows up to the last one text was written on (all rows below are blank)
+    size_t lines() const { return lines_; }
+
+    bool operator==(const TerminalGrid& other) const { return cells_ == other.cells_; }
+
+    bool same_row(const TerminalGrid& other, size_t row) const {
+        return std::memcmp(&at(row, 0), &other.at(row, 0), cols_ * sizeof(TerminalCell)) == 0;
+    }
+
+    void apply(std::string_view bytes) {
+        size_t i = 0;
+        while (i < bytes.size()) {
+            const auto c = static_cast<unsigned char>(bytes[i]);
+            if (c == '\033') {
+                i = escape(bytes, i);
+            } else if (c == '\n') {
+                row_++;
+                col_ = 0;
+                i++;
+            } else if (c == '\r') {
+                col_ = 0;
+                i++;
+            } else if (c < 0x20) {
+                i++;
+            } else {
+                i = glyph(bytes, i);
+            }
+        }
+    }
+
+private:
+    TerminalCell& cell(size_t row, size_t col) { return cells_[row * cols_ + col]; }
+
+    void clear_cells() {
+        std::fill(cells_.begin(), cells_.begin() + static_cast<std::ptrdiff_t>(lines_ * cols_), TerminalCell{});
+        lines_ = 0;
+    }
+
+    // ESC at `i`; returns the index after the sequence
+    size_t escape(std::string_view bytes, size_t i) {
+        if (i + 1 >= bytes.size() || bytes[i + 1] != '[') return i + 1;
+        size_t end = i + 2;
+        while (end < bytes.size() && (bytes[end] < 0x40 || bytes[end] > 0x7E)) end++;
+        if (end == bytes.size()) return end;
+
+        uint32_t params[16] = {};
+        size_t count = 1;
+        for (size_t k = i + 2; k < end; ++k) {
+            if (bytes[k] == ';') {
+                if (count < 16) count++;
+            } else if (bytes[k] >= '0' && bytes[k] <= '9') {
+                params[count - 1] = params[count - 1] * 10 + static_cast<uint32_t>(bytes[k] - '0');
+            }
+        }
+        switch (bytes[end]) {
+            case 'm': sgr(params, count); break;
+            case 'H':
+                row_ = params[0] > 0 ? params[0] - 1 : 0;
+                col_ = count > 1 && params[1] > 0 ? params[1] - 1 : 0;
+                break;
+            case 'C':
+                col_ = std::min<size_t>(col_ + std::max<uint32_t>(params[0], 1), cols_ > 0 ? cols_ - 1 : 0);
+                break;
+            case 'J':
+                if (params[0] == 2) clear_cells();
+                break;
+            default: break;
+        }
+        return end + 1;
+    }
+
+    void sgr(const uint32_t* params, size_t count) {
+        for (size_t k = 0; k < count; ++k) {
+            const uint32_t p = params[k];
+            if (p == 0) style_ = {};
+            else if (p == 1) style_.attributes |= TERMINAL_BOLD;
+            else if (p == 22) style_.attributes &= static_cast<uint16_t>(~TERMINAL_BOLD);
+            else if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97)) style_.fg = static_cast<uint16_t>(p);
+            else if ((p >= 40 && p <= 47) || (p >= 100 && p <= 107)) style_.bg = static_cast<uint16_t>(p);
+            else if (p == 39) style_.fg = 0;
+            else if (p == 49) style_.bg = 0;
+            else if ((p == 38 || p == 48) && k + 2 < count && params[k + 1] == 5) {
+                (p == 38 ? style_.fg : style_.bg) = static_cast<uint16_t>(256 + std::min(params[k + 2], 255u));
+                k += 2;
+            }
+        }
+    }
+
+    // UTF-8 sequence at `i`; returns the index after it
+    size_t glyph(std::string_view bytes, size_t i) {
+        const auto lead = static_cast<unsigned char>(bytes[i]);
+        if (lead < 0x80) {
+            put(bytes.data() + i, 1, 1);
+            return i + 1;
+        }
+        const size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+        if (i + length > bytes.size()) return bytes.size();
+        char32_t cp = lead & (0x7F >> length);
+        for (size_t k = 1; k < length; ++k) {
+            cp = cp << 6 | (static_cast<unsigned char>(bytes[i + k]) & 0x3F);
+        }
+
+        const int width = terminal_char_width(cp);
+        if (width > 0) {
+            put(bytes.data() + i, length, static_cast<size_t>(width));
+        } else if (row_ < rows_ && col_ > 0 && col_ <= cols_) {
+            // Joins the glyph before it
+            size_t lead_col = col_ - 1;
+            if (lead_col > 0 && at(row_, lead_col).width == 0) lead_col--;
+            TerminalCell& previous = cell(row_, lead_col);
+            if (previous.bytes + length <= sizeof(previous.glyph)) {
+                std::memcpy(previous.glyph + previous.bytes, bytes.data() + i, length);
+                previous.bytes = static_cast<uint8_t>(previous.bytes + length);
+            }
+        }
+        return i + length;
+    }
+
+    // A glyph at the cursor, clipped at the right edge and bottom. Fields
+    // are stored in place: a cell assembled byte by byte and then copied
+    // stalls on store forwarding.
+    void put(const char* glyph, size_t length, size_t width) {
+        if (row_ < rows_ && col_ + width <= cols_) {
+            uint64_t packed = 0;
+            std::memcpy(&packed, glyph, length);
+            TerminalCell& target = cell(row_, col_);
+            std::memcpy(target.glyph, &packed, sizeof(packed));
+            target.style = style_;
+            target.bytes = static_cast<uint8_t>(length);
+            target.width = static_cast<uint8_t>(width);
+            if (width == 2) {
+                TerminalCell& right = cell(row_, col_ + 1);
+                std::memset(right.glyph, 0, sizeof(right.glyph));
+                right.style = style_;
+                right.bytes = 0;
+                right.width = 0;
+            }
+            lines_ = std::max(lines_, row_ + 1);
+        }
+        col_ += width;
+    }
+
+    std::vector<TerminalCell> cells_;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t row_ = 0;
+    size_t col_ = 0;
+    size_t lines_ = 0;
+    TerminalStyle style_;
+};
+
+// ============================================================================
+// Differential Screen Updates
+// ============================================================================
+
+/**
+ * @brief Turns a sequence of full-screen frames into the bytes that repaint
+ *        only the cells that changed
+ *
+ * Each frame is applied to a blank TerminalGrid and compared cell by cell
+ * with the previous one. Changed cells are written after a cursor move
+ * (ESC[nC along the row, ESC[r;cH otherwise), with an SGR only where the
+ * style differs from the last cell written; a short run of unchanged cells
+ * between two changes is rewritten instead when that is cheaper than a
+ * move. A wide glyph is always written whole, from its left cell. The
+ * first frame, and the first after resize() or invalidate(), clears the
+ * screen and paints everything.
+ *
+ * After each update the style is reset and the cursor parked on the line
+ * below the frame, so anything printed afterwards lands under it.
+ */
+class TerminalScreen {
+public:
+    void resize(size_t rows, size_t cols) {
+        previous_.resize(rows, cols);
+        current_.resize(rows, cols);
+        full_ = true;
+    }
+
+    size_t rows() const { return current_.rows(); }
+    size_t cols() const { return current_.cols(); }
+
+    // The terminal no longer shows the last frame: repaint it all next time
+    void invalidate() { full_ = true; }
+
+    /**
+     * @brief Append to `out` what turns the last frame into `frame`
+     *
+     * Appends nothing if no cell changed. If `out` runs out of room the
+     * next update repaints everything.
+     */
+    template <size_t Capacity>
+    void update(std::string_view frame, ScreenBuffer<Capacity>& out) {
+        current_.clear();
+        current_.apply(frame);
+        if (full_) {
+            previous_.clear();
+            out.text("\033[0m\033[2J\033[H");
+        }
+
+        // Where the terminal's cursor is, and in what style (none: unknown)
+        size_t cursor_row = SIZE_MAX;
+        size_t cursor_col = SIZE_MAX;
+        TerminalStyle style;
+        bool changed = full_;
+
+        const size_t lines = std::max(current_.lines(), previous_.lines());  // Blank below in both
+        for (size_t r = 0; r < lines; ++r) {
+            if (current_.same_row(previous_, r)) continue;
+            for (size_t c = 0; c < current_.cols(); ++c) {
+                if (current_.at(r, c) == previous_.at(r, c)) continue;
+                if (current_.at(r, c).width == 0) {
+                    if (c == 0 || (cursor_row == r && cursor_col > c - 1)) continue;  // Written with its left half
+                    c--;
+                }
+                changed = true;
+
+                if (cursor_row == r && cursor_col < c && c - cursor_col <= MAX_BRIDGE_CELLS) {
+                    for (size_t k = cursor_col; k < c; ++k) {
+                        write_cell(current_.at(r, k), style, out);
+                    }
+                } else if (cursor_row == r && cursor_col < c) {
+                    forward(c - cursor_col, out);
+                } else if (cursor_row != r || cursor_col != c) {
+                    move(r, c, out);
+                }
+                write_cell(current_.at(r, c), style, out);
+                cursor_row = r;
+                cursor_col = c + std::max<size_t>(current_.at(r, c).width, 1);
+                if (cursor_col >= current_.cols()) cursor_row = SIZE_MAX;  // Pending wrap: position unknown
+                if (current_.at(r, c).width == 2) c++;
+            }
+        }
+
+        if (changed) {
+            if (!(style == TerminalStyle{})) out.text("\033[0m");
+            move(std::min(current_.lines(), current_.rows() - 1), 0, out);
+        }
+        full_ = out.truncated();
+        std::swap(previous_, current_);
+    }
+
+private:
+    static constexpr size_t MAX_BRIDGE_CELLS = 3;  // ESC[nC is 4-6 bytes
+
+    template <size_t Capacity>
+    static void move(size_t row, size_t col, ScreenBuffer<Capacity>& out) {
+        out.text("\033[");
+        out.integer(static_cast<int64_t>(row + 1));
+        out.text(";");
+        out.integer(static_cast<int64_t>(col + 1));
+        out.text("H");
+    }
+
+    template <size_t Capacity>
+    static void forward(size_t cells, ScreenBuffer<Capacity>& out) {
+        out.text("\033[");
+        out.integer(static_cast<int64_t>(cells));
+        out.text("C");
+    }
+
+    template <size_t Capacity>
+    static void write_cell(const TerminalCell& cell, TerminalStyle& style, ScreenBuffer<Capacity>& out) {
+        if (cell.width == 0) return;  // Right half: written with the left
+        if (!(cell.style == style)) {
+            out.text("\033[0");
+            if (cell.style.attributes & TERMINAL_BOLD) out.text(";1");
+            color(cell.style.fg, 38, out);
+            color(cell.style.bg, 48, out);
+            out.text("m");
+            style = cell.style;
+        }
+        out.text(std::string_view(cell.glyph, cell.bytes));
+    }
+
+    template <size_t Capacity>
+    static void color(uint16_t value, int extended, ScreenBuffer<Capacity>& out) {
+        if (value == 0) return;
+        out.text(";");
+        if (value >= 256) {
+            out.integer(extended);
+            out.text(";5;");
+            out.integer(value - 256);
+        } else {
+            out.integer(value);
+        }
+    }
+
+    TerminalGrid previous_;
+    TerminalGrid current_;
+    bool full_ = true;
+};
+
+} // namespace f1sim
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace f1sim {
+
+// ============================================================================
+// Thread Pool
+// ============================================================================
+
+/**
+ * @brief Fixed set of worker threads for fork-join loops
+ *
+ * parallel_for() hands out indices from a shared atomic counter to the
+ * workers and the calling thread, then returns once every claimed index has
+ * finished. Nothing is allocated per call: the loop body is passed by pointer
+ * and the workers sleep on a condition variable between calls.
+ *
+ * A deadline stops new indices from being handed out; bodies already running
+ * are waited for, so the overshoot is bounded by one body. Callers find out
+ * which indices ran from their own output.
+ *
+ * A pool of 0 workers runs everything on the calling thread. `on_start`,
+ * if given, runs first on each worker (e.g. to pin it like its caller).
+ */
+class ThreadPool {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit ThreadPool(size_t workers, const std::function<void()>& on_start = {}) {
+        threads_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, on_start] {
+                if (on_start) on_start();
+                worker_loop();
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t workers() const { return threads_.size(); }
+
+    /**
+     * @brief Run fn(i) for each i in [0, count) until done or past `deadline`
+     * @return Number of indices that ran
+     */
+    template <typename Fn>
+    size_t parallel_for(size_t count, Fn&& fn, clock::time_point deadline = clock::time_point::max()) {
+        if (count == 0) return 0;
+
+        Job job;
+        job.body = [](void* ctx, size_t i) { (*static_cast<std::remove_reference_t<Fn>*>(ctx))(i); };
+        job.ctx = const_cast<void*>(static_cast<const void*>(std::addressof(fn)));
+        job.count = count;
+        job.deadline = deadline;
+
+        if (!threads_.empty()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        run(job);
+
+        if (!threads_.empty()) {
+            // Workers only touch `job` between picking it up and leaving it
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ = nullptr;
+            idle_.wait(lock, [&] { return job.active == 0; });
+        }
+        return job.completed.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Job {
+        void (*body)(void*, size_t) = nullptr;
+        void* ctx = nullptr;
+        size_t count = 0;
+        clock::time_point deadline;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> completed{0};
+        size_t active = 0;  // Workers inside run(), guarded by mutex_
+    };
+
+    static void run(Job& job) {
+        for (;;) {
+            if (clock::now() > job.deadline) return;
+            size_t i = job.next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= job.count) return;
+            job.body(job.ctx, i);
+            job.completed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        for (;;) {
+            wake_.wait(lock, [&] { return shutdown_ || (job_ && generation_ != seen); });
+            if (shutdown_) return;
+
+            seen = generation_;
+            Job& job = *job_;
+            job.active++;
+
+            lock.unlock();
+            run(job);
+            lock.lock();
+
+            if (--job.active == 0) {
+                idle_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    Job* job_ = nullptr;
+    uint64_t generation_ = 0;
+    bool shutdown_ = false;
+};
+
+} // namespace f1sim
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace f1sim {
+
+// ============================================================================
+// Tick Deadline Monitoring
+// ============================================================================
+
+/**
+ * @brief What the engine does when a tick finishes past its deadline
+ *
+ * CatchUp:       keep the original schedule and run late ticks back-to-back
+ *                until the engine is on time again (sim time stays locked to
+ *                wall time, at the cost of a burst).
+ * DropAndResync: skip the wall-clock slots that were missed and resume on the
+ *                next slot boundary. Sim time falls behind wall time by the
+ *                dropped slots; physics still advances by exactly DT per tick.
+ * SlowMotion:    re-base the schedule on the late finish time, so the overrun
+ *                stretches the race instead of being paid back.
+ */
+enum class OverrunPolicy : uint8_t {
+    CatchUp,
+    DropAndResync,
+    SlowMotion
+};
+
+constexpr std::string_view overrun_policy_name(OverrunPolicy policy) {
+    switch (policy) {
+        case OverrunPolicy::CatchUp:       return "catchup";
+        case OverrunPolicy::DropAndResync: return "drop";
+        case OverrunPolicy::SlowMotion:    return "slow";
+    }
+    return "unknown";
+}
+
+constexpr bool parse_overrun_policy(std::string_view name, OverrunPolicy& out) {
+    for (auto policy : {OverrunPolicy::CatchUp, OverrunPolicy::DropAndResync, OverrunPolicy::SlowMotion}) {
+        if (name == overrun_policy_name(policy)) {
+            out = policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Per-tick timing counters kept by the producer thread
+ *
+ * Compute is update_simulation(), push is publishing the frames (includes any
+ * time blocked on a full ring), slack is what was left of the tick budget
+ * afterwards (negative on an overrun). Overruns are bucketed by log2 of their
+ * size in microseconds: bucket 0 is < 2 µs, bucket k is [2^k, 2^(k+1)) µs,
+ * and the last bucket collects everything larger.
+ *
+ * Plain integers, written only by the producer: read them after the engine
+ * thread has been joined.
+ */
+struct TickTimingStats {
+    using nanos = std::chrono::nanoseconds;
+    static constexpr size_t HISTOGRAM_BUCKETS = 24;  // Last bucket: >= ~8.4 s
+
+    uint64_t ticks = 0;
+    uint64_t overruns = 0;
+    uint64_t dropped_ticks = 0;   // DropAndResync: wall-clock slots skipped
+    nanos slow_motion_slip{0};    // SlowMotion: total time the race was stretched
+    
+    nanos compute_total{0};
+    nanos compute_max{0};
+    nanos push_total{0};
+    nanos push_max{0};
+    nanos slack_min{nanos::max()};
+    nanos overrun_max{0};
+    
+    std::array<uint64_t, HISTOGRAM_BUCKETS> overrun_histogram{};
+
+    void record(nanos compute, nanos push, nanos slack) {
+        ticks++;
+        compute_total += compute;
+        compute_max = std::max(compute_max, compute);
+        push_total += push;
+        push_max = std::max(push_max, push);
+        slack_min = std::min(slack_min, slack);
+        
+        if (slack < nanos::zero()) {
+            nanos overrun = -slack;
+            overruns++;
+            overrun_max = std::max(overrun_max, overrun);
+            overrun_histogram[histogram_bucket(overrun)]++;
+        }
+    }
+
+    static size_t histogram_bucket(nanos overrun) {
+        auto micros = static_cast<uint64_t>(overrun.count() / 1000);
+        size_t bucket = micros < 2 ? 0 : static_cast<size_t>(std::bit_width(micros) - 1);
+        return std::min(bucket, HISTOGRAM_BUCKETS - 1);
+    }
+
+    // Lower edge of a histogram bucket in microseconds
+    static uint64_t bucket_floor_us(size_t bucket) {
+        return bucket == 0 ? 0 : (uint64_t{1} << bucket);
+    }
+};
+
+} // namespace f1sim
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace f1sim {
+
+// ============================================================================
+// Timing Loops
+// ============================================================================
+
+constexpr float TIMING_LOOP_SPACING_M = 10.0f;   // A virtual timing line every 10 m
+constexpr size_t TIMING_HISTORY_LOOPS = 2048;    // Per car: the last ~20 km of crossings
+
+static_assert((TIMING_HISTORY_LOOPS & (TIMING_HISTORY_LOOPS - 1)) == 0,
+              "TIMING_HISTORY_LOOPS must be a power of two");
+
+/**
+ * @brief Per-car history of timing-line crossing times
+ *
+ * Loops are numbered along total race distance (loop k sits at
+ * k × TIMING_LOOP_SPACING_M), so a car's crossing of loop k lives at
+ * slot k % TIMING_HISTORY_LOOPS of its fixed ring: no search, no allocation,
+ * and older laps are overwritten in place.
+ *
+ * The gap between two cars is a real time difference at the same point on
+ * track: when the follower crossed its latest loop versus when the reference
+ * car crossed it. While the follower is stationary (pit box) the gap keeps
+ * growing, because the reference car's crossing of the follower's next loop
+ * bounds it from below.
+ *
+ * @tparam NumCars Number of cars tracked
+ */
+template <size_t NumCars>
+class TimingLoops {
+public:
+    static constexpr int64_t NO_LOOP = INT64_MIN;
+    static constexpr float NO_GAP = -1.0f;  // History does not reach back far enough
+
+    void reset() {
+        last_loop_.fill(NO_LOOP);
+    }
+
+    /**
+     * @brief Record every loop a car crossed while moving from `from` to `to`
+     *        (total distance, meters) during the tick starting at `tick_start_ms`
+     *
+     * Crossing times are interpolated linearly within the tick.
+     */
+    void record(size_t car, float from, float to, double tick_start_ms, double tick_ms) {
+        if (to <= from) return;
+        
+        auto loop = static_cast<int64_t>(std::floor(from / TIMING_LOOP_SPACING_M)) + 1;
+        const auto last = static_cast<int64_t>(std::floor(to / TIMING_LOOP_SPACING_M));
+        const double span = static_cast<double>(to) - static_cast<double>(from);
+        
+        for (; loop <= last; ++loop) {
+            double loop_distance = static_cast<double>(loop) * TIMING_LOOP_SPACING_M;
+            double fraction = (loop_distance - static_cast<double>(from)) / span;
+            crossing_ms_[car][slot(loop)] = static_cast<uint32_t>(tick_start_ms + fraction * tick_ms + 0.5);
+            last_loop_[car] = loop;
+        }
+    }
+
+    /**
+     * @brief Time (seconds) `car` is behind `reference` at the same track point
+     * @param now_ms Current race time, used while `car` is stationary
+     * @return 0 if `reference` has not crossed `car`'s latest loop, NO_GAP if the reference car's
+     *         crossing has already been overwritten (more than ~20 km ahead)
+     */
+    float gap(size_t car, size_t reference, double now_ms) const {
+        const int64_t k = last_loop_[car];
+        const int64_t ref_last = last_loop_[reference];
+        if (k == NO_LOOP || ref_last == NO_LOOP || ref_last < k) {
+            return 0.0f;
+        }
+        if (ref_last - k >= static_cast<int64_t>(TIMING_HISTORY_LOOPS)) {
+            return NO_GAP;
+        }
+        
+        // Gap when we crossed loop k...
+        double gap_ms = static_cast<double>(crossing_ms_[car][slot(k)]) -
+                        static_cast<double>(crossing_ms_[reference][slot(k)]);
+        
+        // ...but never less than how long the reference car has been past the
+        // loop we haven't reached yet
+        if (ref_last > k) {
+            const double waiting_ms = now_ms - static_cast<double>(crossing_ms_[reference][slot(k + 1)]);
+            gap_ms = std::max(gap_ms, waiting_ms);
+        }
+        
+        return static_cast<float>(std::max(gap_ms, 0.0) / 1000.0);
+    }
+
+private:
+    static size_t slot(int64_t loop) {
+        return static_cast<size_t>(loop) & (TIMING_HISTORY_LOOPS - 1);
+    }
+
+    std::array<std::array<uint32_t, TIMING_HISTORY_LOOPS>, NumCars> crossing_ms_{};
+    std::array<int64_t, NumCars> last_loop_{};
+};
+
+} // namespace f1sim
@@ -0,0 +1,407 @@
+#pragma once
+
+#include "track_model.h"
+#include "mapped_file.h"
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sys/stat.h>
+
+namespace f1sim {
+
+// ============================================================================
+// Track File Loading
+//
+// Custom circuits come from a centreline + speed-profile file:
+//
+//   CSV:    one point per line, "x,y,speed_kmh[,drs]" in meters and km/h.
+//           '#' starts a comment; an optional "sectors,S2,S3" line sets
+//           the lap distances where sectors 2 and 3 begin (default: thirds).
+//   Binary: TrackPointFileHeader followed by `count` TrackPoint records.
+//
+// The centreline is treated as a closed loop starting at the first point.
+// It is resampled into the same per-metre TrackSample table the engine uses
+// for compiled circuits, and the result is cached next to the source as
+// "<file>.cache". Later runs mmap the cache and skip parsing and resampling
+// entirely; the cache is rebuilt whenever the source's size or mtime change.
+// ============================================================================
+
+#pragma pack(push, 1)
+
+struct TrackPoint {
+    float x;             // meters
+    float y;             // meters
+    float speed_limit;   // km/h
+    uint32_t flags;      // SAMPLE_DRS
+};
+
+struct TrackPointFileHeader {
+    char magic[4];       // "F1PT"
+    uint32_t version;
+    uint32_t point_count;
+    float sector_starts[2];  // 0 = default thirds
+    uint8_t reserved[44];
+};
+
+/**
+ * @brief Header of a resampled track cache; segments and samples follow
+ */
+struct TrackCacheHeader {
+    char magic[4];            // "F1TC"
+    uint32_t version;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint32_t segment_count;
+    uint32_t sample_count;
+    float length;
+    float sector_starts[2];
+    uint32_t samples_offset;  // Byte offset of the sample table (8-aligned)
+    uint8_t reserved[16];
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(TrackPoint) == 16, "TrackPoint must be 16 bytes");
+static_assert(sizeof(TrackPointFileHeader) == 64, "TrackPointFileHeader must be 64 bytes");
+static_assert(sizeof(TrackCacheHeader) == 64, "TrackCacheHeader must be 64 bytes");
+
+constexpr uint32_t TRACK_POINT_FILE_VERSION = 1;
+constexpr uint32_t TRACK_CACHE_VERSION = 2;  // 2: speed limits include braking/traction ramps
+
+/**
+ * @brief A track loaded from a file, backed either by the mmap'd cache or by
+ *        freshly resampled tables
+ */
+class LoadedTrack {
+public:
+    /**
+     * @brief Load a track file, using (and refreshing) its resample cache
+     * @param error Set to a description when loading fails
+     * @return nullptr on failure
+     */
+    static std::unique_ptr<LoadedTrack> load(const std::string& path, std::string& error) {
+        auto track = std::unique_ptr<LoadedTrack>(new LoadedTrack());
+        track->name_ = base_name(path);
+        
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) {
+            error = "cannot stat " + path;
+            return nullptr;
+        }
+        const uint64_t source_size = static_cast<uint64_t>(st.st_size);
+        const int64_t source_mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+        
+        const std::string cache_path = path + ".cache";
+        if (track->map_cache(cache_path, source_size, source_mtime)) {
+            return track;
+        }
+        
+        std::vector<TrackPoint> points;
+        std::array<float, 2> sector_starts{};
+        if (!read_points(path, points, sector_starts, error)) {
+            return nullptr;
+        }
+        if (!track->resample(points, sector_starts, error)) {
+            return nullptr;
+        }
+        
+        // A failed cache write only costs the next launch a re-parse
+        track->write_cache(cache_path, source_size, source_mtime);
+        return track;
+    }
+
+    TrackView view() const {
+        return TrackView{name_, segments_, segment_count_, samples_, sample_count_,
+                         length_, sector_starts_, default_pit_lane(length_)};
+    }
+
+    bool from_cache() const { return mapping_.data() != nullptr; }
+
+private:
+    LoadedTrack() = default;
+
+    static std::string base_name(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        size_t dot = name.find('.');
+        return dot == std::string::npos ? name : name.substr(0, dot);
+    }
+
+    // ------------------------------------------------------------------------
+    // Cache
+    // ------------------------------------------------------------------------
+
+    bool map_cache(const std::string& cache_path, uint64_t source_size, int64_t source_mtime) {
+        if (!mapping_.open(cache_path)) return false;
+        
+        const uint8_t* base = mapping_.data();
+        if (mapping_.size() < sizeof(TrackCacheHeader)) return reject_cache();
+        
+        TrackCacheHeader header;
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, "F1TC", 4) != 0 || header.version != TRACK_CACHE_VERSION ||
+            header.source_size != source_size || header.source_mtime_ns != source_mtime ||
+            header.sample_count == 0) {
+            return reject_cache();
+        }
+        
+        size_t segments_end = sizeof(TrackCacheHeader) + size_t{header.segment_count} * sizeof(TrackSegment);
+        size_t samples_end = size_t{header.samples_offset} + size_t{header.sample_count} * sizeof(TrackSample);
+        if (header.samples_offset < segments_end || header.samples_offset % alignof(TrackSample) != 0 ||
+            samples_end > mapping_.size()) {
+            return reject_cache();
+        }
+        
+        segments_ = reinterpret_cast<const TrackSegment*>(base + sizeof(TrackCacheHeader));
+        segment_count_ = header.segment_count;
+        samples_ = reinterpret_cast<const TrackSample*>(base + header.samples_offset);
+        sample_count_ = header.sample_count;
+        length_ = header.length;
+        sector_starts_ = {header.sector_starts[0], header.sector_starts[1]};
+        return true;
+    }
+
+    bool reject_cache() {
+        mapping_.close();
+        return false;
+    }
+
+    void write_cache(const std::string& cache_path, uint64_t source_size, int64_t source_mtime) const {
+        TrackCacheHeader header{};
+        std::memcpy(header.magic, "F1TC", 4);
+        header.version = TRACK_CACHE_VERSION;
+        header.source_size = source_size;
+        header.source_mtime_ns = source_mtime;
+        header.segment_count = static_cast<uint32_t>(segment_count_);
+        header.sample_count = static_cast<uint32_t>(sample_count_);
+        header.length = length_;
+        header.sector_starts[0] = sector_starts_[0];
+        header.sector_starts[1] = sector_starts_[1];
+        
+        size_t segments_bytes = segment_count_ * sizeof(TrackSegment);
+        size_t samples_offset = sizeof(header) + segments_bytes;
+        samples_offset = (samples_offset + alignof(TrackSample) - 1) & ~(alignof(TrackSample) - 1);
+        header.samples_offset = static_cast<uint32_t>(samples_offset);
+        
+        // Write to a temp file and rename so a concurrent reader never sees
+        // a partial cache
+        std::string tmp_path = cache_path + ".tmp";
+        FILE* out = std::fopen(tmp_path.c_str(), "wb");
+        if (!out) return;
+        
+        static constexpr uint8_t zeros[alignof(TrackSample)] = {};
+        // Copied field by field into zeroed records so the structs' padding,
+        // never initialized, doesn't reach the file
+        std::vector<TrackSegment> records(segment_count_);
+        std::memset(static_cast<void*>(records.data()), 0, segments_bytes);
+        for (size_t i = 0; i < segment_count_; ++i) {
+            records[i].type = segments_[i].type;
+            records[i].length = segments_[i].length;
+            records[i].speed_limit = segments_[i].speed_limit;
+            records[i].drs_zone = segments_[i].drs_zone;
+        }
+        
+        bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+        ok = ok && std::fwrite(records.data(), 1, segments_bytes, out) == segments_bytes;
+        size_t pad = samples_offset - sizeof(header) - segments_bytes;
+        ok = ok && std::fwrite(zeros, 1, pad, out) == pad;
+        ok = ok && std::fwrite(samples_, sizeof(TrackSample), sample_count_, out) == sample_count_;
+        ok = (std::fclose(out) == 0) && ok;
+        
+        if (!ok || std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+            std::remove(tmp_path.c_str());
+        }
+    }
+
+    // ------------------------------------------------------------------------
+    // Source parsing
+    // ------------------------------------------------------------------------
+
+    static bool read_points(const std::string& path, std::vector<TrackPoint>& points,
+                            std::array<float, 2>& sector_starts, std::string& error) {
+        MappedFile source;
+        if (!source.open(path, MADV_SEQUENTIAL)) {
+            error = "cannot open " + path;
+            return false;
+        }
+        
+        const char* data = reinterpret_cast<const char*>(source.data());
+        if (source.size() >= sizeof(TrackPointFileHeader) && std::memcmp(data, "F1PT", 4) == 0) {
+            return read_binary_points(source, points, sector_starts, error);
+        }
+        return read_csv_points(std::string_view(data, source.size()), points, sector_starts, error);
+    }
+
+    static bool read_binary_points(const MappedFile& source, std::vector<TrackPoint>& points,
+                                   std::array<float, 2>& sector_starts, std::string& error) {
+        TrackPointFileHeader header;
+        std::memcpy(&header, source.data(), sizeof(header));
+        
+        size_t needed = sizeof(header) + size_t{header.point_count} * sizeof(TrackPoint);
+        if (header.version != TRACK_POINT_FILE_VERSION || source.size() < needed) {
+            error = "truncated or unsupported binary track file";
+            return false;
+        }
+        
+        points.resize(header.point_count);
+        std::memcpy(points.data(), source.data() + sizeof(header), points.size() * sizeof(TrackPoint));
+        sector_starts = {header.sector_starts[0], header.sector_starts[1]};
+        return true;
+    }
+
+    static bool read_csv_points(std::string_view text, std::vector<TrackPoint>& points,
+                                std::array<float, 2>& sector_starts, std::string& error) {
+        size_t line_number = 0;
+        
+        while (!text.empty()) {
+            size_t eol = text.find('\n');
+            std::string_view line = text.substr(0, eol);
+            text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+            line_number++;
+            
+            if (size_t hash = line.find('#'); hash != std::string_view::npos) {
+                line = line.substr(0, hash);
+            }
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+                line.remove_suffix(1);
+            }
+            if (line.empty()) continue;
+            
+            float values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            bool sectors_line = line.starts_with("sectors,");
+            if (sectors_line) {
+                line.remove_prefix(8);
+            }
+            
+            size_t count = 0;
+            const char* p = line.data();
+            const char* end = line.data() + line.size();
+            while (p < end && count < 4) {
+                while (p < end && *p == ' ') ++p;
+                auto [next, ec] = std::from_chars(p, end, values[count]);
+                if (ec != std::errc{}) break;
+                count++;
+                p = next;
+                while (p < end && *p == ' ') ++p;
+                if (p < end && *p == ',') ++p;
+            }
+            
+            if (sectors_line && count == 2) {
+                sector_starts = {values[0], values[1]};
+            } else if (!sectors_line && count >= 3) {
+                uint32_t flags = (count == 4 && values[3] != 0.0f) ? SAMPLE_DRS : 0;
+                points.push_back(TrackPoint{values[0], values[1], values[2], flags});
+            } else if (line_number > 1 || sectors_line) {
+                // The first line may be a column header
+                error = "bad track point on line " + std::to_string(line_number);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ------------------------------------------------------------------------
+    // Resampling
+    // ------------------------------------------------------------------------
+
+    /**
+     * @brief Resample the closed centreline to one sample per metre
+     *
+     * Speed limits are interpolated linearly along the arc length. Samples
+     * noticeably below the lap's top speed are flagged as corners; runs of
+     * samples with equal flags become the track's segments. The limits then
+     * get the same braking/traction ramps as the built-in circuits.
+     */
+    bool resample(const std::vector<TrackPoint>& points, std::array<float, 2> sector_starts,
+                  std::string& error) {
+        if (points.size() < 3) {
+            error = "track needs at least 3 points";
+            return false;
+        }
+        
+        // Cumulative arc length at each point, closing the loop back to point 0
+        const size_t n = points.size();
+        std::vector<float> arc(n + 1, 0.0f);
+        float top_speed = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            const TrackPoint& a = points[i];
+            const TrackPoint& b = points[(i + 1) % n];
+            arc[i + 1] = arc[i] + std::hypot(b.x - a.x, b.y - a.y);
+            top_speed = std::max(top_speed, a.speed_limit);
+        }
+        length_ = arc[n];
+        if (length_ < 1.0f) {
+            error = "track is shorter than one metre";
+            return false;
+        }
+        
+        if (sector_starts[0] <= 0.0f || sector_starts[1] <= sector_starts[0] || sector_starts[1] >= length_) {
+            sector_starts = {length_ / 3.0f, length_ * 2.0f / 3.0f};
+        }
+        sector_starts_ = sector_starts;
+        
+        owned_samples_.resize(track_sample_count(length_));
+        const float corner_speed = top_speed * 0.9f;
+        size_t point = 0;
+        
+        for (size_t i = 0; i < owned_samples_.size(); ++i) {
+            float distance = (static_cast<float>(i) + 0.5f) / TRACK_SAMPLES_PER_METER;
+            while (point + 1 < n && arc[point + 1] <= distance) {
+                point++;
+            }
+            
+            const TrackPoint& a = points[point];
+            const TrackPoint& b = points[(point + 1) % n];
+            float span = arc[point + 1] - arc[point];
+            float t = span > 0.0f ? std::clamp((distance - arc[point]) / span, 0.0f, 1.0f) : 0.0f;
+            
+            TrackSample& s = owned_samples_[i];
+            s.speed_limit = a.speed_limit + (b.speed_limit - a.speed_limit) * t;
+            s.sector = distance >= sector_starts[1] ? 2 : (distance >= sector_starts[0] ? 1 : 0);
+            s.flags = static_cast<uint8_t>(a.flags & SAMPLE_DRS);
+            if (s.speed_limit < corner_speed) s.flags |= SAMPLE_CORNER;
+            
+            // Start a new segment whenever the flags change
+            if (i == 0 || s.flags != owned_samples_[i - 1].flags) {
+                if (owned_segments_.size() > UINT16_MAX) {
+                    error = "track has more than " + std::to_string(UINT16_MAX + 1) + " segments";
+                    return false;
+                }
+                owned_segments_.push_back(TrackSegment{
+                    (s.flags & SAMPLE_CORNER) ? SegmentType::Corner : SegmentType::Straight,
+                    0.0f, s.speed_limit, (s.flags & SAMPLE_DRS) != 0});
+            }
+            TrackSegment& segment = owned_segments_.back();
+            segment.length += 1.0f / TRACK_SAMPLES_PER_METER;
+            segment.speed_limit = std::min(segment.speed_limit, s.speed_limit);
+            s.segment = static_cast<uint16_t>(owned_segments_.size() - 1);
+        }
+        
+        apply_speed_ramps(owned_samples_.data(), owned_samples_.size());
+        
+        segments_ = owned_segments_.data();
+        segment_count_ = owned_segments_.size();
+        samples_ = owned_samples_.data();
+        sample_count_ = owned_samples_.size();
+        return true;
+    }
+
+    std::string name_;
+    MappedFile mapping_;                        // Set when served from the cache
+    std::vector<TrackSegment> owned_segments_;  // Set when freshly resampled
+    std::vector<TrackSample> owned_samples_;
+    
+    const TrackSegment* segments_ = nullptr;
+    size_t segment_count_ = 0;
+    const TrackSample* samples_ = nullptr;
+    size_t sample_count_ = 0;
+    float length_ = 0.0f;
+    std::array<float, 2> sector_starts_{};
+};
+
+} // namespace f1sim
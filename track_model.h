@@ -1,16 +1,313 @@
 #pragma once
 
-// TODO: Implement track model with:
-// - Segment-based track definition (straights, corners)
-// - Speed multipliers per segment
-// - DRS zones
-// - Sector boundaries
-// - Pit lane entry/exit
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// TODO: Extend track model with:
 // - Elevation changes
 
 namespace f1sim {
 
-// Placeholder for future track modeling
-// For now, track is just a simple loop (implement later!)
+// ============================================================================
+// Track Definition
+// ============================================================================
+
+enum class SegmentType : uint8_t {
+    Straight,
+    Corner
+};
+
+/**
+ * @brief One piece of the lap, laid end to end from the start/finish line
+ */
+struct TrackSegment {
+    SegmentType type;
+    float length;        // meters
+    float speed_limit;   // km/h, fastest a car can take this segment
+    bool drs_zone;       // DRS may be opened along this segment
+};
+
+/**
+ * @brief Pit lane geometry, in lap distances along the racing line
+ *
+ * The lane runs alongside the track, so a metre of lane is a metre of race
+ * distance: a car entering at `entry` rejoins at `entry + length` (wrapping
+ * past the line if the lane straddles it).
+ */
+struct PitLaneSpec {
+    float entry = 0.0f;        // Lap distance where cars turn in
+    float length = 0.0f;       // Entry to exit, meters
+    float box_offset = 0.0f;   // First garage, meters after the entry
+    float speed_limit = 0.0f;  // km/h
+
+    constexpr float exit(float track_length) const {
+        float e = entry + length;
+        return e >= track_length ? e - track_length : e;
+    }
+};
+
+constexpr float PIT_LANE_SPEED_LIMIT_KMH = 80.0f;
+
+/**
+ * @brief Generic lane for tracks that don't describe one: 600 m straddling
+ *        the start/finish line
+ */
+constexpr PitLaneSpec default_pit_lane(float track_length) {
+    float length = std::min(600.0f, track_length * 0.5f);
+    return PitLaneSpec{track_length - length * 0.5f, length, length * 0.25f, PIT_LANE_SPEED_LIMIT_KMH};
+}
+
+// ============================================================================
+// Distance Lookup Table
+// ============================================================================
+
+// TrackSample flags
+constexpr uint8_t SAMPLE_CORNER = 0x01;
+constexpr uint8_t SAMPLE_DRS    = 0x02;
+
+/**
+ * @brief Everything the physics loop needs to know about one metre of track
+ *
+ * 8 bytes, so a cache line covers 8 m of track.
+ */
+struct TrackSample {
+    float speed_limit;   // km/h, including braking/traction ramps around corners
+    uint16_t segment;    // Index into the segment list
+    uint8_t sector;      // 0-2
+    uint8_t flags;       // SAMPLE_CORNER | SAMPLE_DRS
+};
+
+static_assert(sizeof(TrackSample) == 8, "TrackSample must stay 8 bytes");
+
+constexpr size_t TRACK_SAMPLES_PER_METER = 1;
+constexpr float TRACK_BRAKING_DECEL = 40.0f;   // m/s² (~4g) when building the speed profile
+constexpr float TRACK_TRACTION_ACCEL = 12.0f;  // m/s² (~1.2g) out of corners
+
+namespace track_detail {
+
+// std::sqrt is not constexpr until C++26
+constexpr float sqrt(float x) {
+    if (x <= 0.0f) return 0.0f;
+    float r = x > 1.0f ? x : 1.0f;
+    for (int i = 0; i < 32; ++i) {
+        float next = 0.5f * (r + x / r);
+        if (next == r) break;
+        r = next;
+    }
+    return r;
+}
+
+// Fastest speed (km/h) at one end of a `meters` stretch that can still reach
+// `target_kmh` at the other end under `accel`
+constexpr float ramp_limit(float target_kmh, float accel, float meters) {
+    float v = target_kmh / 3.6f;
+    return sqrt(v * v + 2.0f * accel * meters) * 3.6f;
+}
+
+} // namespace track_detail
+
+constexpr float track_length(const TrackSegment* segments, size_t count) {
+    float length = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        length += segments[i].length;
+    }
+    return length;
+}
+
+constexpr size_t track_sample_count(float length) {
+    auto count = static_cast<size_t>(length * TRACK_SAMPLES_PER_METER);
+    if (static_cast<float>(count) < length * TRACK_SAMPLES_PER_METER) count++;  // ceil
+    return std::max<size_t>(count, 1);
+}
+
+/**
+ * @brief Smooth per-metre speed limits into a driveable profile
+ *
+ * A backward pass adds braking zones ahead of corners and a forward pass adds
+ * traction-limited exits. Both passes run twice around the lap so corners near
+ * the line shape the end of the previous lap.
+ */
+constexpr void apply_speed_ramps(TrackSample* samples, size_t sample_count) {
+    constexpr float step = 1.0f / TRACK_SAMPLES_PER_METER;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = sample_count; i-- > 0;) {
+            const float next = samples[(i + 1) % sample_count].speed_limit;
+            samples[i].speed_limit = std::min(samples[i].speed_limit,
+                                              track_detail::ramp_limit(next, TRACK_BRAKING_DECEL, step));
+        }
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (size_t i = 0; i < sample_count; ++i) {
+            const float prev = samples[(i + sample_count - 1) % sample_count].speed_limit;
+            samples[i].speed_limit = std::min(samples[i].speed_limit,
+                                              track_detail::ramp_limit(prev, TRACK_TRACTION_ACCEL, step));
+        }
+    }
+}
+
+/**
+ * @brief Resolve a segment list into per-metre samples
+ *
+ * Each sample takes the segment, sector and flags at the midpoint of the
+ * metre it covers; the speed limits then get apply_speed_ramps().
+ *
+ * constexpr: the same routine fills compile-time circuit tables and
+ * runtime-built tracks.
+ */
+constexpr void fill_track_samples(const TrackSegment* segments, size_t segment_count,
+                                  std::array<float, 2> sector_starts,
+                                  TrackSample* out, size_t sample_count) {
+    size_t segment = 0;
+    float segment_end = segment_count ? segments[0].length : 0.0f;
+    
+    for (size_t i = 0; i < sample_count; ++i) {
+        float distance = (static_cast<float>(i) + 0.5f) / TRACK_SAMPLES_PER_METER;
+        while (segment + 1 < segment_count && distance >= segment_end) {
+            segment++;
+            segment_end += segments[segment].length;
+        }
+        
+        TrackSample& s = out[i];
+        s.segment = static_cast<uint16_t>(segment);
+        s.sector = distance >= sector_starts[1] ? 2 : (distance >= sector_starts[0] ? 1 : 0);
+        s.flags = 0;
+        s.speed_limit = 0.0f;
+        
+        if (segment_count) {
+            const TrackSegment& seg = segments[segment];
+            s.speed_limit = seg.speed_limit;
+            if (seg.type == SegmentType::Corner) s.flags |= SAMPLE_CORNER;
+            if (seg.drs_zone) s.flags |= SAMPLE_DRS;
+        }
+    }
+    
+    apply_speed_ramps(out, sample_count);
+}
+
+// ============================================================================
+// Track View - what the engine samples
+// ============================================================================
+
+/**
+ * @brief Non-owning view of a resolved track
+ *
+ * Compile-time circuits, runtime-built tracks and tracks loaded from files
+ * all hand the engine one of these, so the hot path is identical: one indexed
+ * load per lookup. The storage it points to must outlive the view.
+ */
+struct TrackView {
+    std::string_view name;
+    const TrackSegment* segments = nullptr;
+    size_t segment_count = 0;
+    const TrackSample* samples = nullptr;
+    size_t sample_count = 0;
+    float length = 0.0f;
+    std::array<float, 2> sector_starts{};
+    PitLaneSpec pit_lane{};
+
+    /**
+     * @brief Resolve a lap distance (meters from the line) to its sample
+     *
+     * Distances outside [0, length) clamp to the first/last metre, which
+     * covers cars still behind the line on the starting grid.
+     */
+    const TrackSample& sample(float lap_distance) const {
+        auto idx = static_cast<int32_t>(lap_distance * TRACK_SAMPLES_PER_METER);
+        idx = std::clamp(idx, int32_t{0}, static_cast<int32_t>(sample_count) - 1);
+        return samples[static_cast<size_t>(idx)];
+    }
+};
+
+// ============================================================================
+// Compile-time circuits
+// ============================================================================
+
+/**
+ * @brief Segment list + sector boundaries for a circuit known at compile time
+ */
+template <size_t SegmentCount>
+struct CircuitLayout {
+    std::string_view name;
+    std::array<TrackSegment, SegmentCount> segments;
+    std::array<float, 2> sector_starts;  // Lap distances where sectors 2 and 3 begin
+    PitLaneSpec pit_lane;
+
+    constexpr float length() const { return track_length(segments.data(), SegmentCount); }
+};
+
+/**
+ * @brief Lookup table for a CircuitLayout, built entirely by the compiler
+ *
+ * The samples live in read-only data, so selecting a compiled circuit is just
+ * taking its view().
+ */
+template <const auto& Layout>
+struct CompiledTrack {
+    static constexpr size_t SAMPLE_COUNT = track_sample_count(Layout.length());
+
+    static constexpr std::array<TrackSample, SAMPLE_COUNT> samples = [] {
+        std::array<TrackSample, SAMPLE_COUNT> out{};
+        fill_track_samples(Layout.segments.data(), Layout.segments.size(),
+                           Layout.sector_starts, out.data(), out.size());
+        return out;
+    }();
+
+    static constexpr TrackView view() {
+        return TrackView{Layout.name, Layout.segments.data(), Layout.segments.size(),
+                         samples.data(), samples.size(), Layout.length(), Layout.sector_starts,
+                         Layout.pit_lane};
+    }
+};
+
+// ============================================================================
+// Runtime-built tracks
+// ============================================================================
+
+/**
+ * @brief Owning track for layouts only known at runtime (e.g. loaded from a
+ *        file); hands out the same TrackView as compiled circuits
+ */
+class TrackModel {
+public:
+    /**
+     * @param segments         Lap layout starting at the start/finish line
+     * @param sector_starts    Lap distances where sectors 2 and 3 begin
+     * @param pit_lane         Lane geometry; default_pit_lane() if left empty
+     */
+    TrackModel(std::string name, std::vector<TrackSegment> segments, std::array<float, 2> sector_starts,
+               PitLaneSpec pit_lane = {})
+        : name_(std::move(name))
+        , segments_(std::move(segments))
+        , sector_starts_(sector_starts)
+        , length_(track_length(segments_.data(), segments_.size()))
+        , pit_lane_(pit_lane.length > 0.0f ? pit_lane : default_pit_lane(length_))
+    {
+        samples_.resize(track_sample_count(length_));
+        fill_track_samples(segments_.data(), segments_.size(), sector_starts_,
+                           samples_.data(), samples_.size());
+    }
+
+    // Views point into this object
+    TrackModel(const TrackModel&) = delete;
+    TrackModel& operator=(const TrackModel&) = delete;
+
+    TrackView view() const {
+        return TrackView{name_, segments_.data(), segments_.size(),
+                         samples_.data(), samples_.size(), length_, sector_starts_, pit_lane_};
+    }
+
+private:
+    std::string name_;
+    std::vector<TrackSegment> segments_;
+    std::array<float, 2> sector_starts_;
+    float length_;
+    PitLaneSpec pit_lane_;
+    std::vector<TrackSample> samples_;
+};
 
 } // namespace f1sim